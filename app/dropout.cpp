@@ -0,0 +1,124 @@
+/********************************************************************
+**                                                                 **
+** File   : app/dropout.cpp                                        **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "Features.h"
+#include "GroundTruth.h"
+#include "GroupDetectorFactory.h"
+#include "RotationDropoutStudy.h"
+#include "Settings.h"
+#include <boost/program_options.hpp>
+#include <boost/tokenizer.hpp>
+#include <iostream>
+#include <string>
+
+using fformation::Settings;
+using fformation::Features;
+using fformation::GroundTruth;
+using fformation::GroupDetector;
+using fformation::GroupDetectorFactory;
+using fformation::RotationDropout;
+using fformation::RotationDropoutStudy;
+using fformation::Option;
+using fformation::Options;
+
+static std::vector<double> parseProportions(const std::string &list) {
+  std::vector<double> result;
+  boost::char_separator<char> separator(",");
+  boost::tokenizer<boost::char_separator<char>> tokens(list, separator);
+  for (auto token : tokens) {
+    result.push_back(Option("proportion", token).convertValue<double>());
+  }
+  return result;
+}
+
+int main(const int argc, const char **args) {
+  boost::program_options::variables_map program_options;
+  boost::program_options::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message");
+  desc.add_options()(
+      "classificator,c",
+      boost::program_options::value<std::string>()->default_value("grow"),
+      "The classificator configuration to evaluate.");
+  desc.add_options()(
+      "mode,m",
+      boost::program_options::value<std::string>()->default_value("random"),
+      "How rotations are removed. Possible: ( random | group )");
+  desc.add_options()(
+      "proportions,p",
+      boost::program_options::value<std::string>()->default_value(
+          "0,0.25,0.5,0.75"),
+      "Comma separated list of the proportions of persons that keep their "
+      "rotation, between 0 and 1.");
+  desc.add_options()(
+      "seeds,n", boost::program_options::value<size_t>()->default_value(30),
+      "The number of random runs per proportion.");
+  desc.add_options()(
+      "first-seed", boost::program_options::value<size_t>()->default_value(0),
+      "The seed of the first run.");
+  desc.add_options()(
+      "threshold,t",
+      boost::program_options::value<double>()->default_value(2. / 3.),
+      "The group intersection threshold of a true positive.");
+  desc.add_options()(
+      "threads,j", boost::program_options::value<size_t>()->default_value(0),
+      "The number of worker threads. 0 uses all available cores.");
+  desc.add_options()(
+      "dataset,d", boost::program_options::value<std::string>()->required(),
+      "The root path of the evaluation dataset. The path is expected "
+      "to contain features.json, groundtruth.json and settings.json");
+  try {
+    boost::program_options::store(
+        boost::program_options::parse_command_line(argc, args, desc),
+        program_options);
+    if (program_options.count("help")) {
+      std::cout << desc << "\n";
+      return 0;
+    }
+    boost::program_options::notify(program_options);
+  } catch (const std::exception &e) {
+    std::cerr << "Error while parsing command line parameters:\n\t" << e.what()
+              << "\n";
+    std::cerr << desc << std::endl;
+    return 1;
+  }
+
+  std::string path = program_options["dataset"].as<std::string>();
+  Settings settings = Settings::readMatlabJson(path + "/settings.json");
+
+  auto config = GroupDetectorFactory::parseConfig(
+      program_options["classificator"].as<std::string>());
+  config.second.insert(Option("stride", settings.stride()));
+  config.second.insert(Option("mdl", settings.mdl()));
+  GroupDetector::Ptr detector =
+      GroupDetectorFactory::getDefaultInstance().create(config);
+
+  Features features = Features::readMatlabJson(path + "/features.json");
+  GroundTruth groundtruth =
+      GroundTruth::readMatlabJson(path + "/groundtruth.json");
+
+  RotationDropoutStudy study(
+      features, groundtruth,
+      RotationDropout::parseMode(program_options["mode"].as<std::string>()),
+      program_options["threshold"].as<double>());
+  auto results = study.run(
+      *detector,
+      parseProportions(program_options["proportions"].as<std::string>()),
+      program_options["seeds"].as<size_t>(),
+      program_options["first-seed"].as<size_t>(),
+      program_options["threads"].as<size_t>());
+  RotationDropoutStudy::printTable(std::cout, results);
+}
@@ -15,16 +15,25 @@
 **                                                                 **
 ********************************************************************/
 
+#include "BufferedWriter.h"
 #include "Evaluation.h"
 #include "Features.h"
 #include "GroundTruth.h"
 #include "GroupDetectorFactory.h"
+#include "JsonLinesEvaluation.h"
+#include "ResultLog.h"
+#include "SceneGenerator.h"
 #include "Settings.h"
+#include "Trace.h"
 #include <boost/program_options.hpp>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <unistd.h>
 
 using fformation::Settings;
 using fformation::Features;
@@ -39,9 +48,19 @@ using fformation::GroupDetectorFactory;
 using fformation::ConfusionMatrix;
 using fformation::Option;
 using fformation::Options;
+using fformation::Trace;
+using fformation::JsonLinesEvaluation;
+using fformation::BufferedWriter;
+using fformation::ResultLog;
+using fformation::SceneGenerator;
 
 auto &factory = GroupDetectorFactory::getDefaultInstance();
 
+static double secondsSince(const std::chrono::steady_clock::time_point &start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
 static std::string getClassificators(std::string prefix) {
   std::stringstream str;
   str << prefix;
@@ -71,9 +90,24 @@ int main(const int argc, const char **args) {
       "May be used to override evaluation settings and default settings "
       "from settings.json");
   desc.add_options()(
-      "dataset,d", boost::program_options::value<std::string>()->required(),
+      "dataset,d", boost::program_options::value<std::string>(),
       "The root path of the evaluation dataset. The path is expected "
-      "to contain features.json, groundtruth.json and settings.json");
+      "to contain features.json, groundtruth.json and settings.json or a "
+      "binary scene.bin written by fformation-generate");
+  desc.add_options()(
+      "jsonl,l", boost::program_options::value<std::string>(),
+      "Read frames as json lines from this file ('-' = stdin) and write a "
+      "result line per frame. The dataset is optional then and only its "
+      "settings.json is used.");
+  desc.add_options()(
+      "replay,r", boost::program_options::value<std::string>(),
+      "Print the results of a log written with '-e result_log=<file>' "
+      "instead of running a classificator. Frames are re-scored when the "
+      "thresholds differ from the logged ones.");
+  desc.add_options()(
+      "trace,t", boost::program_options::value<std::string>(),
+      "Record a runtime trace and write it as Chrome trace event json to "
+      "this file.");
   try {
     boost::program_options::store(
         boost::program_options::parse_command_line(argc, args, desc),
@@ -91,11 +125,69 @@ int main(const int argc, const char **args) {
     return 0;
   }
 
+  if (program_options.count("jsonl")) {
+    auto config = GroupDetectorFactory::parseConfig(
+        program_options["classificator"].as<std::string>());
+    if (program_options.count("dataset")) {
+      Settings settings = Settings::readMatlabJson(
+          program_options["dataset"].as<std::string>() + "/settings.json");
+      config.second.insert(Option("stride", settings.stride()));
+      config.second.insert(Option("mdl", settings.mdl()));
+    }
+    auto detector = factory.create(config.first, config.second);
+    JsonLinesEvaluation evaluation(
+        *detector, Options::parseFromString(
+                       program_options["evaluation"].as<std::string>()));
+    std::string input = program_options["jsonl"].as<std::string>();
+    if (input == "-") {
+      evaluation.run(std::cin, std::cout);
+    } else {
+      std::ifstream stream(input);
+      if (!stream.is_open()) {
+        std::cerr << "Cannot open " << input << std::endl;
+        return 1;
+      }
+      evaluation.run(stream, std::cout);
+    }
+    evaluation.writeSummary(std::cout);
+    return 0;
+  }
+
+  if (program_options.count("replay")) {
+    ResultLog::Reader log(program_options["replay"].as<std::string>());
+    Evaluation evaluation(
+        log, Options::parseFromString(
+                 program_options["evaluation"].as<std::string>()));
+    BufferedWriter out(STDOUT_FILENO);
+    evaluation.printOutput(out);
+    return 0;
+  }
+
+  if (!program_options.count("dataset")) {
+    std::cerr << "Error while parsing command line parameters:\n\t"
+              << "the option '--dataset' is required but missing\n";
+    std::cerr << desc << std::endl;
+    return 1;
+  }
+
   std::string path = program_options["dataset"].as<std::string>();
   std::string features_path = path + "/features.json";
   std::string groundtruth_path = path + "/groundtruth.json";
   std::string settings_path = path + "/settings.json";
-  Settings settings = Settings::readMatlabJson(settings_path);
+  std::string scene_path = path + "/scene.bin";
+  // a binary scene written by fformation-generate replaces the json files
+  bool binary = std::ifstream(scene_path).good();
+  std::unique_ptr<SceneGenerator::Scene> scene;
+  auto start = std::chrono::steady_clock::now();
+  if (binary) {
+    scene.reset(
+        new SceneGenerator::Scene(SceneGenerator::readBinary(scene_path)));
+  }
+  double scene_seconds = secondsSince(start);
+  start = std::chrono::steady_clock::now();
+  Settings settings =
+      binary ? scene->settings : Settings::readMatlabJson(settings_path);
+  double settings_seconds = secondsSince(start);
 
   auto config = GroupDetectorFactory::parseConfig(
       program_options["classificator"].as<std::string>());
@@ -104,11 +196,53 @@ int main(const int argc, const char **args) {
 
   GroupDetector::Ptr detector = factory.create(config.first, config.second);
 
-  Features features = Features::readMatlabJson(features_path);
-  GroundTruth groundtruth = GroundTruth::readMatlabJson(groundtruth_path);
+  start = std::chrono::steady_clock::now();
+  Features features =
+      binary ? std::move(scene->features)
+             : Features::readMatlabJson(features_path);
+  double features_seconds = secondsSince(start);
+  start = std::chrono::steady_clock::now();
+  GroundTruth groundtruth =
+      binary ? std::move(scene->ground_truth)
+             : GroundTruth::readMatlabJson(groundtruth_path);
+  double groundtruth_seconds = secondsSince(start);
+  scene.reset();
+  auto addLoadStages = [&](Evaluation &evaluation) {
+    if (binary) {
+      evaluation.addStage("load_scene", scene_seconds,
+                          features.observations().size());
+      return;
+    }
+    evaluation.addStage("load_settings", settings_seconds);
+    evaluation.addStage("load_features", features_seconds,
+                        features.observations().size());
+    evaluation.addStage("load_groundtruth", groundtruth_seconds,
+                        groundtruth.classifications().size());
+  };
 
-  Evaluation evaluation(features, groundtruth, settings, *detector.get(),
-                        Options::parseFromString(
-                            program_options["evaluation"].as<std::string>()));
-  evaluation.printOutput(std::cout);
+  if (program_options.count("trace")) {
+    Trace::enable();
+  }
+
+  Options evaluation_options =
+      Options::parseFromString(program_options["evaluation"].as<std::string>());
+  BufferedWriter out(STDOUT_FILENO);
+  if (Evaluation::Parameters::parse(evaluation_options).streaming) {
+    Evaluation evaluation(features, groundtruth, settings, *detector.get(),
+                          evaluation_options, out);
+    addLoadStages(evaluation);
+    evaluation.printOutput(out);
+  } else {
+    Evaluation evaluation(features, groundtruth, settings, *detector.get(),
+                          evaluation_options);
+    addLoadStages(evaluation);
+    evaluation.printOutput(out);
+  }
+  out.flush();
+
+  if (program_options.count("trace")) {
+    Trace::disable();
+    std::ofstream trace(program_options["trace"].as<std::string>());
+    Trace::writeChromeJson(trace);
+  }
 }
@@ -0,0 +1,68 @@
+/********************************************************************
+**                                                                 **
+** File   : app/generate.cpp                                       **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "SceneGenerator.h"
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <string>
+
+using fformation::Options;
+using fformation::SceneGenerator;
+
+int main(const int argc, const char **args) {
+  boost::program_options::variables_map program_options;
+  boost::program_options::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message");
+  desc.add_options()(
+      "scene,s", boost::program_options::value<std::string>()->default_value(""),
+      "The scene parameters as options string. Possible: persons, frames, "
+      "group_size_weights, stride, mdl, spacing, position_noise, "
+      "orientation_noise, missing_rotation, speed, frame_duration, seed. "
+      "Example: 'persons=1000@frames=100@speed=0.5'");
+  desc.add_options()(
+      "output,o", boost::program_options::value<std::string>()->required(),
+      "The existing directory to write features.json, groundtruth.json and "
+      "settings.json to.");
+  desc.add_options()("binary,b",
+                     "Write the scene as scene.bin instead of the json files. "
+                     "fformation-evaluation reads it when the dataset "
+                     "directory contains a scene.bin.");
+  try {
+    boost::program_options::store(
+        boost::program_options::parse_command_line(argc, args, desc),
+        program_options);
+    if (program_options.count("help")) {
+      std::cout << desc << "\n";
+      return 0;
+    }
+    boost::program_options::notify(program_options);
+  } catch (const std::exception &e) {
+    std::cerr << "Error while parsing command line parameters:\n\t" << e.what()
+              << "\n";
+    std::cerr << desc << std::endl;
+    return 1;
+  }
+
+  auto parameters = SceneGenerator::Parameters::fromOptions(
+      Options::parseFromString(program_options["scene"].as<std::string>()));
+  SceneGenerator generator(parameters);
+  if (program_options.count("binary")) {
+    generator.writeBinary(program_options["output"].as<std::string>());
+  } else {
+    generator.writeMatlabJson(program_options["output"].as<std::string>());
+  }
+}
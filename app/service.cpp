@@ -0,0 +1,295 @@
+/********************************************************************
+**                                                                 **
+** File   : app/service.cpp                                        **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "DetectionService.h"
+#include "Features.h"
+#include "GroupDetectorFactory.h"
+#include "Settings.h"
+#include <boost/program_options.hpp>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using fformation::DetectionService;
+using fformation::Features;
+using fformation::GroupDetectorFactory;
+using fformation::Settings;
+using fformation::Classification;
+using fformation::Observation;
+using fformation::Option;
+using fformation::Json;
+using fformation::Exception;
+
+/**
+ * A client of the service. Replies of concurrently detected requests may be
+ * written from several worker threads. The file descriptor is closed when the
+ * last pending reply was written.
+ */
+class Connection {
+public:
+  Connection(int in, int out, bool close) : _in(in), _out(out), _close(close) {}
+
+  ~Connection() {
+    if (_close) {
+      ::close(_in);
+    }
+  }
+
+  int in() const { return _in; }
+
+  void reply(const std::string &line) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const char *data = line.data();
+    size_t size = line.size();
+    while (size > 0) {
+      ssize_t written = ::write(_out, data, size);
+      if (written < 0 && errno == EINTR) {
+        continue;
+      } else if (written <= 0) {
+        return; // the client is gone
+      }
+      data += written;
+      size -= size_t(written);
+    }
+  }
+
+private:
+  int _in;
+  int _out;
+  bool _close;
+  std::mutex _mutex;
+};
+
+static std::string metricsLine(const DetectionService::Metrics &metrics) {
+  std::stringstream str;
+  str << "{ \"requests\": " << metrics.requests
+      << ", \"failures\": " << metrics.failures
+      << ", \"batches\": " << metrics.batches
+      << ", \"pending\": " << metrics.pending;
+  if (metrics.requests > 0) {
+    str << ", \"latency_mean\": " << metrics.latency.mean()
+        << ", \"latency_max\": " << metrics.latency.max()
+        << ", \"latency_p50\": " << metrics.latency_quantiles.quantile(0.5)
+        << ", \"latency_p99\": " << metrics.latency_quantiles.quantile(0.99)
+        << ", \"queue_wait_mean\": " << metrics.queue_wait.mean();
+  }
+  str << " }\n";
+  return str.str();
+}
+
+static std::string errorLine(const Json &id, const std::string &error) {
+  Json result;
+  if (!id.is_null()) {
+    result["id"] = id;
+  }
+  result["error"] = error;
+  return result.dump() + "\n";
+}
+
+/**
+ * Handles a single request line. Observations are answered asynchronously by
+ * the service, everything else immediately.
+ */
+static void handleLine(const std::string &line, DetectionService &service,
+                       const std::shared_ptr<Connection> &connection) {
+  Json request;
+  try {
+    request = Json::parse(line);
+  } catch (const std::exception &e) {
+    connection->reply(errorLine(Json(), "Cannot parse request."));
+    return;
+  }
+  Json id;
+  if (request.is_object() && request.count("id")) {
+    id = request["id"];
+  }
+  if (request.is_object() && request.count("command")) {
+    if (request["command"] == "metrics") {
+      connection->reply(metricsLine(service.metrics()));
+    } else {
+      connection->reply(errorLine(id, "Unknown command."));
+    }
+    return;
+  }
+  Observation observation;
+  try {
+    observation = Features::readObservationJson(request);
+  } catch (const std::exception &e) {
+    connection->reply(errorLine(id, e.what()));
+    return;
+  }
+  std::string prefix =
+      id.is_null() ? std::string("{ ") : "{ \"id\": " + id.dump() + ", ";
+  service.submit(observation, [connection, id, prefix](
+                                  const Classification &classification,
+                                  std::exception_ptr error, double latency) {
+    if (error) {
+      try {
+        std::rethrow_exception(error);
+      } catch (const std::exception &e) {
+        connection->reply(errorLine(id, e.what()));
+      }
+      return;
+    }
+    std::stringstream str;
+    str << prefix << "\"classification\": " << classification
+        << ", \"latency\": " << latency << " }\n";
+    connection->reply(str.str());
+  });
+}
+
+/**
+ * Reads request lines until the end of the input. The read buffer is reused
+ * for all lines.
+ */
+static void serve(DetectionService &service,
+                  const std::shared_ptr<Connection> &connection) {
+  std::vector<char> buffer(1 << 16);
+  std::string line;
+  while (true) {
+    ssize_t count = ::read(connection->in(), buffer.data(), buffer.size());
+    if (count < 0 && errno == EINTR) {
+      continue;
+    } else if (count <= 0) {
+      break;
+    }
+    const char *begin = buffer.data();
+    const char *end = begin + count;
+    for (const char *it = begin; it != end; ++it) {
+      if (*it == '\n') {
+        line.append(begin, it);
+        if (!line.empty()) {
+          handleLine(line, service, connection);
+        }
+        line.clear();
+        begin = it + 1;
+      }
+    }
+    line.append(begin, end);
+  }
+  if (!line.empty()) {
+    handleLine(line, service, connection);
+  }
+}
+
+static int listenOn(const std::string &path) {
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  Exception::check(path.size() < sizeof(address.sun_path),
+                   "Socket path too long: " + path);
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  Exception::check(fd >= 0, "Cannot create socket.");
+  ::unlink(path.c_str());
+  Exception::check(::bind(fd, (sockaddr *)&address, sizeof(address)) == 0,
+                   "Cannot bind socket " + path + ": " + std::strerror(errno));
+  Exception::check(::listen(fd, 64) == 0,
+                   "Cannot listen on socket " + path + ".");
+  return fd;
+}
+
+int main(const int argc, const char **args) {
+  boost::program_options::variables_map program_options;
+  boost::program_options::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message");
+  desc.add_options()(
+      "classificator,c",
+      boost::program_options::value<std::string>()->default_value("grow"),
+      "The classificator configuration. mdl and stride are required unless "
+      "they are read from the settings.");
+  desc.add_options()(
+      "settings,s", boost::program_options::value<std::string>(),
+      "A settings.json providing mdl and stride of the classificator.");
+  desc.add_options()(
+      "socket,u", boost::program_options::value<std::string>(),
+      "Listen on this unix domain socket instead of reading stdin.");
+  desc.add_options()(
+      "threads,j", boost::program_options::value<size_t>()->default_value(0),
+      "The number of detection threads. 0 uses all available cores.");
+  desc.add_options()(
+      "batch,b", boost::program_options::value<size_t>()->default_value(64),
+      "The maximal number of requests a detection thread takes at once.");
+  desc.add_options()("metrics,m",
+                     "Print the latency metrics to stderr on exit.");
+  try {
+    boost::program_options::store(
+        boost::program_options::parse_command_line(argc, args, desc),
+        program_options);
+    if (program_options.count("help")) {
+      std::cout << desc << "\n";
+      return 0;
+    }
+    boost::program_options::notify(program_options);
+  } catch (const std::exception &e) {
+    std::cerr << "Error while parsing command line parameters:\n\t" << e.what()
+              << "\n";
+    std::cerr << desc << std::endl;
+    return 1;
+  }
+
+  auto config = GroupDetectorFactory::parseConfig(
+      program_options["classificator"].as<std::string>());
+  if (program_options.count("settings")) {
+    Settings settings = Settings::readMatlabJson(
+        program_options["settings"].as<std::string>());
+    config.second.insert(Option("stride", settings.stride()));
+    config.second.insert(Option("mdl", settings.mdl()));
+  }
+
+  DetectionService service(
+      GroupDetectorFactory::getDefaultInstance().createPool(config.first,
+                                                            config.second),
+      program_options["threads"].as<size_t>(),
+      program_options["batch"].as<size_t>());
+
+  if (program_options.count("socket")) {
+    // clients that disconnect must not terminate the service
+    std::signal(SIGPIPE, SIG_IGN);
+    int server = listenOn(program_options["socket"].as<std::string>());
+    while (true) {
+      int client = ::accept(server, nullptr, nullptr);
+      if (client < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        break;
+      }
+      auto connection = std::make_shared<Connection>(client, client, true);
+      std::thread([&service, connection]() { serve(service, connection); })
+          .detach();
+    }
+    ::close(server);
+  } else {
+    serve(service, std::make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO,
+                                                false));
+  }
+
+  service.wait();
+  if (program_options.count("metrics")) {
+    std::cerr << metricsLine(service.metrics());
+  }
+}
@@ -0,0 +1,129 @@
+/********************************************************************
+**                                                                 **
+** File   : app/sweep.cpp                                          **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "Features.h"
+#include "GroundTruth.h"
+#include "GroupDetectorFactory.h"
+#include "ParameterSweep.h"
+#include "Settings.h"
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <string>
+
+using fformation::Settings;
+using fformation::Features;
+using fformation::GroundTruth;
+using fformation::GroupDetectorFactory;
+using fformation::ParameterSweep;
+using fformation::Option;
+using fformation::Options;
+
+int main(const int argc, const char **args) {
+  boost::program_options::variables_map program_options;
+  boost::program_options::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message");
+  desc.add_options()(
+      "classificator,c",
+      boost::program_options::value<std::string>()->default_value("grow"),
+      "The classificator configuration all sweep values are applied to.");
+  desc.add_options()(
+      "sweep,s", boost::program_options::value<std::string>()->required(),
+      "The classificator options to sweep. Values are comma separated lists "
+      "or inclusive ranges start:step:stop. Example: "
+      "'mdl=1:1:20@stride=0.5,0.7'");
+  desc.add_options()(
+      "evaluation,e",
+      boost::program_options::value<std::string>()->default_value(
+          "threshold=0.6666@modify_rotations=keep@modify_proportion=0.75@seed="
+          "0"),
+      "May be used to override evaluation settings and default settings "
+      "from settings.json");
+  desc.add_options()(
+      "tune,t",
+      "Instead of evaluating the whole grid search the best configuration by "
+      "successive halving and print it in the format expected by "
+      "fformation-evaluation -c");
+  desc.add_options()(
+      "tune-frames",
+      boost::program_options::value<size_t>()->default_value(16),
+      "The number of frames every configuration is evaluated on in the first "
+      "tuning round. Doubles every round.");
+  desc.add_options()(
+      "tune-seed", boost::program_options::value<size_t>()->default_value(0),
+      "Seeds the random frame selection of the tuning rounds.");
+  desc.add_options()(
+      "threads,j", boost::program_options::value<size_t>()->default_value(0),
+      "The number of worker threads. 0 uses all available cores.");
+  desc.add_options()(
+      "dataset,d", boost::program_options::value<std::string>()->required(),
+      "The root path of the evaluation dataset. The path is expected "
+      "to contain features.json, groundtruth.json and settings.json");
+  try {
+    boost::program_options::store(
+        boost::program_options::parse_command_line(argc, args, desc),
+        program_options);
+    if (program_options.count("help")) {
+      std::cout << desc << "\n";
+      return 0;
+    }
+    boost::program_options::notify(program_options);
+  } catch (const std::exception &e) {
+    std::cerr << "Error while parsing command line parameters:\n\t" << e.what()
+              << "\n";
+    std::cerr << desc << std::endl;
+    return 1;
+  }
+
+  std::string path = program_options["dataset"].as<std::string>();
+  Settings settings = Settings::readMatlabJson(path + "/settings.json");
+
+  auto config = GroupDetectorFactory::parseConfig(
+      program_options["classificator"].as<std::string>());
+  config.second.insert(Option("stride", settings.stride()));
+  config.second.insert(Option("mdl", settings.mdl()));
+
+  auto spec = ParameterSweep::parseSweep(
+      program_options["sweep"].as<std::string>());
+
+  Features features = Features::readMatlabJson(path + "/features.json");
+  GroundTruth groundtruth =
+      GroundTruth::readMatlabJson(path + "/groundtruth.json");
+
+  ParameterSweep sweep(features, groundtruth, config.first,
+                       Options::parseFromString(
+                           program_options["evaluation"].as<std::string>()));
+  auto configurations = ParameterSweep::expand(config.second, spec);
+  if (program_options.count("tune")) {
+    std::vector<ParameterSweep::Rung> rungs;
+    auto best = sweep.tune(configurations,
+                           program_options["tune-frames"].as<size_t>(),
+                           program_options["tune-seed"].as<size_t>(),
+                           program_options["threads"].as<size_t>(), &rungs);
+    for (auto &rung : rungs) {
+      std::cerr << "tuning: evaluated " << rung.configurations
+                << " configurations on " << rung.frames << " frames. best: "
+                << rung.best.options.toString() << " f1: " << rung.best.f1
+                << std::endl;
+    }
+    ParameterSweep::printTable(std::cerr, {best}, spec);
+    std::cout << config.first << "@" << best.options.toString() << std::endl;
+  } else {
+    auto results =
+        sweep.run(configurations, program_options["threads"].as<size_t>());
+    ParameterSweep::printTable(std::cout, results, spec);
+  }
+}
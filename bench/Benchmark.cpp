@@ -0,0 +1,107 @@
+/********************************************************************
+**                                                                 **
+** File   : bench/Benchmark.cpp                                    **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "Benchmark.h"
+#include "AllocationTracker.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using fformation::bench::Registry;
+using fformation::bench::Measurement;
+using fformation::AllocationTracker;
+
+std::vector<Measurement> Registry::run(const std::string &filter,
+                                       double min_time) const {
+  std::vector<Measurement> results;
+  for (auto &benchmark : _benchmarks) {
+    if (benchmark.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    auto runner = benchmark.setup();
+    Measurement measurement;
+    measurement.name = benchmark.name;
+    measurement.parameters = benchmark.parameters;
+    measurement.items = benchmark.items;
+    for (size_t iterations = 1;; iterations *= 2) {
+      auto start = std::chrono::steady_clock::now();
+      auto allocated = AllocationTracker::measure([&]() { runner(iterations); });
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      measurement.iterations = iterations;
+      measurement.seconds = elapsed.count();
+      measurement.allocations = allocated.allocations;
+      measurement.bytes = allocated.bytes;
+      if (measurement.seconds >= min_time) {
+        break;
+      }
+    }
+    std::cerr << measurement.name;
+    for (auto &parameter : measurement.parameters) {
+      std::cerr << " " << parameter.first << "=" << parameter.second;
+    }
+    std::cerr << ": " << measurement.nanosecondsPerIteration() << " ns"
+              << std::endl;
+    results.push_back(measurement);
+  }
+  return results;
+}
+
+std::ostream &Registry::printJson(std::ostream &out,
+                                  const std::vector<Measurement> &results) {
+  out << "{ \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    auto &result = results[i];
+    out << ((i == 0) ? "\n" : ",\n");
+    out << "  { \"name\": \"" << result.name << "\", \"parameters\": { ";
+    for (auto it = result.parameters.begin(); it != result.parameters.end();
+         ++it) {
+      if (it != result.parameters.begin()) {
+        out << ", ";
+      }
+      out << "\"" << it->first << "\": " << it->second;
+    }
+    out << " }, \"iterations\": " << result.iterations
+        << ", \"seconds\": " << std::setprecision(9) << result.seconds
+        << ", \"ns_per_iteration\": " << result.nanosecondsPerIteration()
+        << ", \"items_per_second\": " << result.itemsPerSecond()
+        << ", \"allocations_per_iteration\": "
+        << result.allocationsPerIteration()
+        << ", \"bytes_per_iteration\": " << result.bytesPerIteration() << " }";
+  }
+  out << "\n] }\n";
+  return out;
+}
+
+std::ostream &Registry::printTable(std::ostream &out,
+                                   const std::vector<Measurement> &results) {
+  out << "name\tparameters\titerations\tns_per_iteration\titems_per_second\t"
+         "allocations_per_iteration\tbytes_per_iteration\n";
+  for (auto &result : results) {
+    out << result.name << "\t";
+    for (auto it = result.parameters.begin(); it != result.parameters.end();
+         ++it) {
+      out << ((it == result.parameters.begin()) ? "" : ",") << it->first
+          << "=" << it->second;
+    }
+    out << "\t" << result.iterations << "\t" << std::setprecision(6)
+        << result.nanosecondsPerIteration() << "\t" << result.itemsPerSecond()
+        << "\t" << result.allocationsPerIteration() << "\t"
+        << result.bytesPerIteration() << "\n";
+  }
+  return out;
+}
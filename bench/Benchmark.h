@@ -0,0 +1,106 @@
+/********************************************************************
+**                                                                 **
+** File   : bench/Benchmark.h                                      **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fformation {
+namespace bench {
+
+/**
+ * @brief keep prevents the compiler from optimizing away the calculation of
+ * value.
+ */
+template <typename T> inline void keep(const T &value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r"(&value) : "memory");
+#else
+  static volatile const void *sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * @brief Benchmark a named measurement with parameters.
+ *
+ * setup is called once before the measurement and returns the function that
+ * runs the measured code a passed number of times.
+ */
+struct Benchmark {
+  typedef std::function<void(size_t iterations)> Runner;
+
+  std::string name;
+  std::map<std::string, double> parameters;
+  std::function<Runner()> setup;
+  /**
+   * @brief items the number of processed items per iteration (e.g. frames).
+   */
+  double items = 1.;
+};
+
+struct Measurement {
+  std::string name;
+  std::map<std::string, double> parameters;
+  size_t iterations = 0;
+  double seconds = 0.;
+  double items = 0.;
+  /// allocations and allocated bytes of all iterations
+  size_t allocations = 0;
+  size_t bytes = 0;
+
+  double nanosecondsPerIteration() const {
+    return seconds * 1e9 / double(iterations);
+  }
+  double itemsPerSecond() const {
+    return items * double(iterations) / seconds;
+  }
+  double allocationsPerIteration() const {
+    return double(allocations) / double(iterations);
+  }
+  double bytesPerIteration() const {
+    return double(bytes) / double(iterations);
+  }
+};
+
+class Registry {
+public:
+  void add(const Benchmark &benchmark) { _benchmarks.push_back(benchmark); }
+
+  /**
+   * @brief run measures all benchmarks whose name contains filter.
+   *
+   * The number of iterations is doubled until a run takes at least min_time
+   * seconds.
+   */
+  std::vector<Measurement> run(const std::string &filter,
+                               double min_time) const;
+
+  static std::ostream &printJson(std::ostream &out,
+                                 const std::vector<Measurement> &results);
+  static std::ostream &printTable(std::ostream &out,
+                                  const std::vector<Measurement> &results);
+
+private:
+  std::vector<Benchmark> _benchmarks;
+};
+
+} // namespace bench
+} // namespace fformation
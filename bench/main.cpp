@@ -0,0 +1,441 @@
+/********************************************************************
+**                                                                 **
+** File   : bench/main.cpp                                         **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#define FFORMATION_TRACK_ALLOCATIONS
+#include "AllocationTracker.h"
+#include "Benchmark.h"
+#include "BufferedWriter.h"
+#include "Classification.h"
+#include "Evaluation.h"
+#include "Features.h"
+#include "GroundTruth.h"
+#include "GroupDetectorFactory.h"
+#include "RotationDropout.h"
+#include "SceneGenerator.h"
+#include "Settings.h"
+#include <boost/program_options.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+
+using fformation::bench::Benchmark;
+using fformation::bench::Registry;
+using fformation::bench::keep;
+using fformation::BufferedWriter;
+using fformation::Classification;
+using fformation::Evaluation;
+using fformation::Features;
+using fformation::GroundTruth;
+using fformation::Group;
+using fformation::GroupDetectorFactory;
+using fformation::Observation;
+using fformation::Option;
+using fformation::RotationDropout;
+using fformation::Options;
+using fformation::SceneGenerator;
+using fformation::Settings;
+using fformation::VisibilityModel;
+
+static const double stride = 0.8;
+static const double mdl = 2.;
+
+/**
+ * Creates a scene with equally sized groups where the given fraction of
+ * persons has a rotation.
+ */
+static SceneGenerator createScene(size_t persons, size_t groups,
+                                  double with_rotation, size_t seed = 0,
+                                  size_t frames = 1) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = persons;
+  parameters.frames = frames;
+  parameters.group_size_weights =
+      std::vector<double>(persons / std::max<size_t>(1, groups), 0.);
+  parameters.group_size_weights.back() = 1.;
+  parameters.stride = stride;
+  parameters.mdl = mdl;
+  parameters.missing_rotation = 1. - with_rotation;
+  parameters.seed = seed;
+  return SceneGenerator(parameters);
+}
+
+static const Observation &firstObservation(const SceneGenerator &scene) {
+  return scene.features().observations().front();
+}
+
+static const Classification &firstClassification(const SceneGenerator &scene) {
+  return scene.groundTruth().classifications().front();
+}
+
+static void addKernelBenchmarks(Registry &registry) {
+  for (size_t persons : {8, 32, 128}) {
+    for (std::string mode : {"exact", "approximate"}) {
+      Benchmark visibility;
+      visibility.name = "Person::calculateVisibilityCost/" + mode;
+      visibility.parameters = {{"persons", persons}};
+      visibility.items = double(persons * persons);
+      visibility.setup = [persons, mode]() -> Benchmark::Runner {
+        auto list = firstObservation(createScene(persons, persons / 4, 1.))
+                        .group()
+                        .generatePersonList();
+        auto center = Group::calculateCenter(list, stride);
+        VisibilityModel::Parameters parameters;
+        parameters.mode = VisibilityModel::parseMode(mode);
+        VisibilityModel model(parameters);
+        return [list, center, model](size_t iterations) {
+          for (size_t i = 0; i < iterations; ++i) {
+            double cost = 0.;
+            for (auto &a : list) {
+              for (auto &b : list) {
+                cost += a.calculateVisibilityCost(center, b, model);
+              }
+            }
+            keep(cost);
+          }
+        };
+      };
+      registry.add(visibility);
+    }
+
+    Benchmark distance;
+    distance.name = "Person::calculateDistanceCosts";
+    distance.parameters = {{"persons", persons}};
+    distance.items = double(persons);
+    distance.setup = [persons]() -> Benchmark::Runner {
+      auto list = firstObservation(createScene(persons, persons / 4, 0.5))
+                      .group()
+                      .generatePersonList();
+      auto center = Group::calculateCenter(list, stride);
+      return [list, center](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+          double cost = 0.;
+          for (auto &a : list) {
+            cost += a.calculateDistanceCosts(center, stride);
+          }
+          keep(cost);
+        }
+      };
+    };
+    registry.add(distance);
+
+    Benchmark center;
+    center.name = "Group::calculateCenter";
+    center.parameters = {{"persons", persons}};
+    center.items = double(persons);
+    center.setup = [persons]() -> Benchmark::Runner {
+      auto group = firstObservation(createScene(persons, 1, 0.5)).group();
+      return [group](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+          keep(group.calculateCenter(stride));
+        }
+      };
+    };
+    registry.add(center);
+
+    Benchmark confusion;
+    confusion.name = "Classification::createConfusionMatrix";
+    confusion.parameters = {{"persons", persons}};
+    confusion.setup = [persons]() -> Benchmark::Runner {
+      auto gt = firstClassification(createScene(persons, persons / 4, 1.));
+      auto cl = firstClassification(createScene(persons, persons / 3, 1.));
+      return [gt, cl](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+          keep(cl.createConfusionMatrix(gt, 2. / 3.));
+        }
+      };
+    };
+    registry.add(confusion);
+
+    Benchmark groups;
+    groups.name = "Classification::createGroups";
+    groups.parameters = {{"persons", persons}};
+    groups.items = double(persons);
+    groups.setup = [persons]() -> Benchmark::Runner {
+      auto scene = createScene(persons, persons / 4, 1.);
+      auto observation = firstObservation(scene);
+      auto cl = firstClassification(scene);
+      return [observation, cl](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+          keep(cl.createGroups(observation, true));
+        }
+      };
+    };
+    registry.add(groups);
+
+    for (std::string mode : {"random", "group"}) {
+      Benchmark dropout;
+      dropout.name = "RotationDropout::apply/" + mode;
+      dropout.parameters = {{"persons", persons}};
+      dropout.setup = [persons, mode]() -> Benchmark::Runner {
+        auto scene = createScene(persons, persons / 4, 1.);
+        auto observation =
+            std::make_shared<Observation>(firstObservation(scene));
+        auto dropout = std::make_shared<RotationDropout>(
+            *observation, firstClassification(scene),
+            RotationDropout::parseMode(mode));
+        return [observation, dropout](size_t iterations) {
+          for (size_t i = 0; i < iterations; ++i) {
+            keep(dropout->apply(0.5, i).generatePersonList());
+          }
+        };
+      };
+      registry.add(dropout);
+    }
+  }
+}
+
+static void addReaderBenchmarks(Registry &registry,
+                                const std::string &directory) {
+  const size_t frames = 200;
+  const size_t persons = 32;
+  auto features = directory + "/features.json";
+  auto groundtruth = directory + "/groundtruth.json";
+  auto settings = directory + "/settings.json";
+  auto write = [=]() {
+    SceneGenerator::Parameters parameters;
+    parameters.persons = persons;
+    parameters.frames = frames;
+    parameters.missing_rotation = 0.2;
+    parameters.speed = 0.5;
+    SceneGenerator(parameters).writeMatlabJson(directory);
+  };
+  Benchmark features_reader;
+  features_reader.name = "Features::readMatlabJson";
+  features_reader.parameters = {{"frames", frames}, {"persons", persons}};
+  features_reader.items = frames;
+  features_reader.setup = [=]() -> Benchmark::Runner {
+    write();
+    return [=](size_t iterations) {
+      for (size_t i = 0; i < iterations; ++i) {
+        keep(Features::readMatlabJson(features));
+      }
+    };
+  };
+  registry.add(features_reader);
+  Benchmark groundtruth_reader;
+  groundtruth_reader.name = "GroundTruth::readMatlabJson";
+  groundtruth_reader.parameters = {{"frames", frames}, {"persons", persons}};
+  groundtruth_reader.items = frames;
+  groundtruth_reader.setup = [=]() -> Benchmark::Runner {
+    write();
+    return [=](size_t iterations) {
+      for (size_t i = 0; i < iterations; ++i) {
+        keep(GroundTruth::readMatlabJson(groundtruth));
+      }
+    };
+  };
+  registry.add(groundtruth_reader);
+  Benchmark settings_reader;
+  settings_reader.name = "Settings::readMatlabJson";
+  settings_reader.setup = [=]() -> Benchmark::Runner {
+    write();
+    return [=](size_t iterations) {
+      for (size_t i = 0; i < iterations; ++i) {
+        keep(Settings::readMatlabJson(settings));
+      }
+    };
+  };
+  registry.add(settings_reader);
+}
+
+/**
+ * Compares formatting numbers through an std::ostream with the
+ * BufferedWriter and measures the evaluation printers writing through the
+ * std::ostream adapter or directly to a file descriptor. All output goes to
+ * /dev/null so only the formatting and write overhead is measured.
+ */
+static void addWriterBenchmarks(Registry &registry) {
+  const size_t values = 1000;
+  for (std::string sink : {"ostream", "writer"}) {
+    Benchmark numbers;
+    numbers.name = "write/numbers/" + sink;
+    numbers.items = 2 * values;
+    numbers.setup = [=]() -> Benchmark::Runner {
+      return [=](size_t iterations) {
+        std::ofstream file("/dev/null");
+        BufferedWriter writer(file);
+        for (size_t i = 0; i < iterations; ++i) {
+          for (size_t v = 0; v < values; ++v) {
+            double value = double(v) / 7.;
+            if (sink == "ostream") {
+              file << v << "\t" << value << "\n";
+            } else {
+              writer << v << "\t" << value << "\n";
+            }
+          }
+        }
+      };
+    };
+    registry.add(numbers);
+  }
+
+  const size_t frames = 100;
+  for (std::string printer : {"tsv", "matlab"}) {
+    for (std::string sink : {"ostream", "fd"}) {
+      Benchmark evaluation;
+      evaluation.name = "write/" + printer + "/" + sink;
+      evaluation.items = frames;
+      evaluation.setup = [=]() -> Benchmark::Runner {
+        auto scene = createScene(16, 4, 0.5, 0, frames);
+        Options options;
+        options.insert(Option("stride", stride));
+        options.insert(Option("mdl", mdl));
+        std::shared_ptr<fformation::GroupDetector> detector(
+            GroupDetectorFactory::getDefaultInstance().create("grow",
+                                                              options));
+        auto result = std::make_shared<Evaluation>(
+            scene.features(), scene.groundTruth(), scene.settings(),
+            *detector,
+            Options::parseFromString("evaluation_printer=" + printer));
+        return [=](size_t iterations) {
+          if (sink == "ostream") {
+            std::ofstream file("/dev/null");
+            for (size_t i = 0; i < iterations; ++i) {
+              result->printOutput(file);
+            }
+          } else {
+            int fd = open("/dev/null", O_WRONLY);
+            {
+              BufferedWriter writer(fd);
+              for (size_t i = 0; i < iterations; ++i) {
+                result->printOutput(writer);
+              }
+            }
+            close(fd);
+          }
+        };
+      };
+      registry.add(evaluation);
+    }
+  }
+}
+
+static void addDetectorBenchmarks(Registry &registry) {
+  auto &factory = GroupDetectorFactory::getDefaultInstance();
+  const size_t frames = 8;
+  for (auto name : factory.listDetectors()) {
+    // the em detectors are also measured with their single precision kernels
+    std::vector<std::string> precisions = {"double"};
+    if (name == "grow" || name == "shrink" || name == "shrink2") {
+      precisions.push_back("float");
+    }
+    for (auto precision : precisions) {
+      for (size_t persons : {8, 16, 32}) {
+        for (size_t groups : std::set<size_t>{2, persons / 4}) {
+          for (double rotation : {0., 0.5, 1.}) {
+            Benchmark detector;
+            detector.name = "detect/" + name;
+            if (precision != "double") {
+              detector.name += "/" + precision;
+            }
+            detector.parameters = {{"persons", persons},
+                                   {"groups", groups},
+                                   {"rotation", rotation}};
+            detector.items = frames;
+            detector.setup = [=, &factory]() -> Benchmark::Runner {
+              Options options;
+              options.insert(Option("stride", stride));
+              options.insert(Option("mdl", mdl));
+              if (precision != "double") {
+                options.insert(Option("precision", precision));
+              }
+              std::shared_ptr<fformation::GroupDetector> det(
+                  factory.create(name, options));
+              auto observations =
+                  createScene(persons, groups, rotation, 0, frames)
+                      .features()
+                      .observations();
+              return [det, observations](size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                  for (auto &observation : observations) {
+                    keep(det->detect(observation));
+                  }
+                }
+              };
+            };
+            registry.add(detector);
+          }
+        }
+      }
+    }
+  }
+}
+
+int main(const int argc, const char **args) {
+  boost::program_options::variables_map program_options;
+  boost::program_options::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message");
+  desc.add_options()(
+      "filter,f", boost::program_options::value<std::string>()->default_value(
+                      ""),
+      "Only run benchmarks whose name contains this string.");
+  desc.add_options()(
+      "min-time,t", boost::program_options::value<double>()->default_value(0.2),
+      "The minimal time in seconds a single measurement takes.");
+  desc.add_options()(
+      "output,o", boost::program_options::value<std::string>(),
+      "Write the json results to this file instead of stdout.");
+  desc.add_options()("table", "Print a human readable table instead of json.");
+  try {
+    boost::program_options::store(
+        boost::program_options::parse_command_line(argc, args, desc),
+        program_options);
+    boost::program_options::notify(program_options);
+  } catch (const std::exception &e) {
+    std::cerr << "Error while parsing command line parameters:\n\t" << e.what()
+              << "\n";
+    std::cerr << desc << std::endl;
+    return 1;
+  }
+  if (program_options.count("help")) {
+    std::cout << desc << "\n";
+    return 0;
+  }
+
+  Registry registry;
+  addKernelBenchmarks(registry);
+  char directory[] = "/tmp/fformation-bench-XXXXXX";
+  if (!mkdtemp(directory)) {
+    std::cerr << "Could not create a temporary directory.\n";
+    return 1;
+  }
+  addReaderBenchmarks(registry, directory);
+  addWriterBenchmarks(registry);
+  addDetectorBenchmarks(registry);
+  auto results = registry.run(program_options["filter"].as<std::string>(),
+                              program_options["min-time"].as<double>());
+  for (auto name : {"/features.json", "/groundtruth.json", "/settings.json"}) {
+    std::remove((std::string(directory) + name).c_str());
+  }
+  std::remove(directory);
+
+  std::ofstream file;
+  if (program_options.count("output")) {
+    file.open(program_options["output"].as<std::string>());
+  }
+  std::ostream &out = file.is_open() ? file : std::cout;
+  if (program_options.count("table")) {
+    Registry::printTable(out, results);
+  } else {
+    Registry::printJson(out, results);
+  }
+}
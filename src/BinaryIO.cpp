@@ -0,0 +1,131 @@
+/********************************************************************
+**                                                                 **
+** File   : src/BinaryIO.cpp                                       **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+#include "BinaryIO.h"
+#include "Exception.h"
+#include <algorithm>
+#include <cstring>
+
+using fformation::BinaryIO;
+using fformation::BufferedWriter;
+using fformation::Exception;
+
+void BinaryIO::writeU8(BufferedWriter &out, uint8_t value) {
+  out.write(reinterpret_cast<const char *>(&value), 1);
+}
+
+void BinaryIO::writeU32(BufferedWriter &out, uint32_t value) {
+  char bytes[4];
+  for (size_t i = 0; i < 4; ++i) {
+    bytes[i] = char((value >> (8 * i)) & 0xff);
+  }
+  out.write(bytes, 4);
+}
+
+void BinaryIO::writeU64(BufferedWriter &out, uint64_t value) {
+  char bytes[8];
+  for (size_t i = 0; i < 8; ++i) {
+    bytes[i] = char((value >> (8 * i)) & 0xff);
+  }
+  out.write(bytes, 8);
+}
+
+void BinaryIO::writeF64(BufferedWriter &out, double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  writeU64(out, bits);
+}
+
+void BinaryIO::writeVarint(BufferedWriter &out, uint64_t value) {
+  char bytes[10];
+  size_t size = 0;
+  while (value >= 0x80) {
+    bytes[size++] = char((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  bytes[size++] = char(value);
+  out.write(bytes, size);
+}
+
+void BinaryIO::writeString(BufferedWriter &out, const std::string &value) {
+  writeVarint(out, value.size());
+  out.write(value.data(), value.size());
+}
+
+void BinaryIO::readBytes(std::istream &in, char *data, size_t size) {
+  in.read(data, std::streamsize(size));
+  Exception::check(size_t(in.gcount()) == size,
+                   "Binary input is truncated or cannot be read.");
+}
+
+uint8_t BinaryIO::readU8(std::istream &in) {
+  char byte;
+  readBytes(in, &byte, 1);
+  return uint8_t(byte);
+}
+
+uint32_t BinaryIO::readU32(std::istream &in) {
+  unsigned char bytes[4];
+  readBytes(in, reinterpret_cast<char *>(bytes), 4);
+  uint32_t value = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    value |= uint32_t(bytes[i]) << (8 * i);
+  }
+  return value;
+}
+
+uint64_t BinaryIO::readU64(std::istream &in) {
+  unsigned char bytes[8];
+  readBytes(in, reinterpret_cast<char *>(bytes), 8);
+  uint64_t value = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    value |= uint64_t(bytes[i]) << (8 * i);
+  }
+  return value;
+}
+
+double BinaryIO::readF64(std::istream &in) {
+  uint64_t bits = readU64(in);
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+uint64_t BinaryIO::readVarint(std::istream &in) {
+  uint64_t value = 0;
+  for (size_t shift = 0; shift < 64; shift += 7) {
+    uint8_t byte = readU8(in);
+    value |= uint64_t(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+  throw Exception("Binary input contains an invalid varint.");
+}
+
+std::string BinaryIO::readString(std::istream &in) {
+  // the size is not trusted, the string only grows with the bytes read
+  uint64_t size = readVarint(in);
+  std::string value;
+  char chunk[4096];
+  while (size > 0) {
+    size_t count = size_t(std::min<uint64_t>(size, sizeof(chunk)));
+    readBytes(in, chunk, count);
+    value.append(chunk, count);
+    size -= count;
+  }
+  return value;
+}
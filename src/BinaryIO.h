@@ -0,0 +1,60 @@
+/********************************************************************
+**                                                                 **
+** File   : src/BinaryIO.h                                         **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+#pragma once
+#include "BufferedWriter.h"
+#include <cstdint>
+#include <istream>
+#include <string>
+
+namespace fformation {
+
+/**
+ * @brief BinaryIO the little endian primitives of the binary file formats.
+ *
+ * Fixed size integers and doubles are stored little endian, counts and
+ * indices as varints with 7 bits per byte where the high bit marks a
+ * following byte. The read functions throw an Exception when the input is
+ * truncated or corrupt. Counts read from the input must not be trusted for
+ * allocations before the data they count was read.
+ */
+class BinaryIO {
+public:
+  static void writeU8(BufferedWriter &out, uint8_t value);
+  static void writeU32(BufferedWriter &out, uint32_t value);
+  static void writeU64(BufferedWriter &out, uint64_t value);
+  static void writeF64(BufferedWriter &out, double value);
+  static void writeVarint(BufferedWriter &out, uint64_t value);
+  /**
+   * @brief writeString writes the size as varint followed by the bytes.
+   */
+  static void writeString(BufferedWriter &out, const std::string &value);
+
+  static void readBytes(std::istream &in, char *data, size_t size);
+  static uint8_t readU8(std::istream &in);
+  static uint32_t readU32(std::istream &in);
+  static uint64_t readU64(std::istream &in);
+  static double readF64(std::istream &in);
+  static uint64_t readVarint(std::istream &in);
+  /**
+   * @brief readString reads a string written by writeString. Memory is only
+   * allocated for bytes that were actually read, so a corrupt size throws
+   * instead of allocating.
+   */
+  static std::string readString(std::istream &in);
+};
+
+} // namespace fformation
@@ -0,0 +1,164 @@
+/********************************************************************
+**                                                                 **
+** File   : src/BoundedQueue.h                                     **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief BoundedQueue a lock free multi producer multi consumer queue with a
+ * fixed capacity.
+ *
+ * Every slot carries a sequence number that tells producers and consumers
+ * whether it is free or filled for their position (D. Vyukov's bounded queue).
+ * push blocks while the queue is full, which slows down fast producers
+ * instead of growing memory. After close, pop drains the remaining elements
+ * and then returns false. Producers must not push after close unless they
+ * are aborting, then blocked pushes return false.
+ */
+template <typename T> class BoundedQueue {
+public:
+  /**
+   * @param capacity rounded up to the next power of two
+   */
+  BoundedQueue(size_t capacity) : _slots(roundUp(capacity)) {
+    _mask = _slots.size() - 1;
+    for (size_t i = 0; i < _slots.size(); ++i) {
+      _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+  size_t capacity() const { return _slots.size(); }
+
+  bool tryPush(T &value) {
+    size_t position = _tail.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = _slots[position & _mask];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      auto difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+      if (difference == 0) {
+        if (_tail.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+          slot.value = std::move(value);
+          slot.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false; // full
+      } else {
+        position = _tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool tryPop(T &value) {
+    size_t position = _head.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = _slots[position & _mask];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      auto difference =
+          std::ptrdiff_t(sequence) - std::ptrdiff_t(position + 1);
+      if (difference == 0) {
+        if (_head.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+          value = std::move(slot.value);
+          slot.sequence.store(position + _mask + 1,
+                              std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false; // empty
+      } else {
+        position = _head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief push waits until the value fits into the queue.
+   * @return false if the queue is closed, the value is dropped then
+   */
+  bool push(T value) {
+    for (size_t attempt = 0; !tryPush(value); ++attempt) {
+      if (closed()) {
+        return false;
+      }
+      backoff(attempt);
+    }
+    return true;
+  }
+
+  /**
+   * @brief pop waits for the next value.
+   * @return false if the queue is closed and empty
+   */
+  bool pop(T &value) {
+    for (size_t attempt = 0; !tryPop(value); ++attempt) {
+      if (closed()) {
+        // values pushed before close may have arrived in the meantime
+        return tryPop(value);
+      }
+      backoff(attempt);
+    }
+    return true;
+  }
+
+  /**
+   * @brief close signals the consumers that no more values will be pushed.
+   */
+  void close() { _closed.store(true, std::memory_order_release); }
+
+  bool closed() const { return _closed.load(std::memory_order_acquire); }
+
+private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  static size_t roundUp(size_t capacity) {
+    size_t result = 2;
+    while (result < capacity) {
+      result *= 2;
+    }
+    return result;
+  }
+
+  static void backoff(size_t attempt) {
+    if (attempt < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  std::vector<Slot> _slots;
+  size_t _mask;
+  alignas(64) std::atomic<size_t> _head{0};
+  alignas(64) std::atomic<size_t> _tail{0};
+  std::atomic<bool> _closed{false};
+};
+
+} // namespace fformation
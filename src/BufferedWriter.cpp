@@ -0,0 +1,94 @@
+/********************************************************************
+**                                                                 **
+** File   : src/BufferedWriter.cpp                                 **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "BufferedWriter.h"
+#include "Exception.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+using fformation::BufferedWriter;
+using fformation::Exception;
+
+BufferedWriter::BufferedWriter(int fd) : _fd(fd), _buffer(chunk_size) {}
+
+BufferedWriter::BufferedWriter(std::ostream &out)
+    : _out(&out), _buffer(chunk_size) {}
+
+BufferedWriter::~BufferedWriter() {
+  try {
+    flush();
+  } catch (const Exception &) {
+    // destructors must not throw, the error was reported by earlier flushes
+  }
+}
+
+BufferedWriter &BufferedWriter::operator<<(const char *text) {
+  return write(text, std::strlen(text));
+}
+
+BufferedWriter &BufferedWriter::operator<<(double value) {
+  // the conversions std::ostream uses for the same floatfield
+  const char *format = "%.*g";
+  if (_format == Format::Fixed) {
+    format = "%.*f";
+  } else if (_format == Format::Scientific) {
+    format = "%.*e";
+  }
+  char text[64];
+  int size = std::snprintf(text, sizeof(text), format, _precision, value);
+  if (size >= 0 && size_t(size) < sizeof(text)) {
+    return write(text, size_t(size));
+  }
+  // very large fixed values
+  std::vector<char> large(size_t(size) + 1);
+  std::snprintf(large.data(), large.size(), format, _precision, value);
+  return write(large.data(), size_t(size));
+}
+
+void BufferedWriter::flush() {
+  flushBuffer();
+  if (_out != nullptr) {
+    _out->flush();
+  }
+}
+
+void BufferedWriter::flushBuffer() {
+  if (_size > 0) {
+    size_t size = _size;
+    _size = 0;
+    writeOut(_buffer.data(), size);
+  }
+}
+
+void BufferedWriter::writeOut(const char *data, size_t size) {
+  if (_out != nullptr) {
+    _out->write(data, std::streamsize(size));
+    return;
+  }
+  while (size > 0) {
+    ssize_t written = ::write(_fd, data, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    Exception::check(written > 0, std::string("Cannot write output: ") +
+                                      std::strerror(errno));
+    data += written;
+    size -= size_t(written);
+  }
+}
@@ -0,0 +1,160 @@
+/********************************************************************
+**                                                                 **
+** File   : src/BufferedWriter.h                                   **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief BufferedWriter formats text into a fixed size chunk that is written
+ * to a file descriptor or an std::ostream when it is full.
+ *
+ * Numbers are formatted exactly like a default std::ostream with the same
+ * precision and floatfield would format them, but without locale and sentry
+ * overhead. Integers are converted by hand, floating point values by
+ * snprintf. The writer flushes on destruction.
+ */
+class BufferedWriter {
+public:
+  static const size_t chunk_size = 1 << 16;
+
+  enum class Format { General, Fixed, Scientific };
+
+  /**
+   * @brief BufferedWriter writes directly to a file descriptor. The
+   * descriptor is not closed.
+   */
+  explicit BufferedWriter(int fd);
+
+  /**
+   * @brief BufferedWriter adapts an std::ostream. Full chunks are written with
+   * ostream::write, flush also flushes the stream.
+   */
+  explicit BufferedWriter(std::ostream &out);
+
+  ~BufferedWriter();
+
+  BufferedWriter(const BufferedWriter &) = delete;
+  BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+  /**
+   * @brief precision the number of digits used for floating point values, as
+   * std::ostream::precision. Defaults to 6.
+   */
+  BufferedWriter &precision(int digits) {
+    _precision = digits;
+    return *this;
+  }
+  int precision() const { return _precision; }
+
+  BufferedWriter &format(Format format) {
+    _format = format;
+    return *this;
+  }
+  Format format() const { return _format; }
+
+  BufferedWriter &write(const char *data, size_t size) {
+    if (size > _buffer.size() - _size) {
+      flushBuffer();
+      if (size > _buffer.size()) {
+        writeOut(data, size);
+        return *this;
+      }
+    }
+    std::copy(data, data + size, _buffer.data() + _size);
+    _size += size;
+    return *this;
+  }
+
+  BufferedWriter &operator<<(char c) {
+    if (_size == _buffer.size()) {
+      flushBuffer();
+    }
+    _buffer[_size++] = c;
+    return *this;
+  }
+  BufferedWriter &operator<<(const char *text);
+  BufferedWriter &operator<<(const std::string &text) {
+    return write(text.data(), text.size());
+  }
+  BufferedWriter &operator<<(bool value) { return *this << int(value); }
+  BufferedWriter &operator<<(int value) { return writeSigned(value); }
+  BufferedWriter &operator<<(long value) { return writeSigned(value); }
+  BufferedWriter &operator<<(long long value) { return writeSigned(value); }
+  BufferedWriter &operator<<(unsigned value) { return writeUnsigned(value); }
+  BufferedWriter &operator<<(unsigned long value) {
+    return writeUnsigned(value);
+  }
+  BufferedWriter &operator<<(unsigned long long value) {
+    return writeUnsigned(value);
+  }
+  BufferedWriter &operator<<(double value);
+
+  /**
+   * @brief operator << prints "--" for an empty optional and " " followed by
+   * the value otherwise, like boost's optional_io.
+   */
+  template <typename T>
+  BufferedWriter &operator<<(const boost::optional<T> &value) {
+    if (!value) {
+      return *this << "--";
+    }
+    return *this << ' ' << *value;
+  }
+
+  /**
+   * @brief flush writes the buffered data to the target.
+   */
+  void flush();
+
+private:
+  BufferedWriter &writeSigned(long long value) {
+    if (value < 0) {
+      *this << '-';
+      return writeUnsigned(0ull - (unsigned long long)value);
+    }
+    return writeUnsigned((unsigned long long)value);
+  }
+
+  BufferedWriter &writeUnsigned(unsigned long long value) {
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    char *begin = end;
+    do {
+      *--begin = char('0' + value % 10);
+      value /= 10;
+    } while (value != 0);
+    return write(begin, size_t(end - begin));
+  }
+
+  void flushBuffer();
+  void writeOut(const char *data, size_t size);
+
+  int _fd = -1;
+  std::ostream *_out = nullptr;
+  std::vector<char> _buffer;
+  size_t _size = 0;
+  int _precision = 6;
+  Format _format = Format::General;
+};
+
+} // namespace fformation
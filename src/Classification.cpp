@@ -16,6 +16,7 @@
 ********************************************************************/
 
 #include "Classification.h"
+#include <algorithm>
 #include <assert.h>
 #include <limits>
 
@@ -25,6 +26,7 @@ using fformation::Observation;
 using fformation::ConfusionMatrix;
 using fformation::Timestamp;
 using fformation::IdGroup;
+using fformation::VisibilityModel;
 
 Classification::Classification(Timestamp timestamp,
                                const std::vector<IdGroup> &groups)
@@ -42,10 +44,10 @@ std::vector<Group> Classification::createGroups(const Observation &observation,
   result.reserve(_groups.size());
   std::vector<IdGroup> id_groups = _groups;
   if (singular) {
-    for (auto person_it : observation.group().persons()) {
-      auto id = person_it.first;
+    for (auto &person_it : observation.group().persons()) {
+      auto &id = person_it.first;
       bool found = false;
-      for (auto id_group : id_groups) {
+      for (auto &id_group : id_groups) {
         if (id_group.has_person(id)) {
           found = true;
           break;
@@ -56,8 +58,8 @@ std::vector<Group> Classification::createGroups(const Observation &observation,
       }
     }
   }
-  for (auto group : id_groups) {
-    result.push_back(Group(observation.group().find_persons(group.persons())));
+  for (auto &group : id_groups) {
+    result.push_back(Group(observation.group().find_persons(group)));
   }
   return result;
 }
@@ -75,17 +77,18 @@ double Classification::calculateMDLCosts(double mdl_prior) const {
   return mdl_prior * (double)_groups.size();
 }
 
-double Classification::calculateVisibilityCosts(const Observation &observation,
-                                                Person::Stride stride) const {
+double Classification::calculateVisibilityCosts(
+    const Observation &observation, Person::Stride stride,
+    const VisibilityModel &visibility) const {
   auto groups = createGroups(observation);
-  auto all_persons = observation.group().persons();
+  auto &all_persons = observation.group().persons();
   double cost = 0.;
-  for (auto group : groups) {
+  for (auto &group : groups) {
     auto center = group.calculateCenter(stride);
-    for (auto person_i : group.persons()) {
-      for (auto person_j : all_persons) {
-        cost +=
-            person_i.second.calculateVisibilityCost(center, person_j.second);
+    for (auto &person_i : group.persons()) {
+      for (auto &person_j : all_persons) {
+        cost += person_i.second.calculateVisibilityCost(
+            center, person_j.second, visibility);
       }
     }
   }
@@ -95,10 +98,10 @@ double Classification::calculateVisibilityCosts(const Observation &observation,
 static std::vector<IdGroup> fillUpFrom(const std::vector<IdGroup> &fill,
                                        const std::vector<IdGroup> &from) {
   auto result = fill;
-  for (auto gt_group : from) {
-    for (auto gt_person : gt_group.persons()) {
+  for (auto &gt_group : from) {
+    for (auto &gt_person : gt_group.persons()) {
       bool found = false;
-      for (auto group : result) {
+      for (auto &group : result) {
         if (group.persons().find(gt_person) != group.persons().end()) {
           found = true;
           break;
@@ -115,22 +118,27 @@ static std::vector<IdGroup> fillUpFrom(const std::vector<IdGroup> &fill,
 ConfusionMatrix
 Classification::createConfusionMatrix(const Classification &ground_truth,
                                       double threshhold) const {
-  assert(threshhold >= 0.);
-  assert(threshhold <= 1.);
+  return createConfusionMatrices(ground_truth, {threshhold}).front();
+}
+
+std::vector<ConfusionMatrix> Classification::createConfusionMatrices(
+    const Classification &ground_truth,
+    const std::vector<double> &thresholds) const {
   // in case the algothithm does not add non-group persons as on-person groups
   // we need to collect the missing persons here for the correct results
   auto cl = fillUpFrom(_groups, ground_truth.idGroups());
   auto gt = fillUpFrom(ground_truth.idGroups(), _groups);
 
-  // count the various cases
-  ConfusionMatrix::IntType true_positive = 0;
+  // count the threshold independent cases and collect the best intersection
+  // of every classified group with the ground truth
   ConfusionMatrix::IntType true_negative = 0;
   ConfusionMatrix::IntType false_negative = 0;
-  ConfusionMatrix::IntType false_positive = 0;
-  for (auto classified_group : cl) {
+  std::vector<double> best_intersections;
+  best_intersections.reserve(cl.size());
+  for (auto &classified_group : cl) {
     if (classified_group.persons().size() == 1) {
       // not added to a group. validate that person is not in a group in gt
-      for (auto gt_group : gt) {
+      for (auto &gt_group : gt) {
         if (gt_group.persons().find(*classified_group.persons().begin()) !=
             gt_group.persons().end()) {
           if (gt_group.persons().size() == 1) {
@@ -142,24 +150,35 @@ Classification::createConfusionMatrix(const Classification &ground_truth,
         }
       }
     } else {
-      // find a grop in gt with a high enough intersection.
-      bool found = false;
-      for (auto gt_group : gt) {
-        if (calculateGroupIntersection(classified_group, gt_group) >=
-            (threshhold - std::numeric_limits<double>::epsilon())) {
-          found = true;
-          break;
-        }
+      // find the grop in gt with the highest intersection.
+      double best = 0.;
+      for (auto &gt_group : gt) {
+        best = std::max(best,
+                        calculateGroupIntersection(classified_group, gt_group));
       }
-      if (found) {
+      best_intersections.push_back(best);
+    } // else ignore empty groups
+  }
+
+  std::vector<ConfusionMatrix> result;
+  result.reserve(thresholds.size());
+  for (auto threshhold : thresholds) {
+    assert(threshhold >= 0.);
+    assert(threshhold <= 1.);
+    ConfusionMatrix::IntType true_positive = 0;
+    ConfusionMatrix::IntType false_positive = 0;
+    for (auto intersection : best_intersections) {
+      if (intersection >=
+          (threshhold - std::numeric_limits<double>::epsilon())) {
         true_positive += 1;
       } else {
         false_positive += 1;
       }
-    } // else ignore empty groups
+    }
+    result.push_back(ConfusionMatrix(true_positive, false_positive,
+                                     true_negative, false_negative));
   }
-  return ConfusionMatrix(true_positive, false_positive, true_negative,
-                         false_negative);
+  return result;
 }
 
 double Classification::calculateGroupIntersection(const IdGroup &first,
@@ -170,7 +189,7 @@ double Classification::calculateGroupIntersection(const IdGroup &first,
                            ? first.persons().size()
                            : second.persons().size();
   size_t intersection = 0;
-  for (auto person : first.persons()) {
+  for (auto &person : first.persons()) {
     if (second.persons().find(person) != second.persons().end()) {
       ++intersection;
     }
@@ -78,11 +78,13 @@ public:
    *
    * @param observation must correspond to this classification
    * @param stride the distance btw. a person and its transactional space
+   * @param visibility the visibility parameters
    * @return the costs caused by obstructions btw. all persons and their
    * proposed groups.
    */
-  double calculateVisibilityCosts(const Observation &observation,
-                                  Person::Stride stride) const;
+  double calculateVisibilityCosts(
+      const Observation &observation, Person::Stride stride,
+      const VisibilityModel &visibility = VisibilityModel::standard()) const;
 
   /**
    * @brief calculateCosts calculates the summed costs of the classification.
@@ -90,13 +92,15 @@ public:
    * @param stride the distance btw. a person and its transactional space
    * @param mdl_prior sigma^2 of the normal probability distribution of persons
    *        transactional space
+   * @param visibility the visibility parameters
    * @return
    */
-  double calculateCosts(const Observation &observation, Person::Stride stride,
-                        double mdl_prior) const {
+  double calculateCosts(
+      const Observation &observation, Person::Stride stride, double mdl_prior,
+      const VisibilityModel &visibility = VisibilityModel::standard()) const {
     return calculateDistanceCosts(observation, stride) +
            calculateMDLCosts(mdl_prior) +
-           calculateVisibilityCosts(observation, stride);
+           calculateVisibilityCosts(observation, stride, visibility);
   }
 
   /**
@@ -130,13 +134,35 @@ public:
   ConfusionMatrix createConfusionMatrix(const Classification &ground_truth,
                                         double threshhold = 1.) const;
 
+  /**
+   * @brief createConfusionMatrices creates one confusion matrix per threshold.
+   *
+   * The group intersections are calculated only once and shared by all
+   * thresholds. The result for every threshold equals the result of
+   * createConfusionMatrix(ground_truth, threshold).
+   *
+   * @param ground_truth the correct classification of the same observation.
+   * @param thresholds the intersection thresholds to evaluate
+   * @return one ConfusionMatrix per threshold in the same order
+   */
+  std::vector<ConfusionMatrix>
+  createConfusionMatrices(const Classification &ground_truth,
+                          const std::vector<double> &thresholds) const;
+
   virtual void serializeJson(std::ostream &out) const override {
+    writeJson(out);
+  }
+  virtual void serializeJson(BufferedWriter &out) const override {
+    writeJson(out);
+  }
+
+private:
+  template <typename Stream> void writeJson(Stream &out) const {
     out << "{ \"timestamp\": " << _timestamp << ", \"groups\": ";
     serializeIterable(out, _groups);
     out << " }";
   }
 
-private:
   Timestamp _timestamp;
   std::vector<IdGroup> _groups;
 };
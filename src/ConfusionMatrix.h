@@ -17,13 +17,17 @@
 
 #pragma once
 
-#include "JsonSerializable.h"
+#include "BufferedWriter.h"
+#include "OstreamPrinter.h"
 #include <array>
 #include <vector>
 
 namespace fformation {
 
-class ConfusionMatrix : public JsonSerializable {
+/**
+ * @brief ConfusionMatrix trivially copyable counts of a binary classification.
+ */
+class ConfusionMatrix {
 public:
   typedef int IntType;
   typedef double RealType;
@@ -106,13 +110,6 @@ public:
     return calculateFBetaScore(calculatePrecision(), calculateRecall(), beta);
   }
 
-  virtual void serializeJson(std::ostream &out) const override {
-    out << "{ \"true-positive\": " << true_positive()
-        << ", \"false-positive\": " << false_positive()
-        << ", \"true-negative\": " << true_negative()
-        << ", \"false-negative\": " << false_negative() << " }";
-  }
-
   template <typename Set, typename AccessFunction>
   static RealType calculateMean(Set set, AccessFunction function) {
     RealType result = 0.;
@@ -157,4 +154,12 @@ private:
   std::array<IntType, 4> _data;
 };
 
+template <typename Stream>
+void serializeJson(Stream &out, const ConfusionMatrix &matrix) {
+  out << "{ \"true-positive\": " << matrix.true_positive()
+      << ", \"false-positive\": " << matrix.false_positive()
+      << ", \"true-negative\": " << matrix.true_negative()
+      << ", \"false-negative\": " << matrix.false_negative() << " }";
+}
+
 } // namespace fformation
@@ -0,0 +1,160 @@
+/********************************************************************
+**                                                                 **
+** File   : src/DetectionService.cpp                               **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "DetectionService.h"
+#include "Exception.h"
+#include "Parallel.h"
+#include "Trace.h"
+#include <algorithm>
+#include <future>
+
+using fformation::DetectionService;
+using fformation::Classification;
+using fformation::Observation;
+using fformation::Exception;
+using fformation::Parallel;
+using fformation::Trace;
+
+static double seconds(const std::chrono::steady_clock::duration &duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+DetectionService::DetectionService(GroupDetectorPool::Ptr pool, size_t threads,
+                                   size_t max_batch)
+    : _pool(pool),
+      _threads(threads == 0 ? Parallel::defaultThreads() : threads),
+      _max_batch(max_batch) {
+  Exception::check(_pool != nullptr, "A detection service needs a pool.");
+  Exception::check(_max_batch > 0, "The batch size must be positive.");
+  _workers.reserve(_threads);
+  for (size_t i = 0; i < _threads; ++i) {
+    _workers.push_back(std::thread([this]() { work(); }));
+  }
+}
+
+DetectionService::~DetectionService() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _wakeup.notify_all();
+  for (auto &worker : _workers) {
+    worker.join();
+  }
+}
+
+void DetectionService::submit(const Observation &observation,
+                              const Callback &callback) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Exception::check(!_stop, "The detection service is stopped.");
+    _queue.push_back({observation, callback, Clock::now()});
+  }
+  _wakeup.notify_one();
+}
+
+Classification DetectionService::detect(const Observation &observation) {
+  std::promise<Classification> promise;
+  submit(observation, [&promise](const Classification &classification,
+                                 std::exception_ptr error, double) {
+    if (error) {
+      promise.set_exception(error);
+    } else {
+      promise.set_value(classification);
+    }
+  });
+  return promise.get_future().get();
+}
+
+void DetectionService::wait() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _done.wait(lock, [this]() { return _queue.empty() && _in_progress == 0; });
+}
+
+DetectionService::Metrics DetectionService::metrics() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  Metrics result = _metrics;
+  result.pending = _queue.size();
+  return result;
+}
+
+void DetectionService::work() {
+  auto detector = _pool->checkout();
+  std::vector<Request> batch;
+  batch.reserve(_max_batch);
+  std::vector<double> waits, latencies;
+  waits.reserve(_max_batch);
+  latencies.reserve(_max_batch);
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _wakeup.wait(lock, [this]() { return _stop || !_queue.empty(); });
+      if (_queue.empty()) {
+        return; // stopped and drained
+      }
+      // the share of the queue, rounded up, leaves work for the other workers
+      size_t take = std::min(_max_batch,
+                             (_queue.size() + _threads - 1) / _threads);
+      while (batch.size() < take) {
+        batch.push_back(std::move(_queue.front()));
+        _queue.pop_front();
+      }
+      _in_progress += batch.size();
+    }
+    Trace::Scope scope("batch", "service", {{"size", double(batch.size())}});
+    size_t failures = 0;
+    auto taken = Clock::now();
+    for (auto &request : batch) {
+      waits.push_back(seconds(taken - request.submitted));
+      Classification classification;
+      std::exception_ptr error;
+      try {
+        classification = detector->detect(request.observation);
+      } catch (...) {
+        error = std::current_exception();
+        ++failures;
+      }
+      double latency = seconds(Clock::now() - request.submitted);
+      latencies.push_back(latency);
+      try {
+        request.callback(classification, error, latency);
+      } catch (...) {
+        // the worker has nobody to report to, so a throwing callback only
+        // counts as a failure and must not skip the bookkeeping below
+        if (!error) {
+          ++failures;
+        }
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _metrics.requests += batch.size();
+      _metrics.failures += failures;
+      ++_metrics.batches;
+      for (size_t i = 0; i < batch.size(); ++i) {
+        _metrics.queue_wait.add(waits[i]);
+        _metrics.latency.add(latencies[i]);
+        _metrics.latency_quantiles.add(latencies[i]);
+      }
+      _in_progress -= batch.size();
+    }
+    _done.notify_all();
+    batch.clear();
+    waits.clear();
+    latencies.clear();
+  }
+}
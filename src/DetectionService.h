@@ -0,0 +1,131 @@
+/********************************************************************
+**                                                                 **
+** File   : src/DetectionService.h                                 **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "Classification.h"
+#include "GroupDetectorPool.h"
+#include "Observation.h"
+#include "RunningStatistics.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief DetectionService detects groups in observations submitted from any
+ * number of threads.
+ *
+ * Requests are queued and taken by the worker threads in batches of up to
+ * max_batch requests, so concurrent submitters share one queue lock per batch
+ * instead of one per request. A worker takes at most its share of the queue,
+ * so a burst is spread over all workers. Every worker checks out its own detector from
+ * the pool for its whole lifetime. Results are delivered through a callback in
+ * the worker thread.
+ */
+class DetectionService {
+public:
+  /**
+   * @brief Callback receives the classification or the exception of a failed
+   * detection together with the latency of the request in seconds.
+   */
+  typedef std::function<void(const Classification &classification,
+                             std::exception_ptr error, double latency)>
+      Callback;
+
+  /**
+   * @brief Metrics latency and batching aggregates since construction.
+   */
+  struct Metrics {
+    size_t requests = 0;
+    size_t failures = 0;
+    size_t batches = 0;
+    size_t pending = 0;
+    /// seconds from submit to delivery
+    RunningStatistics latency;
+    /// seconds a request waited in the queue
+    RunningStatistics queue_wait;
+    RelativeQuantileSketch latency_quantiles;
+  };
+
+  /**
+   * @param pool provides one detector per worker
+   * @param threads the number of workers. 0 = Parallel::defaultThreads()
+   * @param max_batch the maximal number of requests a worker takes at once
+   */
+  DetectionService(GroupDetectorPool::Ptr pool, size_t threads = 0,
+                   size_t max_batch = 64);
+
+  /**
+   * @brief ~DetectionService finishes all pending requests.
+   */
+  ~DetectionService();
+
+  DetectionService(const DetectionService &) = delete;
+  DetectionService &operator=(const DetectionService &) = delete;
+
+  /**
+   * @brief submit queues an observation. Thread safe. callback is called
+   * exactly once from a worker thread. Exceptions thrown by callback are
+   * swallowed and counted as failures.
+   */
+  void submit(const Observation &observation, const Callback &callback);
+
+  /**
+   * @brief detect submits an observation and waits for its classification.
+   * Rethrows detection errors.
+   */
+  Classification detect(const Observation &observation);
+
+  /**
+   * @brief wait blocks until all submitted requests were delivered.
+   */
+  void wait();
+
+  Metrics metrics() const;
+
+  size_t threads() const { return _threads; }
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Request {
+    Observation observation;
+    Callback callback;
+    Clock::time_point submitted;
+  };
+
+  void work();
+
+  GroupDetectorPool::Ptr _pool;
+  const size_t _threads;
+  const size_t _max_batch;
+  mutable std::mutex _mutex;
+  std::condition_variable _wakeup;
+  std::condition_variable _done;
+  std::deque<Request> _queue;
+  size_t _in_progress = 0;
+  bool _stop = false;
+  Metrics _metrics;
+  std::vector<std::thread> _workers;
+};
+
+} // namespace fformation
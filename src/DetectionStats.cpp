@@ -0,0 +1,33 @@
+/********************************************************************
+**                                                                 **
+** File   : src/DetectionStats.cpp                                 **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "DetectionStats.h"
+
+using fformation::DetectionStats;
+
+std::vector<std::pair<std::string, double>> DetectionStats::values() const {
+  return {{"persons", double(persons)},
+          {"outer_iterations", double(outer_iterations)},
+          {"em_iterations", double(em_iterations)},
+          {"cost_evaluations", double(cost_evaluations)},
+          {"visibility_evaluations", double(visibility_evaluations)},
+          {"converged", converged ? 1. : 0.},
+          {"propose_seconds", propose_seconds},
+          {"em_seconds", em_seconds},
+          {"cost_seconds", cost_seconds},
+          {"total_seconds", total_seconds}};
+}
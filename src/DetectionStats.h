@@ -0,0 +1,92 @@
+/********************************************************************
+**                                                                 **
+** File   : src/DetectionStats.h                                   **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief DetectionStats describes the work a detector did for a single
+ * observation.
+ *
+ * Detectors fill what they can measure and leave the rest at zero.
+ */
+struct DetectionStats {
+  /// the number of persons in the observation
+  size_t persons = 0;
+  /// the number of proposed center configurations (grow/shrink steps)
+  size_t outer_iterations = 0;
+  /// the number of EM iterations over all outer iterations
+  size_t em_iterations = 0;
+  /// the number of person to center assignment cost evaluations
+  size_t cost_evaluations = 0;
+  /// the number of person pair visibility cost evaluations
+  size_t visibility_evaluations = 0;
+  /// whether the detector stopped because the costs did not improve
+  bool converged = false;
+  /// the time spent proposing new centers
+  double propose_seconds = 0.;
+  /// the time spent in EM
+  double em_seconds = 0.;
+  /// the time spent evaluating the total costs of a configuration
+  double cost_seconds = 0.;
+  /// the wall time of the whole detection
+  double total_seconds = 0.;
+  /// whether the durations are measured. Callers that only want the
+  /// classification clear it, so detectors do not read the clock.
+  bool timed = true;
+
+  /**
+   * @brief values all measured fields as name value pairs in declaration
+   * order.
+   */
+  std::vector<std::pair<std::string, double>> values() const;
+
+  /**
+   * @brief Stopwatch adds the time between its construction and destruction
+   * to seconds. A disabled stopwatch does not read the clock.
+   */
+  class Stopwatch {
+  public:
+    Stopwatch(double &seconds, bool enabled = true)
+        : _seconds(enabled ? &seconds : nullptr) {
+      if (_seconds) {
+        _start = std::chrono::steady_clock::now();
+      }
+    }
+    ~Stopwatch() {
+      if (_seconds) {
+        *_seconds += std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - _start)
+                         .count();
+      }
+    }
+    Stopwatch(const Stopwatch &) = delete;
+    Stopwatch &operator=(const Stopwatch &) = delete;
+
+  private:
+    double *_seconds;
+    std::chrono::steady_clock::time_point _start;
+  };
+};
+
+} // namespace fformation
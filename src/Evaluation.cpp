@@ -17,18 +17,20 @@
 
 #include "Evaluation.h"
 #include "JsonSerializable.h"
+#include "Parallel.h"
+#include "Pipeline.h"
+#include "RotationDropout.h"
+#include "Trace.h"
+#include <algorithm>
 #include <assert.h>
+#include <chrono>
+#include <boost/tokenizer.hpp>
 #include <iomanip>
 #include <iostream>
-#include <random>
-
-#if 0
-#define LOG(x)
-#else
-#define LOG(x) std::cerr << __FILE__ "[" << __LINE__ << "]: " << x
-#endif
 
+using fformation::BufferedWriter;
 using fformation::Evaluation;
+using fformation::ResultLog;
 using fformation::ConfusionMatrix;
 using fformation::Timestamp;
 using fformation::Classification;
@@ -37,123 +39,20 @@ using fformation::PersonId;
 using fformation::Person;
 using fformation::Group;
 using fformation::IdGroup;
+using fformation::Option;
 using fformation::Options;
+using fformation::RotationDropout;
+using fformation::Trace;
+using fformation::Parallel;
+using fformation::Pipeline;
+using fformation::GroupDetector;
+using fformation::DetectionStats;
+using fformation::RunningStatistics;
+using fformation::QuantileSketch;
+using fformation::VisibilityModel;
 
-static Person withoutRotation(const Person &person) {
-  return Person(person.id(), {person.pose().position()});
-}
-
-std::map<PersonId, Person>
-removeAllRotations(const std::map<PersonId, Person> &group) {
-  std::map<PersonId, Person> result;
-  for (auto it : group) {
-    result.insert(std::make_pair(it.first, withoutRotation(it.second)));
-  }
-  return result;
-}
-
-template <bool ROTATION>
-static std::vector<Person>
-filterPersons(const std::map<PersonId, Person> &group) {
-  std::vector<Person> result;
-  for (auto it : group) {
-    if (it.second.pose().rotation() && ROTATION) {
-      result.push_back(it.second);
-    } else if (!it.second.pose().rotation() && !ROTATION) {
-      result.push_back(it.second);
-    }
-  }
-  return result;
-}
-
-static size_t howManyToRemove(size_t with_size, size_t without_size,
-                              double proportion) {
-  if (proportion >= 1.) {
-    return size_t(proportion);
-  } else {
-    // find out how many need to be removed to acchieve required proportion.
-    double remove =
-        double(with_size) - proportion * double(with_size + without_size);
-    if (remove <= 0.) {
-      return 0;
-    } else {
-      return std::round<size_t>(remove + 0.5); // always round up
-    }
-  }
-}
-
-static std::vector<Person> removeRotations(std::vector<Person> persons,
-                                           size_t num, size_t seed) {
-  std::mt19937 generator(seed);
-  std::shuffle(persons.begin(), persons.end(), generator);
-  if (num > persons.size()) {
-    num = persons.size();
-  }
-  for (size_t i = 0; i < num; ++i) {
-    persons[i] = withoutRotation(persons[i]);
-  }
-  return persons;
-}
-
-std::map<PersonId, Person>
-removeRandomRotations(const std::map<PersonId, Person> &group, double portion,
-                      size_t seed) {
-  auto with_rotations = filterPersons<true>(group);
-  auto without_rotations = filterPersons<false>(group);
-  auto filtered = removeRotations(
-      with_rotations,
-      howManyToRemove(with_rotations.size(), without_rotations.size(), portion),
-      seed);
-  std::map<PersonId, Person> result;
-  for (auto it : without_rotations) {
-    result.insert(std::make_pair(it.id(), it));
-  }
-  for (auto it : filtered) {
-    result.insert(std::make_pair(it.id(), it));
-  }
-  return result;
-}
-
-std::map<PersonId, Person>
-removeRandomRotationsGrouped(const std::vector<Group> &groups, double portion,
-                             size_t seed) {
-  std::map<PersonId, Person> result;
-  for (auto group : groups) {
-    auto filtered = removeRandomRotations(group.persons(), portion, seed);
-    result.insert(filtered.begin(), filtered.end());
-  }
-  return result;
-}
-
-static Observation modifyObservation(const Observation &o,
-                                     const Classification &gt,
-                                     const fformation::Options &options) {
-  std::string mod_by = options.getValueOr<std::string>(
-      "modify_rotations", "keep", fformation::validators::OneOf<std::string>(
-                                      {"keep", "remove", "group", "random"}));
-  if (mod_by == "keep") {
-    return o;
-  }
-  if (mod_by == "remove") {
-    return Observation(o.timestamp(), removeAllRotations(o.group().persons()));
-  }
-  double mod_part = options.getValue<double>(
-      "modify_proportion", fformation::validators::MinMax<double>(0., 1.));
-  size_t seed = options.getValueOr<size_t>("seed", 0);
-  if (mod_by == "group") {
-    return Observation(o.timestamp(), removeRandomRotationsGrouped(
-                                          gt.createGroups(o), mod_part, seed));
-  }
-  if (mod_by == "random") {
-    return Observation(o.timestamp(), removeRandomRotations(o.group().persons(),
-                                                            mod_part, seed));
-  }
-  throw fformation::Exception("Unknown config 'modify_rotations'='" + mod_by +
-                              "'");
-}
-
-static std::ostream &printMatlab(const Classification &cl, std::ostream &out,
-                                 bool all = false) {
+static BufferedWriter &printMatlab(const Classification &cl,
+                                   BufferedWriter &out, bool all = false) {
   for (auto group : cl.idGroups()) {
     if (group.persons().size() <= 1 && !all)
       continue;
@@ -169,183 +68,283 @@ static bool perfectMatch(const ConfusionMatrix &m) {
   return m.false_negative() == 0 && m.false_positive() == 0;
 }
 
-static const std::ostream &
-printMatlabOutput(std::ostream &out, Options &options,
-                  std::vector<Classification> &classifications,
-                  std::vector<Classification> &ground_truths,
-                  std::vector<ConfusionMatrix> &confusion_matrices) {
-  bool print_perfect_matches =
-      options.getValueOr<bool>("print_perfect_matches", true);
-  bool print_all_persons = options.getValueOr<bool>("print_all_persons", false);
-  bool print_confusion_matrix =
-      options.getValueOr<bool>("print_confusion_matrix", false);
-  assert(classifications.size() == confusion_matrices.size());
-  assert(ground_truths.size() == confusion_matrices.size());
-  for (size_t frame = 0; frame < classifications.size(); ++frame) {
-    if (print_perfect_matches || !perfectMatch(confusion_matrices[frame])) {
-      out << "Frame: " << frame + 1 << "/" << classifications.size() << "\n";
+static Evaluation::Printer
+createMatlabPrinter(const Evaluation::Parameters &parameters,
+                    const Evaluation::Summary &summary, const size_t &frames) {
+  bool print_perfect_matches = parameters.print_perfect_matches;
+  bool print_all_persons = parameters.print_all_persons;
+  bool print_confusion_matrix = parameters.print_confusion_matrix;
+  Evaluation::Printer printer;
+  printer.header = [](BufferedWriter &out) {};
+  printer.frame = [=, &frames](BufferedWriter &out, size_t frame,
+                               const Observation &observation,
+                               const Classification &ground_truth,
+                               const Classification &classification,
+                               const ConfusionMatrix &confusion_matrix) {
+    if (print_perfect_matches || !perfectMatch(confusion_matrix)) {
+      out << "Frame: " << frame + 1 << "/" << frames << "\n";
       out << "   FOUND:-- ";
-      printMatlab(classifications[frame], out, print_all_persons);
+      printMatlab(classification, out, print_all_persons);
       out << "\n";
       out << "   GT   :-- ";
-      printMatlab(ground_truths[frame], out, print_all_persons);
+      printMatlab(ground_truth, out, print_all_persons);
       out << "\n";
       if (print_confusion_matrix) {
-        out << "     TP: " << confusion_matrices[frame].true_positive() << "\n"
-            << "     FP: " << confusion_matrices[frame].false_positive() << "\n"
-            << "     TN: " << confusion_matrices[frame].true_negative() << "\n"
-            << "     FN: " << confusion_matrices[frame].false_negative() << "\n"
+        out << "     TP: " << confusion_matrix.true_positive() << "\n"
+            << "     FP: " << confusion_matrix.false_positive() << "\n"
+            << "     TN: " << confusion_matrix.true_negative() << "\n"
+            << "     FN: " << confusion_matrix.false_negative() << "\n"
             << "\n";
       }
     }
+  };
+  printer.footer = [&summary](BufferedWriter &out) {
+    auto precision = summary.precision.mean();
+    auto recall = summary.recall.mean();
+    out.precision(8).format(BufferedWriter::Format::Fixed);
+    out << "Average Precision: -- " << precision << "\n"
+        << "Average Recall: -- " << recall << "\n"
+        << "Average F1 score: -- "
+        << ConfusionMatrix::calculateF1Score(precision, recall) << "\n";
+    if (summary.quantiles) {
+      auto print_quantiles = [&out](const std::string &name,
+                                    const QuantileSketch &sketch) {
+        out << name << " quantiles (p10/p50/p90): -- " << sketch.quantile(0.1)
+            << " " << sketch.quantile(0.5) << " " << sketch.quantile(0.9)
+            << "\n";
+      };
+      print_quantiles("Precision", summary.precision_quantiles);
+      print_quantiles("Recall", summary.recall_quantiles);
+      print_quantiles("F1 score", summary.f1_quantiles);
+    }
+  };
+  return printer;
+}
+
+static BufferedWriter &
+printPrCurveOutput(BufferedWriter &out, const std::vector<double> &thresholds,
+                   const Evaluation::Summary &summary, std::string s = "\t") {
+  assert(thresholds.size() == summary.threshold_precision.size());
+  assert(thresholds.size() == summary.threshold_recall.size());
+  out << "threshold" << s << "precision" << s << "recall" << s << "f1"
+      << "\n";
+  for (size_t i = 0; i < thresholds.size(); ++i) {
+    auto precision = summary.threshold_precision[i].mean();
+    auto recall = summary.threshold_recall[i].mean();
+    out.precision(8).format(BufferedWriter::Format::Fixed);
+    out << thresholds[i] << s << precision << s << recall << s
+        << ConfusionMatrix::calculateF1Score(precision, recall) << "\n";
   }
-  auto precision = ConfusionMatrix::calculateMeanPrecision(confusion_matrices);
-  auto recall = ConfusionMatrix::calculateMeanRecall(confusion_matrices);
-  out << std::setprecision(8) << std::fixed << "Average Precision: -- "
-      << precision << "\n"
-      << "Average Recall: -- " << recall << "\n"
-      << "Average F1 score: -- "
-      << ConfusionMatrix::calculateF1Score(precision, recall) << std::endl;
   return out;
 }
 
-static std::ostream &printGoupLine(const Classification &cl,
-                                   std::ostream &out) {
+static void printDetectionStats(
+    BufferedWriter &out,
+    const std::vector<std::pair<std::string, Evaluation::Summary::Distribution>>
+        &detections,
+    std::string s = "\t") {
+  out << "stat" << s << "mean" << s << "p50" << s << "p90" << s << "p99" << s
+      << "max"
+      << "\n";
+  for (auto &column : detections) {
+    auto &statistics = column.second.statistics;
+    auto &quantiles = column.second.quantiles;
+    out.precision(8).format(BufferedWriter::Format::Fixed);
+    out << column.first << s << statistics.mean() << s
+        << quantiles.quantile(0.5) << s << quantiles.quantile(0.9) << s
+        << quantiles.quantile(0.99) << s << statistics.max() << "\n";
+  }
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(const Clock::time_point &begin,
+                      const Clock::time_point &end) {
+  return std::chrono::duration<double>(end - begin).count();
+}
+
+static void printTiming(BufferedWriter &out,
+                        const Evaluation::Summary &summary,
+                        std::string s = "\t") {
+  out << "stage" << s << "calls" << s << "total_seconds" << s << "mean_seconds"
+      << s << "items_per_second"
+      << "\n";
+  for (auto &stage : summary.stages) {
+    auto &seconds = stage.second.seconds;
+    out.precision(8).format(BufferedWriter::Format::Fixed);
+    out << stage.first << s << seconds.count() << s << seconds.sum() << s
+        << seconds.mean() << s << stage.second.items / seconds.sum() << "\n";
+  }
+  out << "\n";
+  out << "persons" << s << "frames" << s << "p50" << s << "p90" << s << "p99"
+      << s << "max"
+      << "\n";
+  for (auto &latencies : summary.detection_latencies) {
+    auto &quantiles = latencies.second.quantiles;
+    out.precision(8).format(BufferedWriter::Format::Fixed);
+    out << latencies.first << s << latencies.second.statistics.count() << s
+        << quantiles.quantile(0.5) << s << quantiles.quantile(0.9) << s
+        << quantiles.quantile(0.99) << s << latencies.second.statistics.max()
+        << "\n";
+  }
+}
+
+static std::vector<double> parseThresholds(const Option &option) {
+  std::vector<double> result;
+  boost::char_separator<char> separator(",");
+  boost::tokenizer<boost::char_separator<char>> tokens(option.value(),
+                                                       separator);
+  for (auto token : tokens) {
+    double threshold =
+        fformation::Option("thresholds", token)
+            .validate(fformation::validators::MinMax<double>(0., 1.));
+    result.push_back(threshold);
+  }
+  return result;
+}
+
+static BufferedWriter &printGoupLine(const Classification &cl,
+                                     BufferedWriter &out) {
   fformation::JsonSerializable::serializeIterable(out, cl.idGroups());
   return out;
 }
 
-static const std::ostream &
-printTsvOutput(std::ostream &out, std::vector<Classification> &classifications,
-               std::vector<Classification> &ground_truths,
-               std::vector<ConfusionMatrix> &confusion_matrices,
-               std::string s = "\t") {
-  // header
-  out << "id" << s;
-  out << "timestamp" << s;
-  out << "annotation" << s;
-  out << "classification" << s;
-  out << "tp" << s;
-  out << "fp" << s;
-  out << "tn" << s;
-  out << "fn" << s;
-  out << "\n";
-  // observations
-  for (size_t frame = 0; frame < classifications.size(); ++frame) {
+static Evaluation::Printer createTsvPrinter(std::string s = "\t") {
+  Evaluation::Printer printer;
+  printer.header = [s](BufferedWriter &out) {
+    out << "id" << s;
+    out << "timestamp" << s;
+    out << "annotation" << s;
+    out << "classification" << s;
+    out << "tp" << s;
+    out << "fp" << s;
+    out << "tn" << s;
+    out << "fn" << s;
+    out << "\n";
+  };
+  printer.frame = [s](BufferedWriter &out, size_t frame,
+                      const Observation &observation,
+                      const Classification &ground_truth,
+                      const Classification &classification,
+                      const ConfusionMatrix &confusion_matrix) {
     out << frame + 1 << s;
-    out << classifications[frame].timestamp() << s;
-    printGoupLine(ground_truths[frame], out);
+    out << classification.timestamp() << s;
+    printGoupLine(ground_truth, out);
     out << s;
-    printGoupLine(classifications[frame], out);
+    printGoupLine(classification, out);
     out << s;
-    out << confusion_matrices[frame].true_positive() << s
-        << confusion_matrices[frame].false_positive() << s
-        << confusion_matrices[frame].true_negative() << s
-        << confusion_matrices[frame].false_negative() << s;
+    out << confusion_matrix.true_positive() << s
+        << confusion_matrix.false_positive() << s
+        << confusion_matrix.true_negative() << s
+        << confusion_matrix.false_negative() << s;
     out << "\n";
+  };
+  printer.footer = [](BufferedWriter &out) {};
+  return printer;
+}
+
+// returns the IdGroup of the person
+static const Group &persons_group(PersonId pid,
+                                  const std::vector<Group> &groups) {
+  for (auto &g : groups) {
+    if (g.persons().find(pid) != g.persons().end()) {
+      return g;
+    }
   }
-  return out;
+  throw fformation::Exception("Person is not in groups");
+}
+
+// creates a confusion matrix for one pid and its group participants
+static ConfusionMatrix persons_cm(const PersonId &pid,
+                                  const std::vector<Person> &persons_in_frame,
+                                  const Group &cl, const Group &an) {
+  ConfusionMatrix::IntType tp = 0;
+  ConfusionMatrix::IntType fp = 0;
+  ConfusionMatrix::IntType tn = 0;
+  ConfusionMatrix::IntType fn = 0;
+  for (auto person : persons_in_frame) {
+    // if (person.id() != pid) {
+    bool in_cl = cl.persons().find(person.id()) != cl.persons().end();
+    bool in_an = an.persons().find(person.id()) != an.persons().end();
+    tp += (in_cl & in_an) ? 1 : 0;
+    fp += (in_cl & !in_an) ? 1 : 0;
+    tn += (!in_cl & !in_an) ? 1 : 0;
+    fn += (!in_cl & in_an) ? 1 : 0;
+    //}
+  }
+  return ConfusionMatrix(tp, fp, tn, fn);
 }
 
-static const std::ostream &printTsvParticipantsOutput(
-    std::ostream &out, const std::vector<Observation> &observations,
-    const std::vector<Classification> &classifications,
-    const std::vector<Classification> &ground_truths,
-    const std::vector<ConfusionMatrix> &confusion_matrices,
-    const Options &detector_options, const std::string s = "\t") {
-  assert(observations.size() == classifications.size());
-  assert(observations.size() == ground_truths.size());
-  assert(observations.size() == confusion_matrices.size());
-  // returns the IdGroup of the person
-  auto persons_group = [](PersonId pid,
-                          const std::vector<Group> &groups) -> Group {
-    for (auto g : groups) {
-      if (g.persons().find(pid) != g.persons().end()) {
-        return g;
+// create groups while ignoring persons missing from observation
+static std::vector<Group> generate_group_lists(const Classification &cl,
+                                               const Observation &ob) {
+  std::vector<Group> result;
+  for (auto idg : cl.idGroups()) {
+    std::vector<Person> persons;
+    for (auto pid : idg.persons()) {
+      auto it = ob.group().persons().find(pid);
+      if (it != ob.group().persons().end()) {
+        persons.push_back(it->second);
       }
     }
-    throw fformation::Exception("Person is not in groups");
-  };
-  // creates a confusion matrix for one pid and its group participants
-  auto persons_cm = [](const PersonId &pid,
-                       const std::vector<Person> &persons_in_frame,
-                       const Group &cl, const Group &an) -> ConfusionMatrix {
-    ConfusionMatrix::IntType tp = 0;
-    ConfusionMatrix::IntType fp = 0;
-    ConfusionMatrix::IntType tn = 0;
-    ConfusionMatrix::IntType fn = 0;
-    for (auto person : persons_in_frame) {
-      // if (person.id() != pid) {
-      bool in_cl = cl.persons().find(person.id()) != cl.persons().end();
-      bool in_an = an.persons().find(person.id()) != an.persons().end();
-      tp += (in_cl & in_an) ? 1 : 0;
-      fp += (in_cl & !in_an) ? 1 : 0;
-      tn += (!in_cl & !in_an) ? 1 : 0;
-      fn += (!in_cl & in_an) ? 1 : 0;
-      //}
+    if (!persons.empty()) {
+      result.push_back(Group(persons));
     }
-    return ConfusionMatrix(tp, fp, tn, fn);
-  };
-  // create groups while ignoring persons missing from observation
-  auto generate_group_lists = [](const Classification &cl,
-                                 const Observation &ob) -> std::vector<Group> {
-    std::vector<Group> result;
-    for (auto idg : cl.idGroups()) {
-      std::vector<Person> persons;
-      for (auto pid : idg.persons()) {
-        auto it = ob.group().persons().find(pid);
-        if (it != ob.group().persons().end()) {
-          persons.push_back(it->second);
-        }
-      }
-      if (!persons.empty()) {
-        result.push_back(Group(persons));
+  }
+  for (auto it : ob.group().persons()) {
+    auto pid = it.first;
+    auto person = it.second;
+    bool found = false;
+    for (auto g : result) {
+      if (g.has_person(pid)) {
+        found = true;
+        break;
       }
     }
-    for (auto it : ob.group().persons()) {
-      auto pid = it.first;
-      auto person = it.second;
-      bool found = false;
-      for (auto g : result) {
-        if (g.has_person(pid)) {
-          found = true;
-          break;
-        }
-      }
-      if (!found) {
-        result.push_back(Group(std::vector<Person>({person})));
-      }
+    if (!found) {
+      result.push_back(Group(std::vector<Person>({person})));
     }
-    return result;
-  };
-  // counts the persons that are in ground truth but not in observation
-  auto missing_persons = [](const PersonId &pid, const Classification &gt,
-                            const Observation &ob) -> size_t {
-    size_t result = 0;
-    for (auto idg : gt.idGroups()) {
-      if (idg.has_person(pid)) {
-        for (auto group_participant_id : idg.persons()) {
-          if (!ob.group().has_person(group_participant_id)) {
-            ++result;
-          }
+  }
+  return result;
+}
+
+// counts the persons that are in ground truth but not in observation
+static size_t missing_persons(const PersonId &pid, const Classification &gt,
+                              const Observation &ob) {
+  size_t result = 0;
+  for (auto idg : gt.idGroups()) {
+    if (idg.has_person(pid)) {
+      for (auto group_participant_id : idg.persons()) {
+        if (!ob.group().has_person(group_participant_id)) {
+          ++result;
         }
       }
     }
-    return result;
-  };
+  }
+  return result;
+}
+
+static Evaluation::Printer
+createTsvParticipantsPrinter(const Options &detector_options,
+                             const std::string s = "\t") {
   auto stride = detector_options.getValue<Person::Stride>("stride");
   auto mdl = detector_options.getValue<Person::Stride>("mdl");
-  out << "timestamp" << s << "pid" << s << "x" << s << "y" << s << "rad" << s
-      << "gt.group.size" << s << "cl.group.size" << s << "tp" << s << "fp" << s
-      << "tn" << s << "fn" << s << "cl.group.distance.cost" << s
-      << "cl.group.visibility.cost" << s << "mdl" << s << "stride"
-      << "\n";
-  for (size_t frame = 0; frame < classifications.size(); ++frame) {
-    const Observation &obs = observations[frame];
-    const Classification &gt = ground_truths[frame];
-    const Classification &cl = classifications[frame];
+  VisibilityModel visibility(
+      VisibilityModel::Parameters::parse(detector_options));
+  Evaluation::Printer printer;
+  printer.header = [s](BufferedWriter &out) {
+    out << "timestamp" << s << "pid" << s << "x" << s << "y" << s << "rad"
+        << s << "gt.group.size" << s << "cl.group.size" << s << "tp" << s
+        << "fp" << s << "tn" << s << "fn" << s << "cl.group.distance.cost"
+        << s << "cl.group.visibility.cost" << s << "mdl" << s << "stride"
+        << "\n";
+  };
+  printer.frame = [=](BufferedWriter &out, size_t frame,
+                      const Observation &obs, const Classification &gt,
+                      const Classification &cl,
+                      const ConfusionMatrix &confusion_matrix) {
     const auto person_list = obs.group().generatePersonList();
-    const auto ts = classifications[frame].timestamp();
+    const auto ts = cl.timestamp();
     const auto gt_groups = generate_group_lists(gt, obs);
     const auto cl_groups = generate_group_lists(cl, obs);
     for (auto person : person_list) {
@@ -371,70 +370,431 @@ static const std::ostream &printTsvParticipantsOutput(
       double visibility_cost = 0.;
       for (auto group_participant : cl_group_participants) {
         visibility_cost +=
-            person.calculateVisibilityCost(gc, group_participant);
+            person.calculateVisibilityCost(gc, group_participant, visibility);
       }
       out << visibility_cost << s << mdl << s << stride << "\n";
     }
+  };
+  printer.footer = [](BufferedWriter &out) {};
+  return printer;
+}
+
+void Evaluation::Summary::add(const std::vector<ConfusionMatrix> &matrices) {
+  assert(!matrices.empty());
+  assert(matrices.size() == threshold_precision.size() + 1);
+  auto precision_value = matrices.front().calculatePrecision();
+  auto recall_value = matrices.front().calculateRecall();
+  precision.add(precision_value);
+  recall.add(recall_value);
+  for (size_t i = 1; i < matrices.size(); ++i) {
+    threshold_precision[i - 1].add(matrices[i].calculatePrecision());
+    threshold_recall[i - 1].add(matrices[i].calculateRecall());
+  }
+  if (quantiles) {
+    precision_quantiles.add(precision_value);
+    recall_quantiles.add(recall_value);
+    auto f1 = ConfusionMatrix::calculateF1Score(precision_value, recall_value);
+    if (!std::isnan(f1)) {
+      f1_quantiles.add(f1);
+    }
   }
-  return out;
+}
+
+void Evaluation::Summary::add(const DetectionStats &stats) {
+  if (!detection_stats) {
+    return;
+  }
+  auto values = stats.values();
+  if (detections.empty()) {
+    for (auto &value : values) {
+      detections.push_back(std::make_pair(value.first, Distribution()));
+    }
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    detections[i].second.add(values[i].second);
+  }
+}
+
+void Evaluation::Summary::addStage(const std::string &name, double seconds,
+                                   double items, bool external) {
+  auto it = std::find_if(stages.begin(), stages.end(),
+                         [&name](const std::pair<std::string, Stage> &stage) {
+                           return stage.first == name;
+                         });
+  if (it == stages.end()) {
+    it = stages.insert(external ? stages.begin() + external_stages++
+                                : stages.end(),
+                       std::make_pair(name, Stage()));
+  }
+  it->second.seconds.add(seconds);
+  it->second.items += items;
+}
+
+void Evaluation::Summary::addLatency(size_t persons, double seconds) {
+  if (timing) {
+    detection_latencies[persons].add(seconds);
+  }
+}
+
+std::vector<double> Evaluation::Parameters::defaultThresholds() {
+  std::vector<double> result;
+  for (size_t i = 0; i <= 20; ++i) {
+    result.push_back(double(i) / 20.);
+  }
+  return result;
+}
+
+const fformation::OptionSchema<Evaluation::Parameters> &
+Evaluation::Parameters::schema() {
+  static const OptionSchema<Parameters> schema =
+      OptionSchema<Parameters>()
+          .optional("threshold", &Parameters::threshold,
+                    validators::Min<double>(0.))
+          .custom<std::vector<double>>("thresholds", &Parameters::thresholds,
+                                       parseThresholds)
+          .optional("evaluation_printer", &Parameters::printer)
+          .optional("streaming", &Parameters::streaming)
+          .optional("quantiles", &Parameters::quantiles)
+          .optional("detection_stats", &Parameters::detection_stats)
+          .optional("timing", &Parameters::timing)
+          .optional("print_perfect_matches",
+                    &Parameters::print_perfect_matches)
+          .optional("print_all_persons", &Parameters::print_all_persons)
+          .optional("print_confusion_matrix",
+                    &Parameters::print_confusion_matrix)
+          .optional("threads", &Parameters::threads)
+          .optional("begin_time", &Parameters::begin_time)
+          .optional("end_time", &Parameters::end_time)
+          .optional("result_log", &Parameters::result_log);
+  return schema;
+}
+
+Evaluation::Parameters Evaluation::Parameters::parse(const Options &options) {
+  Parameters result = schema().parse(options);
+  result.modification = RotationDropout::Parameters::parse(options);
+  // these printers need the per frame data
+  result.detection_stats |= result.printer == "detection_stats";
+  result.timing |= result.printer == "timing";
+  return result;
 }
 
 Evaluation::Evaluation(const Features &features,
                        const GroundTruth &ground_truth,
                        const Settings &settings, const GroupDetector &detector,
                        const Options &options)
-    : _options(options), _observations(features.observations()) {
+    : _parameters(Parameters::parse(options)) {
+  configure(&detector);
+  evaluate(features, ground_truth, detector, nullptr);
+}
+
+Evaluation::Evaluation(ResultLog::Reader &log, const Options &options)
+    : _parameters(Parameters::parse(options)) {
+  configure(nullptr);
+  replay(log);
+}
+
+Evaluation::Evaluation(const Features &features,
+                       const GroundTruth &ground_truth,
+                       const Settings &settings, const GroupDetector &detector,
+                       const Options &options, std::ostream &stream)
+    : _parameters(Parameters::parse(options)), _streaming(true) {
+  configure(&detector);
+  BufferedWriter writer(stream);
+  evaluate(features, ground_truth, detector, &writer);
+}
+
+Evaluation::Evaluation(const Features &features,
+                       const GroundTruth &ground_truth,
+                       const Settings &settings, const GroupDetector &detector,
+                       const Options &options, BufferedWriter &stream)
+    : _parameters(Parameters::parse(options)), _streaming(true) {
+  configure(&detector);
+  evaluate(features, ground_truth, detector, &stream);
+}
+
+void Evaluation::configure(const GroupDetector *detector) {
   // apply options
-  if (options.hasOption("threshold")) {
-    _threshold =
-        options.getOption("threshold").validate(validators::Min<double>(0.));
+  auto &thresholds = _parameters.thresholds;
+  if (!_streaming) {
+    _threshold_confusion_matrices.resize(thresholds.size());
   }
+  _summary.threshold_precision.resize(thresholds.size());
+  _summary.threshold_recall.resize(thresholds.size());
+  _summary.quantiles = _parameters.quantiles;
+  _summary.detection_stats = _parameters.detection_stats;
+  _summary.timing = _parameters.timing;
   // add printers
-  _printers["matlab"] = [this](std::ostream &out) -> const std::ostream & {
-    return printMatlabOutput(out, this->_options, this->_classifications,
-                             this->_ground_truths, this->_confusion_matrices);
+  _printers["matlab"] = createMatlabPrinter(_parameters, _summary, _frames);
+  _printers["tsv"] = createTsvPrinter();
+  // reads stride and mdl from the detector options, which only the EM
+  // detectors have, so it is only created when it is used
+  if (detector != nullptr && _parameters.printer == "tsv_participants") {
+    _printers["tsv_participants"] =
+        createTsvParticipantsPrinter(detector->options());
+  }
+  Printer pr_curve;
+  pr_curve.header = [](BufferedWriter &out) {};
+  pr_curve.frame = [](BufferedWriter &out, size_t frame, const Observation &o,
+                      const Classification &gt, const Classification &cl,
+                      const ConfusionMatrix &cm) {};
+  pr_curve.footer = [this](BufferedWriter &out) {
+    printPrCurveOutput(out, this->thresholds(), this->_summary);
   };
-  _printers["tsv"] = [this](std::ostream &out) -> const std::ostream & {
-    return printTsvOutput(out, this->_classifications, this->_ground_truths,
-                          this->_confusion_matrices);
+  _printers["pr_curve"] = pr_curve;
+  Printer detection_stats;
+  detection_stats.header = pr_curve.header;
+  detection_stats.frame = pr_curve.frame;
+  detection_stats.footer = [this](BufferedWriter &out) {
+    printDetectionStats(out, this->_summary.detections);
   };
-  auto detector_options = detector.options();
-  _printers["tsv_participants"] =
-      [this, detector_options](std::ostream &out) -> const std::ostream & {
-    return printTsvParticipantsOutput(
-        out, this->_observations, this->_classifications, this->_ground_truths,
-        this->_confusion_matrices, detector_options);
+  _printers["detection_stats"] = detection_stats;
+  Printer timing;
+  timing.header = pr_curve.header;
+  timing.frame = pr_curve.frame;
+  timing.footer = [this](BufferedWriter &out) {
+    printTiming(out, this->_summary);
   };
+  _printers["timing"] = timing;
+}
+
+/**
+ * A frame on its way through the evaluation. The detection related fields are
+ * filled by evaluateFrame, which may run concurrently for several frames.
+ */
+struct Evaluation::EvaluatedFrame {
+  const Observation *observation = nullptr;
+  const Classification *ground_truth = nullptr;
+  size_t persons = 0;
+  Classification classification;
+  std::vector<ConfusionMatrix> confusion_matrices;
+  DetectionStats stats;
+  double modify_seconds = 0.;
+  double detect_seconds = 0.;
+  double compare_seconds = 0.;
+  std::string error;
+};
+
+void Evaluation::evaluate(const Features &features,
+                          const GroundTruth &ground_truth,
+                          const GroupDetector &detector,
+                          BufferedWriter *stream) {
+  // pair the observations in the time range with their ground truth
+  auto &observations = features.observations();
+  auto ground_truths = ground_truth.findClassifications(observations);
+  std::vector<size_t> selected;
+  for (size_t i = 0; i < observations.size(); ++i) {
+    auto time = observations[i].timestamp().time();
+    if (ground_truths[i] != nullptr && time >= _parameters.begin_time &&
+        time <= _parameters.end_time) {
+      selected.push_back(i);
+    }
+  }
+  const Printer *frame_printer = nullptr;
+  if (stream != nullptr) {
+    // frames are printed before all of them are evaluated, so the matlab
+    // printer numbers them against the selected frames until the end
+    _frames = selected.size();
+    frame_printer = &printer();
+    frame_printer->header(*stream);
+  }
+  auto &thresholds = _parameters.thresholds;
+  std::vector<double> all_thresholds = {_parameters.threshold};
+  all_thresholds.insert(all_thresholds.end(), thresholds.begin(),
+                        thresholds.end());
+  std::unique_ptr<ResultLog::Writer> log;
+  if (!_parameters.result_log.empty()) {
+    // the curve is cheap to re-score from the groups, keep the log small
+    log.reset(new ResultLog::Writer(_parameters.result_log,
+                                    _parameters.threshold, {}));
+  }
   // do the evaluation
   size_t counter = 0;
-  for (auto obs : features.observations()) {
+  auto next = [&](EvaluatedFrame &frame) {
+    if (counter == selected.size()) {
+      return false;
+    }
+    size_t position = selected[counter];
     if ((++counter % 100) == 0) {
       std::cerr << "processing observation #" << counter << " of #"
-                << features.observations().size() << " ("
-                << counter * 100. / (double)features.observations().size()
-                << "%)" << std::endl;
+                << selected.size() << " ("
+                << counter * 100. / (double)selected.size() << "%)"
+                << std::endl;
+    }
+    frame = EvaluatedFrame();
+    frame.observation = &observations[position];
+    frame.ground_truth = ground_truths[position];
+    return true;
+  };
+  size_t index = 0;
+  auto collect = [&](EvaluatedFrame &frame) {
+    try {
+      Exception::check(frame.error.empty(), frame.error);
+      collectFrame(frame, index, frame_printer, stream, log.get());
+      ++index;
+    } catch (const Exception &e) {
+      std::cerr << "Classification failed: " << e.what() << std::endl;
     }
-    const Classification *gt = ground_truth.findClassification(obs.timestamp());
+  };
+  size_t threads = (_parameters.threads == 0) ? Parallel::defaultThreads()
+                                              : _parameters.threads;
+  if (threads == 1) {
+    EvaluatedFrame frame;
+    while (next(frame)) {
+      evaluateFrame(frame, detector, all_thresholds);
+      collect(frame);
+    }
+  } else {
+    // every worker owns a detector, so detectors with scratch state work too
+    std::vector<GroupDetector::Ptr> detectors;
+    for (size_t i = 0; i < threads; ++i) {
+      detectors.push_back(detector.clone());
+    }
+    Pipeline<EvaluatedFrame, EvaluatedFrame> pipeline(threads, 16 * threads);
+    pipeline.run(next,
+                 [&](EvaluatedFrame &frame, size_t worker) {
+                   evaluateFrame(frame, *detectors[worker], all_thresholds);
+                   return std::move(frame);
+                 },
+                 collect);
+  }
+  // frames that failed are not counted
+  _frames = index;
+}
+
+void Evaluation::evaluateFrame(EvaluatedFrame &frame,
+                               const GroupDetector &detector,
+                               const std::vector<double> &thresholds) const {
+  auto &obs = *frame.observation;
+  auto &gt = *frame.ground_truth;
+  try {
+    Trace::Scope scope("frame", "evaluation",
+                       {{"timestamp", obs.timestamp().time()}});
+    auto start = Clock::now();
+    auto observation =
+        RotationDropout::modify(obs, gt, _parameters.modification);
+    auto modified = Clock::now();
+    // the stage timings are measured here, the detector only times its
+    // steps when the stats are kept
+    frame.stats.timed = _parameters.detection_stats;
+    frame.classification = detector.detect(observation, frame.stats);
+    auto detected = Clock::now();
+    frame.confusion_matrices =
+        frame.classification.createConfusionMatrices(gt, thresholds);
+    auto compared = Clock::now();
+    frame.persons = observation.size();
+    frame.modify_seconds = seconds(start, modified);
+    frame.detect_seconds = seconds(modified, detected);
+    frame.compare_seconds = seconds(detected, compared);
+  } catch (const Exception &e) {
+    frame.error = e.what();
+  }
+}
+
+void Evaluation::collectFrame(const EvaluatedFrame &frame, size_t index,
+                              const Printer *printer,
+                              BufferedWriter *stream,
+                              ResultLog::Writer *log) {
+  auto &cfs = frame.confusion_matrices;
+  _summary.add(frame.stats);
+  _summary.add(cfs);
+  _summary.addStage("modify", frame.modify_seconds);
+  _summary.addStage("detect", frame.detect_seconds);
+  _summary.addStage("confusion_matrix", frame.compare_seconds);
+  _summary.addLatency(frame.persons, frame.detect_seconds);
+  if (log != nullptr) {
+    log->write(*frame.ground_truth, frame.classification, {cfs.front()},
+               _parameters.detection_stats ? &frame.stats : nullptr);
+  }
+  if (printer != nullptr) {
+    auto start = Clock::now();
+    printer->frame(*stream, index, *frame.observation, *frame.ground_truth,
+                   frame.classification, cfs.front());
+    _summary.addStage("print", seconds(start, Clock::now()));
+  } else {
+    keepFrame(*frame.observation, *frame.ground_truth, frame.classification,
+              cfs);
+  }
+}
+
+void Evaluation::keepFrame(
+    const Observation &observation, const Classification &ground_truth,
+    const Classification &classification,
+    const std::vector<ConfusionMatrix> &confusion_matrices) {
+  _observations.push_back(observation);
+  _ground_truths.push_back(ground_truth);
+  _classifications.push_back(classification);
+  _confusion_matrices.push_back(confusion_matrices.front());
+  for (size_t i = 0; i + 1 < confusion_matrices.size(); ++i) {
+    _threshold_confusion_matrices[i].push_back(confusion_matrices[i + 1]);
+  }
+}
+
+void Evaluation::replay(ResultLog::Reader &log) {
+  auto &thresholds = _parameters.thresholds;
+  std::vector<double> all_thresholds = {_parameters.threshold};
+  all_thresholds.insert(all_thresholds.end(), thresholds.begin(),
+                        thresholds.end());
+  bool rescore = log.threshold() != _parameters.threshold;
+  bool rescore_curve = log.thresholds() != thresholds;
+  ResultLog::Frame frame;
+  while (log.next(frame)) {
+    auto start = Clock::now();
+    if (rescore) {
+      frame.confusion_matrices = frame.classification.createConfusionMatrices(
+          frame.ground_truth, all_thresholds);
+    } else if (rescore_curve) {
+      auto curve = frame.classification.createConfusionMatrices(
+          frame.ground_truth, thresholds);
+      frame.confusion_matrices.resize(1);
+      frame.confusion_matrices.insert(frame.confusion_matrices.end(),
+                                      curve.begin(), curve.end());
+    }
+    if (rescore || rescore_curve) {
+      _summary.addStage("confusion_matrix", seconds(start, Clock::now()));
+    }
+    if (frame.stats) {
+      _summary.add(*frame.stats);
+      _summary.addStage("detect", frame.stats->total_seconds);
+      _summary.addLatency(frame.stats->persons, frame.stats->total_seconds);
+    }
+    _summary.add(frame.confusion_matrices);
+    keepFrame(Observation(frame.ground_truth.timestamp()), frame.ground_truth,
+              frame.classification, frame.confusion_matrices);
+  }
+  _frames = _classifications.size();
+}
+
+std::vector<Evaluation::Frame>
+Evaluation::prepareFrames(const Features &features,
+                          const GroundTruth &ground_truth,
+                          const Options &options) {
+  auto modification = RotationDropout::Parameters::parse(options);
+  std::vector<Frame> result;
+  result.reserve(features.observations().size());
+  auto ground_truths =
+      ground_truth.findClassifications(features.observations());
+  for (size_t i = 0; i < ground_truths.size(); ++i) {
+    auto &obs = features.observations()[i];
+    const Classification *gt = ground_truths[i];
     if (gt != nullptr) {
       try {
-        auto observation = modifyObservation(obs, *gt, options);
-        auto cl = detector.detect(observation);
-        auto cf = cl.createConfusionMatrix(*gt, _threshold);
-        _ground_truths.push_back(*gt);
-        _classifications.push_back(cl);
-        _confusion_matrices.push_back(cf);
+        result.push_back(
+            std::make_pair(RotationDropout::modify(obs, *gt, modification),
+                           *gt));
       } catch (const Exception &e) {
-        std::cerr << "Classification failed: " << e.what() << std::endl;
+        std::cerr << "Observation modification failed: " << e.what()
+                  << std::endl;
       }
     }
   }
+  return result;
 }
-const std::ostream &Evaluation::printOutput(std::ostream &out) const {
-  std::string printer_name =
-      _options.getValueOr<std::string>("evaluation_printer", "matlab");
-  auto callback = _printers.find(printer_name);
-  if (callback != _printers.end()) {
-    return callback->second(out);
+
+const Evaluation::Printer &Evaluation::printer() const {
+  const std::string &printer_name = _parameters.printer;
+  auto it = _printers.find(printer_name);
+  if (it != _printers.end()) {
+    return it->second;
   } else {
     std::stringstream err;
     err << "Could not find an output_printer with name = '" << printer_name
@@ -445,3 +805,22 @@ const std::ostream &Evaluation::printOutput(std::ostream &out) const {
     throw Exception(err.str());
   }
 }
+
+const std::ostream &Evaluation::printOutput(std::ostream &out) const {
+  BufferedWriter writer(out);
+  printOutput(writer);
+  return out;
+}
+
+BufferedWriter &Evaluation::printOutput(BufferedWriter &out) const {
+  const Printer &p = printer();
+  if (!_streaming) {
+    p.header(out);
+    for (size_t frame = 0; frame < _classifications.size(); ++frame) {
+      p.frame(out, frame, _observations[frame], _ground_truths[frame],
+              _classifications[frame], _confusion_matrices[frame]);
+    }
+  }
+  p.footer(out);
+  return out;
+}
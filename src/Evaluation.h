@@ -16,21 +16,205 @@
 ********************************************************************/
 
 #pragma once
+#include "BufferedWriter.h"
 #include "ConfusionMatrix.h"
 #include "Features.h"
 #include "GroundTruth.h"
 #include "GroupDetector.h"
 #include "Options.h"
+#include "ResultLog.h"
+#include "RotationDropout.h"
+#include "RunningStatistics.h"
 #include "Settings.h"
+#include <functional>
+#include <limits>
 
 namespace fformation {
 
 class Evaluation {
 public:
+  /**
+   * @brief Frame an observation paired with its ground truth.
+   *
+   * The observation is already modified according to the evaluation options
+   * (modify_rotations, modify_proportion, seed).
+   */
+  typedef std::pair<Observation, Classification> Frame;
+
+  /**
+   * @brief Parameters the evaluation options, parsed and validated once.
+   *
+   *   * threshold: the group intersection threshold of a true positive
+   *   * thresholds: comma separated thresholds of the precision/recall curve
+   *   * evaluation_printer: matlab | tsv | tsv_participants | pr_curve |
+   *     detection_stats | timing
+   *   * streaming: print frames as soon as they are evaluated (used by the
+   *     evaluation app to choose the constructor)
+   *   * quantiles, detection_stats, timing: collect additional aggregates
+   *   * print_perfect_matches, print_all_persons, print_confusion_matrix:
+   *     configure the matlab printer
+   *   * modify_rotations, modify_proportion, seed: see RotationDropout
+   *   * threads: the number of detection threads. With more than one thread
+   *     frames are evaluated in a Pipeline and collected in input order, so
+   *     the results do not depend on it. 0 uses all cores.
+   *   * begin_time, end_time: only evaluate observations with a timestamp in
+   *     [begin_time, end_time]
+   *   * result_log: write the results of every frame to this ResultLog file.
+   *     Only the confusion matrix of threshold is stored, the DetectionStats
+   *     are included when detection_stats is set.
+   */
+  struct Parameters {
+    double threshold = 2. / 3.;
+    std::vector<double> thresholds = defaultThresholds();
+    std::string printer = "matlab";
+    bool streaming = false;
+    bool quantiles = false;
+    bool detection_stats = false;
+    bool timing = false;
+    bool print_perfect_matches = true;
+    bool print_all_persons = false;
+    bool print_confusion_matrix = false;
+    size_t threads = 1;
+    double begin_time = -std::numeric_limits<double>::infinity();
+    double end_time = std::numeric_limits<double>::infinity();
+    std::string result_log;
+    RotationDropout::Parameters modification;
+
+    static std::vector<double> defaultThresholds();
+    static const OptionSchema<Parameters> &schema();
+    static Parameters parse(const Options &options);
+  };
+
+  /**
+   * @brief Summary running aggregates over all evaluated frames.
+   *
+   * The precision and recall statistics belong to the main threshold. The
+   * quantile sketches are only filled when the 'quantiles' option is set.
+   * The distribution of every DetectionStats value is only aggregated when
+   * the 'detection_stats' option is set or the detection_stats printer is
+   * used. The stage timings
+   * are always measured, the detection latencies per person count are only
+   * kept when the 'timing' option is set or the timing printer is used.
+   */
+  struct Summary {
+    /**
+     * @brief Stage the wall time of every call of an evaluation stage and the
+     * number of processed items.
+     */
+    struct Stage {
+      RunningStatistics seconds;
+      double items = 0.;
+    };
+
+    /**
+     * @brief Distribution the exact mean and maximum and the approximate
+     * percentiles of a stream of values, in constant memory.
+     */
+    struct Distribution {
+      RunningStatistics statistics;
+      RelativeQuantileSketch quantiles;
+
+      void add(double value) {
+        statistics.add(value);
+        quantiles.add(value);
+      }
+    };
+
+    RunningStatistics precision;
+    RunningStatistics recall;
+    std::vector<RunningStatistics> threshold_precision;
+    std::vector<RunningStatistics> threshold_recall;
+    bool quantiles = false;
+    QuantileSketch precision_quantiles;
+    QuantileSketch recall_quantiles;
+    QuantileSketch f1_quantiles;
+    bool detection_stats = false;
+    /// one distribution per entry of DetectionStats::values()
+    std::vector<std::pair<std::string, Distribution>> detections;
+    std::vector<std::pair<std::string, Stage>> stages;
+    /// the number of leading stages of work done outside of the evaluation
+    size_t external_stages = 0;
+    bool timing = false;
+    std::map<size_t, Distribution> detection_latencies;
+
+    /**
+     * @brief add aggregates the confusion matrices of a frame. The first
+     * matrix belongs to the main threshold, the others to thresholds().
+     */
+    void add(const std::vector<ConfusionMatrix> &matrices);
+
+    /**
+     * @brief add aggregates the stats of a detection if detection_stats is
+     * set.
+     */
+    void add(const DetectionStats &stats);
+
+    /**
+     * @brief addStage adds a call of a stage. Stages are kept in the order of
+     * their first call, except that external stages come before all others.
+     */
+    void addStage(const std::string &name, double seconds, double items = 1.,
+                  bool external = false);
+
+    /**
+     * @brief addLatency aggregates the detection time of a frame with the
+     * passed number of persons if timing is set.
+     */
+    void addLatency(size_t persons, double seconds);
+  };
+
+  /**
+   * @brief Printer prints the header, a single frame and the summary of an
+   * evaluation.
+   */
+  struct Printer {
+    std::function<void(BufferedWriter &)> header;
+    std::function<void(BufferedWriter &, size_t frame, const Observation &,
+                       const Classification &ground_truth,
+                       const Classification &classification,
+                       const ConfusionMatrix &)>
+        frame;
+    std::function<void(BufferedWriter &)> footer;
+  };
+
   Evaluation(const Features &features, const GroundTruth &ground_truth,
              const Settings &settings, const GroupDetector &detector,
              const Options &options = Options());
 
+  /**
+   * @brief Evaluation evaluates in streaming mode.
+   *
+   * Every frame is written to stream by the configured evaluation_printer as
+   * soon as it is evaluated. Only the running aggregates of summary() are
+   * kept, so memory does not grow with the number of frames.
+   * classifications(), groundTruths() and confusionMatrices() stay empty and
+   * printOutput only prints the final summary of the printer. As failing
+   * frames are not known in advance, the matlab printer numbers the streamed
+   * frames against the number of selected frames.
+   */
+  Evaluation(const Features &features, const GroundTruth &ground_truth,
+             const Settings &settings, const GroupDetector &detector,
+             const Options &options, std::ostream &stream);
+
+  /**
+   * @brief Evaluation evaluates in streaming mode and writes to a
+   * BufferedWriter, e.g. one writing directly to a file descriptor.
+   */
+  Evaluation(const Features &features, const GroundTruth &ground_truth,
+             const Settings &settings, const GroupDetector &detector,
+             const Options &options, BufferedWriter &stream);
+
+  /**
+   * @brief Evaluation replays a ResultLog instead of detecting groups.
+   *
+   * The stored confusion matrices are used when threshold and thresholds
+   * match the log, the others are re-scored from the stored groups.
+   * Observations are not part of the log, so the printers see empty
+   * observations and tsv_participants is not available. The timing printer
+   * only reports the stored detection times.
+   */
+  Evaluation(ResultLog::Reader &log, const Options &options = Options());
+
   const std::vector<Classification> classifications() const {
     return _classifications;
   }
@@ -40,17 +224,87 @@ public:
   const std::vector<ConfusionMatrix> confusionMatrices() const {
     return _confusion_matrices;
   }
+  /**
+   * @brief thresholds the intersection thresholds of the precision/recall
+   * curve. Configured through the 'thresholds' option as a comma separated
+   * list. Defaults to 0, 0.05, ..., 1.
+   */
+  const std::vector<double> &thresholds() const {
+    return _parameters.thresholds;
+  }
+  /**
+   * @brief thresholdConfusionMatrices the per frame confusion matrices for
+   * every entry of thresholds().
+   */
+  const std::vector<std::vector<ConfusionMatrix>> &
+  thresholdConfusionMatrices() const {
+    return _threshold_confusion_matrices;
+  }
+  /**
+   * @brief frames the number of evaluated frames. Frames that failed to be
+   * modified or classified are not counted.
+   */
+  size_t frames() const { return _frames; }
+  const Summary &summary() const { return _summary; }
+  const Parameters &parameters() const { return _parameters; }
+
+  /**
+   * @brief addStage reports the time of work done outside of the evaluation
+   * (e.g. loading the dataset) to the timing printer. It is listed before
+   * the stages of the evaluation, even though it is reported after them.
+   */
+  void addStage(const std::string &name, double seconds, double items = 1.) {
+    _summary.addStage(name, seconds, items, true);
+  }
+
   const std::ostream &printOutput(std::ostream &out) const;
+  BufferedWriter &printOutput(BufferedWriter &out) const;
+
+  /**
+   * @brief prepareFrames pairs every observation with its ground truth and
+   * applies the observation modifications requested by options.
+   *
+   * Observations without ground truth and observations that cannot be
+   * modified are skipped. The result does not depend on detector options and
+   * may be shared by multiple detector runs.
+   *
+   * @param features the observations to evaluate
+   * @param ground_truth the annotations of the observations
+   * @param options evaluation options
+   * @return the prepared frames in observation order
+   */
+  static std::vector<Frame> prepareFrames(const Features &features,
+                                          const GroundTruth &ground_truth,
+                                          const Options &options = Options());
 
 private:
-  double _threshold = 2. / 3.;
-  Options _options;
+  struct EvaluatedFrame;
+
+  void configure(const GroupDetector *detector);
+  void replay(ResultLog::Reader &log);
+  void evaluate(const Features &features, const GroundTruth &ground_truth,
+                const GroupDetector &detector, BufferedWriter *stream);
+  void evaluateFrame(EvaluatedFrame &frame, const GroupDetector &detector,
+                     const std::vector<double> &thresholds) const;
+  void collectFrame(const EvaluatedFrame &frame, size_t index,
+                    const Printer *printer, BufferedWriter *stream,
+                    ResultLog::Writer *log);
+  void keepFrame(const Observation &observation,
+                 const Classification &ground_truth,
+                 const Classification &classification,
+                 const std::vector<ConfusionMatrix> &confusion_matrices);
+  const Printer &printer() const;
+
+  Parameters _parameters;
+  bool _streaming = false;
+  size_t _frames = 0;
+  Summary _summary;
   std::vector<Observation> _observations;
   std::vector<Classification> _classifications;
   std::vector<Classification> _ground_truths;
   std::vector<ConfusionMatrix> _confusion_matrices;
-  std::map<std::string, std::function<const std::ostream &(std::ostream &)>>
-      _printers;
+  std::vector<std::vector<ConfusionMatrix>> _threshold_confusion_matrices;
+  std::map<std::string, Printer> _printers;
 };
 
 } // namespace fformation
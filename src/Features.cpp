@@ -122,6 +122,34 @@ Features Features::readMatlabJson(const std::string &filename) {
   return Features(observations, readFov(js));
 }
 
+Observation Features::readObservationJson(const Json &js) {
+  Exception::check(js.is_object(),
+                   "Observation must be an object. Got: " + js.dump());
+  auto timestamp = js.find("timestamp");
+  Exception::check(timestamp != js.end() && timestamp.value().is_number(),
+                   "Observation needs a numeric timestamp. Got: " + js.dump());
+  Group group;
+  auto persons = js.find("persons");
+  if (persons != js.end() && !persons.value().empty()) {
+    std::vector<Person> result;
+    result.reserve(persons.value().size());
+    try {
+      for (auto &person : persons.value()) {
+        result.push_back(readPerson(person));
+      }
+    } catch (const Exception &) {
+      throw;
+    } catch (const std::exception &e) {
+      // the json library reports wrongly typed values as std exceptions
+      throw Exception("Invalid persons in observation: " +
+                      std::string(e.what()));
+    }
+    group = Group(result);
+  }
+  return Observation(Timestamp((Timestamp::TimestampType)timestamp.value()),
+                     group);
+}
+
 void Features::serializeJson(std::ostream &out) const {
   out << "{ \"fov\": " << _fov << ", \"observations\": ";
   serializeIterable(out, _observations);
@@ -17,6 +17,7 @@
 
 #pragma once
 #include "FoV.h"
+#include "JsonReader.h"
 #include "JsonSerializable.h"
 #include "Observation.h"
 
@@ -36,6 +37,13 @@ public:
 
   static Features readMatlabJson(const std::string &filename);
 
+  /**
+   * @brief readObservationJson reads a single observation of the form
+   * { "timestamp": t, "persons": [ [id, x, y, rotation], ... ] }. Persons use
+   * the format of the matlab features, the rotation is optional.
+   */
+  static Observation readObservationJson(const Json &json);
+
 private:
   std::vector<Observation> _observations;
   FoV _fov;
@@ -22,6 +22,9 @@
 using fformation::GroundTruth;
 using fformation::JsonReader;
 using fformation::Timestamp;
+using fformation::TimestampIndex;
+using fformation::Classification;
+using fformation::Observation;
 using fformation::Json;
 using fformation::Exception;
 using fformation::Group;
@@ -38,7 +41,8 @@ static std::vector<IdGroup> readGroups(const Json &js) {
                    "Array of arrays expected. Got: " + js.dump());
   for (auto group : js) {
     Exception::check(group.is_array(), "Array expected. Got: " + group.dump());
-    std::set<PersonId> persons;
+    IdGroup::Persons persons;
+    persons.reserve(group.size());
     for (auto pid : group) {
       if (pid.is_number()) {
         double val = pid.get<double>();
@@ -51,7 +55,7 @@ static std::vector<IdGroup> readGroups(const Json &js) {
         throw Exception("Person id type must be string or numeric.");
       }
     }
-    result.push_back(persons);
+    result.push_back(IdGroup(std::move(persons)));
   }
   return result;
 }
@@ -96,29 +100,79 @@ GroundTruth GroundTruth::readMatlabJson(const std::string &filename) {
   return GroundTruth(classifications);
 }
 
+fformation::Classification GroundTruth::readClassificationJson(const Json &js) {
+  Exception::check(js.is_object(),
+                   "Classification must be an object. Got: " + js.dump());
+  auto timestamp = js.find("timestamp");
+  Exception::check(timestamp != js.end() && timestamp.value().is_number(),
+                   "Classification needs a numeric timestamp. Got: " +
+                       js.dump());
+  auto groups = js.find("groups");
+  Exception::check(groups != js.end(),
+                   "Classification needs groups. Got: " + js.dump());
+  return Classification(
+      Timestamp((Timestamp::TimestampType)timestamp.value()),
+      readGroups(groups.value()));
+}
+
 void GroundTruth::serializeJson(std::ostream &out) const {
   serializeIterable(out, _classifications);
 }
 
+static std::vector<Timestamp>
+timestamps(const std::vector<Classification> &classifications) {
+  std::vector<Timestamp> result;
+  result.reserve(classifications.size());
+  for (auto &cl : classifications) {
+    result.push_back(cl.timestamp());
+  }
+  return result;
+}
+
 GroundTruth::GroundTruth(const std::vector<Classification> &classifications)
     : _classifications(classifications) {
-  for (size_t i = 0; i < classifications.size(); ++i) {
-    auto &cl = classifications[i];
-    if (_classification_positions.find(cl.timestamp()) !=
-        _classification_positions.end()) {
-      throw Exception("Ground truth cannot contain multiple classifications "
-                      "with the same timestamp.");
-    }
-    _classification_positions[cl.timestamp()] = i;
+  try {
+    _index = TimestampIndex(timestamps(classifications));
+  } catch (const Exception &) {
+    throw Exception("Ground truth cannot contain multiple classifications "
+                    "with the same timestamp.");
   }
 }
 
 const fformation::Classification *
 GroundTruth::findClassification(const Timestamp &timestamp) const {
-  auto it = _classification_positions.find(timestamp);
-  if (it == _classification_positions.end()) {
+  size_t position = _index.find(timestamp);
+  if (position == TimestampIndex::npos) {
     return nullptr;
   } else {
-    return &_classifications[it->second];
+    return &_classifications[position];
   }
 }
+
+std::vector<const fformation::Classification *>
+GroundTruth::findClassifications(
+    const std::vector<Observation> &observations) const {
+  std::vector<Timestamp> queries;
+  queries.reserve(observations.size());
+  for (auto &obs : observations) {
+    queries.push_back(obs.timestamp());
+  }
+  std::vector<const Classification *> result;
+  result.reserve(observations.size());
+  for (auto position : _index.match(queries)) {
+    result.push_back(position == TimestampIndex::npos
+                         ? nullptr
+                         : &_classifications[position]);
+  }
+  return result;
+}
+
+std::vector<const fformation::Classification *>
+GroundTruth::classificationsBetween(const Timestamp &begin,
+                                    const Timestamp &end) const {
+  std::vector<const Classification *> result;
+  for (auto position : _index.range(begin, end)) {
+    result.push_back(&_classifications[position]);
+  }
+  return result;
+}
@@ -18,8 +18,11 @@
 #pragma once
 #include "Classification.h"
 #include "Group.h"
+#include "JsonReader.h"
 #include "JsonSerializable.h"
+#include "Observation.h"
 #include "Person.h"
+#include "TimestampIndex.h"
 #include <vector>
 
 namespace fformation {
@@ -40,13 +43,34 @@ public:
   */
   const Classification *findClassification(const Timestamp &timestamp) const;
 
+  /**
+   * @brief findClassifications finds the Classification of every
+   * observation. Time sorted observations are paired in one merge join.
+   * @return a pointer per observation, nullptr where none can be found
+   */
+  std::vector<const Classification *>
+  findClassifications(const std::vector<Observation> &observations) const;
+
+  /**
+   * @brief classificationsBetween the classifications with a timestamp in
+   * [begin, end] in time order.
+   */
+  std::vector<const Classification *>
+  classificationsBetween(const Timestamp &begin, const Timestamp &end) const;
+
   virtual void serializeJson(std::ostream &out) const override;
 
   static GroundTruth readMatlabJson(const std::string &filename);
 
+  /**
+   * @brief readClassificationJson reads a single annotation of the form
+   * { "timestamp": t, "groups": [ [id, ...], ... ] }.
+   */
+  static Classification readClassificationJson(const Json &json);
+
 private:
   std::vector<Classification> _classifications;
-  std::map<Timestamp, size_t> _classification_positions;
+  TimestampIndex _index;
 };
 
 } // namespace fformation
@@ -17,12 +17,16 @@
 
 #include "Group.h"
 #include "Exception.h"
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <iostream>
 #include <sstream>
 
+using fformation::BasicPerson;
+using fformation::BasicPosition2D;
 using fformation::Group;
+using fformation::IdGroup;
 using fformation::Person;
 using fformation::PersonId;
 using fformation::Position2D;
@@ -30,24 +34,46 @@ using fformation::RotationRadian;
 using fformation::Settings;
 using fformation::Exception;
 
-static std::map<PersonId, Person>
-vector_to_map(const std::vector<Person> &persons) {
-  std::map<PersonId, Person> result;
-  for (auto p : persons) {
-    result.insert(std::pair<PersonId, Person>(p.id(), p));
+static Group::Persons vector_to_map(const std::vector<Person> &persons) {
+  // sort once instead of inserting into the middle of the flat map, the
+  // first of several persons with the same id wins as in std::map::insert
+  Group::Persons::sequence_type sorted;
+  sorted.reserve(persons.size());
+  for (auto &p : persons) {
+    sorted.emplace_back(p.id(), p);
   }
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const std::pair<PersonId, Person> &a,
+                      const std::pair<PersonId, Person> &b) {
+                     return a.first < b.first;
+                   });
+  sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                           [](const std::pair<PersonId, Person> &a,
+                              const std::pair<PersonId, Person> &b) {
+                             return a.first == b.first;
+                           }),
+               sorted.end());
+  Group::Persons result;
+  result.adopt_sequence(boost::container::ordered_unique_range,
+                        std::move(sorted));
   return result;
 }
 
 Group::Group(const std::vector<Person> &persons)
     : _persons(vector_to_map(persons)) {}
 
-Group::Group(const std::map<PersonId, Person> &persons) : _persons(persons) {}
+Group::Group(const std::map<PersonId, Person> &persons)
+    : _persons(boost::container::ordered_unique_range, persons.begin(),
+               persons.end()) {}
 
 void Group::serializeJson(std::ostream &out) const {
   serializeMapAsVector(out, _persons);
 }
 
+void Group::serializeJson(BufferedWriter &out) const {
+  serializeMapAsVector(out, _persons);
+}
+
 #if 0
 static Position2D calculateCenter(const Position2D &a_pos,
                                   const RotationRadian &a_rot,
@@ -194,55 +220,80 @@ Position2D Group::calculateCenter(const std::vector<Person> &persons,
   return center.get();
 }
 #else
-static Position2D calculateTS(const Person &p, Person::Stride stride) {
+template <typename Scalar>
+static BasicPosition2D<Scalar>
+calculateTS(const BasicPerson<Scalar> &p,
+            typename BasicPerson<Scalar>::Stride stride) {
   if (p.pose().rotation()) {
-    return Person::calculateTransactionalSegmentPosition(
+    return BasicPerson<Scalar>::calculateTransactionalSegmentPosition(
         p.pose().position(), p.pose().rotation().get(), stride);
   } else {
     return p.pose().position();
   }
 }
-Position2D Group::calculateCenter(const std::vector<Person> &persons,
-                                  Person::Stride stride) {
+
+template <typename Scalar>
+BasicPosition2D<Scalar>
+Group::calculateCenter(const std::vector<BasicPerson<Scalar>> &persons,
+                       typename BasicPerson<Scalar>::Stride stride) {
   // edge cases
   if (persons.empty()) {
     throw Exception("Cannot calculate center of an empty group.");
   }
-  Position2D result(0., 0.);
-  for (auto p : persons) {
+  BasicPosition2D<Scalar> result(0., 0.);
+  for (auto &p : persons) {
     auto ppos = calculateTS(p, stride);
     result = result + ppos;
   }
-  result = result / persons.size();
+  result = result / Scalar(persons.size());
   return result;
 }
+
+template fformation::Position2D
+Group::calculateCenter(const std::vector<Person> &persons,
+                       Person::Stride stride);
+template fformation::BasicPosition2D<float>
+Group::calculateCenter(const std::vector<BasicPerson<float>> &persons,
+                       BasicPerson<float>::Stride stride);
 #endif
 
 Position2D Group::calculateCenter(Person::Stride stride) const {
   return calculateCenter(generatePersonList(), stride);
 }
 
-std::map<PersonId, Person>
-Group::find_persons(std::set<PersonId> person_ids) const {
-  std::map<PersonId, Person> result;
-  for (auto id : person_ids) {
-    auto it = _persons.find(id);
-    if (it == _persons.end()) {
+template <typename Ids>
+static Group::Persons findPersons(const Group::Persons &persons,
+                                  const Ids &ids) {
+  // ids are sorted, so every person is appended to the end
+  Group::Persons result;
+  result.reserve(ids.size());
+  for (auto &id : ids) {
+    auto it = persons.find(id);
+    if (it == persons.end()) {
       std::stringstream str;
       str << "Person with id " << id << " could not be found.";
       throw Exception(str.str());
     }
-    result.insert({id, _persons.find(id)->second});
+    result.insert(result.end(), *it);
   }
   return result;
 }
 
+Group::Persons
+Group::find_persons(const std::set<PersonId> &person_ids) const {
+  return findPersons(_persons, person_ids);
+}
+
+Group::Persons Group::find_persons(const IdGroup &person_ids) const {
+  return findPersons(_persons, person_ids.persons());
+}
+
 double Group::calculateDistanceCosts(Person::Stride stride) const {
   if (_persons.size() < 2)
     return 0.; // empty groups and groups of 1 person have zero costs.
   double cost = 0.;
   Position2D group_center = calculateCenter(stride);
-  for (auto group_entry : _persons) {
+  for (auto &group_entry : _persons) {
     cost += group_entry.second.calculateDistanceCosts(group_center, stride);
   }
   return cost;
@@ -251,16 +302,17 @@ double Group::calculateDistanceCosts(Person::Stride stride) const {
 std::vector<Person> Group::generatePersonList() const {
   std::vector<Person> result;
   result.reserve(_persons.size());
-  for (auto person : _persons) {
+  for (auto &person : _persons) {
     result.push_back(person.second);
   }
   return result;
 }
 
-fformation::IdGroup Group::generatIdGroup() const {
-  std::set<PersonId> persons;
-  for (auto p : _persons) {
-    persons.insert(p.first);
+IdGroup Group::generatIdGroup() const {
+  IdGroup::Persons persons;
+  persons.reserve(_persons.size());
+  for (auto &p : _persons) {
+    persons.insert(persons.end(), p.first);
   }
-  return IdGroup(persons);
+  return IdGroup(std::move(persons));
 }
@@ -20,6 +20,10 @@
 #include "Person.h"
 #include "Position.h"
 #include "Settings.h"
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
+#include <boost/container/small_vector.hpp>
+#include <initializer_list>
 #include <map>
 #include <set>
 #include <vector>
@@ -28,19 +32,49 @@ namespace fformation {
 
 class IdGroup;
 
+/**
+ * @brief inline_group_size groups of up to this many persons are stored
+ * inline. Larger ones, like the group of all persons of an observation, use
+ * the heap.
+ */
+static const size_t inline_group_size = 6;
+
 class Group : public JsonSerializable {
 public:
-  Group(
-      const std::map<PersonId, Person> &persons = std::map<PersonId, Person>());
+  /**
+   * @brief Persons a map sorted by id, stored in a contiguous small buffer.
+   */
+  typedef boost::container::flat_map<
+      PersonId, Person, std::less<PersonId>,
+      boost::container::small_vector<std::pair<PersonId, Person>,
+                                     inline_group_size>>
+      Persons;
+
+  Group() = default;
+  Group(const std::map<PersonId, Person> &persons);
   Group(const std::vector<Person> &persons);
+  Group(Persons persons) : _persons(std::move(persons)) {}
 
   Position2D calculateCenter(Person::Stride stride) const;
-  static Position2D calculateCenter(const std::vector<Person> &persons,
-                                    Person::Stride stride);
 
-  const std::map<PersonId, Person> &persons() const { return _persons; }
+  /**
+   * @brief calculateCenter the mean transactional segment of persons in the
+   * precision of Scalar. Instantiated for double and float.
+   * @throws Exception if persons is empty
+   */
+  template <typename Scalar>
+  static BasicPosition2D<Scalar>
+  calculateCenter(const std::vector<BasicPerson<Scalar>> &persons,
+                  typename BasicPerson<Scalar>::Stride stride);
 
-  std::map<PersonId, Person> find_persons(std::set<PersonId> person_ids) const;
+  const Persons &persons() const { return _persons; }
+
+  /**
+   * @brief find_persons the persons with the passed ids.
+   * @throws Exception if a person is not part of this group
+   */
+  Persons find_persons(const std::set<PersonId> &person_ids) const;
+  Persons find_persons(const IdGroup &person_ids) const;
 
   bool has_person(const PersonId id) const {
     return _persons.find(id) != _persons.end();
@@ -62,16 +96,29 @@ public:
   double calculateDistanceCosts(Person::Stride stride) const;
 
   virtual void serializeJson(std::ostream &out) const override;
+  virtual void serializeJson(BufferedWriter &out) const override;
 
 private:
-  std::map<PersonId, Person> _persons;
+  Persons _persons;
 };
 
 class IdGroup : public JsonSerializable {
 public:
-  IdGroup(const std::set<PersonId> &persons) : _persons(persons){};
+  /**
+   * @brief Persons a set of ids stored in a contiguous small buffer.
+   */
+  typedef boost::container::flat_set<
+      PersonId, std::less<PersonId>,
+      boost::container::small_vector<PersonId, inline_group_size>>
+      Persons;
 
-  const std::set<PersonId> &persons() const { return _persons; }
+  IdGroup(const std::set<PersonId> &persons)
+      : _persons(boost::container::ordered_unique_range, persons.begin(),
+                 persons.end()){};
+  IdGroup(Persons persons) : _persons(std::move(persons)){};
+  IdGroup(std::initializer_list<PersonId> persons) : _persons(persons){};
+
+  const Persons &persons() const { return _persons; }
 
   bool has_person(const PersonId id) const {
     return _persons.find(id) != _persons.end();
@@ -80,9 +127,12 @@ public:
   virtual void serializeJson(std::ostream &out) const override {
     serializeIterable(out, _persons);
   }
+  virtual void serializeJson(BufferedWriter &out) const override {
+    serializeIterable(out, _persons);
+  }
 
 private:
-  std::set<PersonId> _persons;
+  Persons _persons;
 };
 
 } // namespace fformation
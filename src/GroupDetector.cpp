@@ -23,17 +23,29 @@
 using fformation::GroupDetector;
 using fformation::Observation;
 using fformation::Classification;
+using fformation::DetectionStats;
 namespace fv = fformation::validators;
 
+Classification GroupDetector::detect(const Observation &observation,
+                                     DetectionStats &stats) const {
+  DetectionStats::Stopwatch stopwatch(stats.total_seconds, stats.timed);
+  stats.persons = observation.size();
+  stats.converged = true;
+  return detect(observation);
+}
+
 Classification
 fformation::OneGroupDetector::detect(const Observation &observation) const {
   std::vector<IdGroup> groups;
-  if(!observation.group().persons().empty()){
-    std::set<PersonId> group;
-    for (auto person : observation.group().persons()) {
-      group.insert(person.first);
+  if(observation.size() != 0){
+    IdGroup::Persons group;
+    group.reserve(observation.size());
+    // only the ids are needed, so iterate the person map instead of copying
+    // every person into a list
+    for (auto &person : observation.group().persons()) {
+      group.insert(group.end(), person.first);
     }
-    groups.push_back(group);
+    groups.push_back(IdGroup(std::move(group)));
   }
   return Classification(observation.timestamp(), groups);
 }
@@ -41,7 +53,8 @@ fformation::OneGroupDetector::detect(const Observation &observation) const {
 Classification
 fformation::NonGroupDetector::detect(const Observation &observation) const {
   std::vector<IdGroup> groups;
-  for (auto person : observation.group().persons()) {
+  groups.reserve(observation.size());
+  for (auto &person : observation.group().persons()) {
     groups.push_back(IdGroup({person.first}));
   }
   return Classification(observation.timestamp(), groups);
@@ -17,40 +17,77 @@
 
 #pragma once
 #include "Classification.h"
+#include "DetectionStats.h"
 #include "Observation.h"
 #include "Options.h"
 #include <memory>
 
 namespace fformation {
 
+/**
+ * @brief GroupDetector detects the groups of an observation.
+ *
+ * The configuration of a detector is immutable after construction and shared
+ * between clones. detect is const and the detectors of this library may be
+ * called concurrently. Detectors that keep scratch state between calls must
+ * not be shared between threads, use a GroupDetectorPool to give every worker
+ * its own clone instead.
+ */
 class GroupDetector {
 public:
   typedef std::unique_ptr<GroupDetector> Ptr;
 
-  GroupDetector(const Options &options) : _options(options) {}
+  GroupDetector(const Options &options)
+      : _options(std::make_shared<const Options>(options)) {}
 
   virtual ~GroupDetector() = default;
 
   virtual Classification detect(const Observation &observation) const = 0;
 
-  const Options &options() const { return _options; }
+  /**
+   * @brief detect additionally describes the work done in stats.
+   *
+   * The default implementation only measures the total time and the number
+   * of persons. Detectors that iterate override it.
+   */
+  virtual Classification detect(const Observation &observation,
+                                DetectionStats &stats) const;
+
+  /**
+   * @brief clone creates a detector with the same configuration and its own
+   * scratch state.
+   */
+  virtual Ptr clone() const = 0;
+
+  const Options &options() const { return *_options; }
+
+protected:
+  GroupDetector(const GroupDetector &other) = default;
 
 private:
-  Options _options;
+  std::shared_ptr<const Options> _options;
 };
 
 class OneGroupDetector : public GroupDetector {
 public:
   OneGroupDetector() : GroupDetector(Options()) {}
 
+  using GroupDetector::detect;
+
   virtual Classification detect(const Observation &observation) const final;
+
+  virtual Ptr clone() const final { return Ptr(new OneGroupDetector(*this)); }
 };
 
 class NonGroupDetector : public GroupDetector {
 public:
   NonGroupDetector() : GroupDetector(Options()) {}
 
+  using GroupDetector::detect;
+
   virtual Classification detect(const Observation &observation) const final;
+
+  virtual Ptr clone() const final { return Ptr(new NonGroupDetector(*this)); }
 };
 
 } // namespace fformation
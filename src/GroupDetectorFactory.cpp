@@ -26,6 +26,18 @@ using fformation::GroupDetector;
 using fformation::Exception;
 using fformation::Options;
 
+/// creates the double (default) or the float instance of an EM detector
+template <template <typename> class Detector>
+static GroupDetector::Ptr createEM(const Options &opt) {
+  std::string precision = opt.getValueOr<std::string>(
+      "precision", "double",
+      fformation::validators::OneOf<std::string>({"double", "float"}));
+  if (precision == "float") {
+    return GroupDetector::Ptr(new Detector<float>(opt));
+  }
+  return GroupDetector::Ptr(new Detector<double>(opt));
+}
+
 GroupDetectorFactory fillDefault() {
   GroupDetectorFactory fac;
   fac.addDetector("one", [](const Options &opt) {
@@ -35,13 +47,13 @@ GroupDetectorFactory fillDefault() {
     return GroupDetector::Ptr(new fformation::NonGroupDetector());
   });
   fac.addDetector("grow", [](const Options &opt) {
-    return GroupDetector::Ptr(new fformation::GroupDetectorGrow(opt));
+    return createEM<fformation::BasicGroupDetectorGrow>(opt);
   });
   fac.addDetector("shrink", [](const Options &opt) {
-    return GroupDetector::Ptr(new fformation::GroupDetectorShrink(opt));
+    return createEM<fformation::BasicGroupDetectorShrink>(opt);
   });
   fac.addDetector("shrink2", [](const Options &opt) {
-    return GroupDetector::Ptr(new fformation::GroupDetectorShrink2(opt));
+    return createEM<fformation::BasicGroupDetectorShrink2>(opt);
   });
   return fac;
 }
@@ -77,6 +89,17 @@ GroupDetector::Ptr GroupDetectorFactory::create(const std::string &name,
   return it->second(options);
 }
 
+fformation::GroupDetectorPool::Ptr
+GroupDetectorFactory::createPool(const std::string &config) const {
+  return std::make_shared<GroupDetectorPool>(create(config));
+}
+
+fformation::GroupDetectorPool::Ptr
+GroupDetectorFactory::createPool(const std::string &name,
+                                 const Options &options) const {
+  return std::make_shared<GroupDetectorPool>(create(name, options));
+}
+
 GroupDetectorFactory &
 GroupDetectorFactory::addDetector(const std::string &name,
                                   const ConstructorFunction &constructor) {
@@ -17,6 +17,7 @@
 
 #pragma once
 #include "GroupDetector.h"
+#include "GroupDetectorPool.h"
 #include "Options.h"
 #include <functional>
 #include <memory>
@@ -36,6 +37,15 @@ public:
   GroupDetector::Ptr create(const std::string &name,
                             const Options &options) const;
 
+  /**
+   * @brief createPool creates a pool of detectors sharing the configuration
+   * of a single prototype. Use it to run one detector per worker thread.
+   */
+  GroupDetectorPool::Ptr createPool(const std::string &config) const;
+
+  GroupDetectorPool::Ptr createPool(const std::string &name,
+                                    const Options &options) const;
+
   GroupDetectorFactory &addDetector(const std::string &name,
                                     const ConstructorFunction &constructor);
 
@@ -0,0 +1,70 @@
+/********************************************************************
+**                                                                 **
+** File   : src/GroupDetectorPool.cpp                              **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "GroupDetectorPool.h"
+#include "Exception.h"
+
+using fformation::GroupDetectorPool;
+using fformation::GroupDetector;
+using fformation::Exception;
+
+GroupDetectorPool::Lease::Lease(GroupDetectorPool &pool,
+                                GroupDetector::Ptr detector)
+    : _pool(&pool), _detector(std::move(detector)) {}
+
+GroupDetectorPool::Lease::~Lease() {
+  if (_detector) {
+    _pool->giveBack(std::move(_detector));
+  }
+}
+
+GroupDetectorPool::GroupDetectorPool(GroupDetector::Ptr prototype)
+    : _prototype(std::move(prototype)) {
+  Exception::check(_prototype != nullptr,
+                   "A detector pool needs a prototype detector.");
+}
+
+GroupDetectorPool::Lease GroupDetectorPool::checkout() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_idle.empty()) {
+      GroupDetector::Ptr detector = std::move(_idle.back());
+      _idle.pop_back();
+      return Lease(*this, std::move(detector));
+    }
+  }
+  // cloning may be expensive, do it outside of the lock
+  Lease lease(*this, _prototype->clone());
+  std::lock_guard<std::mutex> lock(_mutex);
+  ++_clones;
+  return lease;
+}
+
+size_t GroupDetectorPool::clones() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _clones;
+}
+
+size_t GroupDetectorPool::idle() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _idle.size();
+}
+
+void GroupDetectorPool::giveBack(GroupDetector::Ptr detector) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _idle.push_back(std::move(detector));
+}
@@ -0,0 +1,92 @@
+/********************************************************************
+**                                                                 **
+** File   : src/GroupDetectorPool.h                                **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "GroupDetector.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief GroupDetectorPool hands out clones of a prototype detector to
+ * concurrent workers.
+ *
+ * Every checked out detector is used by a single thread only, so detectors may
+ * keep scratch state without locking. Returned detectors are reused by later
+ * checkouts, so at most as many clones exist as were checked out at the same
+ * time. Only checkout and return synchronize, detection itself does not.
+ */
+class GroupDetectorPool {
+public:
+  typedef std::shared_ptr<GroupDetectorPool> Ptr;
+
+  /**
+   * @brief Lease a checked out detector. It is returned to the pool on
+   * destruction. The pool must outlive its leases.
+   */
+  class Lease {
+  public:
+    Lease(Lease &&other) = default;
+    Lease &operator=(Lease &&other) = delete;
+    ~Lease();
+
+    GroupDetector &operator*() const { return *_detector; }
+    GroupDetector *operator->() const { return _detector.get(); }
+
+  private:
+    friend class GroupDetectorPool;
+    Lease(GroupDetectorPool &pool, GroupDetector::Ptr detector);
+
+    GroupDetectorPool *_pool;
+    GroupDetector::Ptr _detector;
+  };
+
+  GroupDetectorPool(GroupDetector::Ptr prototype);
+
+  GroupDetectorPool(const GroupDetectorPool &) = delete;
+  GroupDetectorPool &operator=(const GroupDetectorPool &) = delete;
+
+  /**
+   * @brief checkout returns an idle detector or a new clone of the prototype
+   * if all detectors are in use. Thread safe.
+   */
+  Lease checkout();
+
+  const GroupDetector &prototype() const { return *_prototype; }
+
+  /**
+   * @brief clones the number of detectors created by this pool.
+   */
+  size_t clones() const;
+
+  /**
+   * @brief idle the number of detectors waiting for a checkout.
+   */
+  size_t idle() const;
+
+private:
+  void giveBack(GroupDetector::Ptr detector);
+
+  const GroupDetector::Ptr _prototype;
+  mutable std::mutex _mutex;
+  std::vector<GroupDetector::Ptr> _idle;
+  size_t _clones = 0;
+};
+
+} // namespace fformation
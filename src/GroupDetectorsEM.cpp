@@ -16,98 +16,87 @@
 ********************************************************************/
 
 #include "GroupDetectorsEM.h"
+#include "Trace.h"
 #include <algorithm>
 #include <assert.h>
-#include <iostream>
-
-//#define PRINT_CALCULATIONS
-
-#ifndef PRINT_CALCULATIONS
-#define LOG(x)
-#else
-#define LOG(x) std::cerr << __FILE__ "[" << __LINE__ << "]: " << x
-#endif
-
-#ifndef PRINT_CALCULATIONS
-#define LOG_COSTS(x, old_sum, new_sum, old_cost_matrix, new_cost_matrix)
-#else
-#define LOG_COSTS(x, old_sum, new_sum, old_cost_matrix, new_cost_matrix)       \
-  LOG("COSTS:");                                                               \
-  std::cerr << x << ": ts: " << observation.timestamp()                        \
-            << " iteration: " << count << " old cost: " << old_sum             \
-            << " new cost: " << new_sum << "\n";                               \
-  std::cerr << "assignment: ";                                                 \
-  if (old_sum > new_sum) {                                                     \
-    std::cerr << "new\n";                                                      \
-  } else {                                                                     \
-    std::cerr << "old\n";                                                      \
-  }                                                                            \
-  auto classification =                                                        \
-      (old_sum > new_sum)                                                      \
-          ? createClassification(observation.timestamp(), persons,             \
-                                 findBestAssignment(new_cost_matrix))          \
-          : createClassification(observation.timestamp(), persons,             \
-                                 findBestAssignment(old_cost_matrix));         \
-  for (auto g : classification.createGroups(observation, true)) {              \
-    auto center = g.calculateCenter(_stride);                                  \
-    std::cerr << "    - " << g.calculateDistanceCosts(_stride) << "\n";        \
-    for (auto p : g.persons()) {                                               \
-      auto cost = p.second.calculateDistanceCosts(center, _stride);            \
-      double vcost = 0.;                                                       \
-      for (auto o : persons) {                                                 \
-        vcost += p.second.calculateVisibilityCost(center, o);                  \
-      }                                                                        \
-      std::cerr << "        - " << p.first << " - " << cost << " - " << vcost; \
-      if (cost > _mdl && new_sum >= old_sum) {                                 \
-        std::cerr << " single cost higher than mdl\n";                         \
-      } else {                                                                 \
-        std::cerr << "\n";                                                     \
-      }                                                                        \
-    }                                                                          \
-  }                                                                            \
-  std::cerr << std::endl;
-#endif
+
+static void traceIteration(const char *name, size_t iteration,
+                           double old_cost, double new_cost, size_t centers) {
+  fformation::Trace::instant(name, "em", {{"iteration", double(iteration)},
+                                          {"old_cost", old_cost},
+                                          {"new_cost", new_cost},
+                                          {"centers", double(centers)}});
+}
 
 using fformation::Observation;
 using fformation::Classification;
+using fformation::Trace;
+using fformation::DetectionStats;
+using fformation::VisibilityModel;
 namespace fv = fformation::validators;
 
-fformation::GroupDetectorGrow::GroupDetectorGrow(const Options &options)
-    : GroupDetector(options),
-      _mdl(options.getOption("mdl").validate(fv::Min<double>(0.))),
-      _stride(options.getOption("stride").validate(fv::Min<double>(0.))) {}
+const fformation::OptionSchema<fformation::EMOptions> &
+fformation::EMOptions::schema() {
+  static const OptionSchema<EMOptions> schema =
+      OptionSchema<EMOptions>()
+          .required("mdl", &EMOptions::mdl, fv::Min<double>(0.))
+          .required("stride", &EMOptions::stride, fv::Min<double>(0.));
+  return schema;
+}
+
+fformation::EMOptions fformation::EMOptions::parse(const Options &options) {
+  EMOptions result = schema().parse(options);
+  result.visibility =
+      VisibilityModel(VisibilityModel::Parameters::parse(options));
+  return result;
+}
+
+template <typename Scalar>
+fformation::BasicGroupDetectorGrow<Scalar>::BasicGroupDetectorGrow(
+    const Options &options)
+    : GroupDetector(options), _parameters(EMOptions::parse(options)) {}
 
 typedef size_t GroupNum;
 typedef size_t PersonNum;
-struct Assignment {
+template <typename Scalar> struct Assignment {
   PersonNum person_pos;
   GroupNum group_pos;
-  double costs;
+  Scalar costs;
 
   Assignment() : person_pos(0), group_pos(0), costs(max()) {}
-  Assignment(PersonNum person, GroupNum group, double cost)
+  Assignment(PersonNum person, GroupNum group, Scalar cost)
       : person_pos(person), group_pos(group), costs(cost) {}
 
-  static double max() { return std::numeric_limits<double>::max(); }
-  static double min() { return 0.; }
+  static Scalar max() { return std::numeric_limits<Scalar>::max(); }
+  static Scalar min() { return 0.; }
 };
 
-typedef std::multimap<double, Assignment, std::less<double>> AssignmentCosts;
+template <typename Scalar>
+using AssignmentCosts =
+    std::multimap<Scalar, Assignment<Scalar>, std::less<Scalar>>;
 
+using fformation::BasicPerson;
+using fformation::BasicPosition2D;
 using fformation::Person;
-using fformation::Position2D;
-static AssignmentCosts
-calculateAssignmentCosts(const std::vector<Person> &persons,
-                         const std::vector<Position2D> &centers,
-                         const Person::Stride stride) {
-  AssignmentCosts result;
+template <typename Scalar>
+static AssignmentCosts<Scalar>
+calculateAssignmentCosts(const std::vector<BasicPerson<Scalar>> &persons,
+                         const std::vector<BasicPosition2D<Scalar>> &centers,
+                         const Scalar stride,
+                         const VisibilityModel &visibility,
+                         fformation::DetectionStats &stats) {
+  stats.cost_evaluations += persons.size() * centers.size();
+  stats.visibility_evaluations +=
+      persons.size() * centers.size() * persons.size();
+  AssignmentCosts<Scalar> result;
   for (PersonNum p = 0; p < persons.size(); ++p) {
     for (GroupNum g = 0; g < centers.size(); ++g) {
-      const Person &person = persons[p];
-      Assignment assign(p, g, Assignment::min());
+      const BasicPerson<Scalar> &person = persons[p];
+      Assignment<Scalar> assign(p, g, Assignment<Scalar>::min());
       assign.costs += person.calculateDistanceCosts(centers[g], stride);
       for (PersonNum p2 = 0; p2 < persons.size(); ++p2) {
-        assign.costs += person.calculateVisibilityCost(centers[g], persons[p2]);
+        assign.costs +=
+            person.calculateVisibilityCost(centers[g], persons[p2], visibility);
       }
       result.insert(std::make_pair(assign.costs, assign));
     }
@@ -115,38 +104,43 @@ calculateAssignmentCosts(const std::vector<Person> &persons,
   return result;
 }
 
-static AssignmentCosts findBestAssignment(const AssignmentCosts costs) {
-  std::map<PersonNum, Assignment> best_assignment;
+template <typename Scalar>
+static AssignmentCosts<Scalar>
+findBestAssignment(const AssignmentCosts<Scalar> costs) {
+  std::map<PersonNum, Assignment<Scalar>> best_assignment;
   for (auto it = costs.rbegin(); it != costs.rend(); ++it) {
     best_assignment[it->second.person_pos] = it->second;
   }
-  AssignmentCosts result;
+  AssignmentCosts<Scalar> result;
   for (auto it : best_assignment) {
     result.insert(std::make_pair(it.second.costs, it.second));
   }
   return result;
 }
 
-static double sumCosts(const AssignmentCosts &costs, const double &mdl) {
+template <typename Scalar>
+static Scalar sumCosts(const AssignmentCosts<Scalar> &costs,
+                       const Scalar &mdl) {
   std::set<GroupNum> groups;
-  double sum = 0.;
+  Scalar sum = 0.;
   for (auto it : costs) {
     sum += it.first;
     groups.insert(it.second.group_pos);
   }
   if (groups.empty()) {
-    return std::numeric_limits<double>::max();
+    return std::numeric_limits<Scalar>::max();
   } else {
-    return sum + double(groups.size()) * mdl;
+    return sum + Scalar(groups.size()) * mdl;
   }
 }
 
-static Position2D
-calculateTransactionalSegmentPosition(const Person &person,
-                                      const Person::Stride &stride) {
+template <typename Scalar>
+static BasicPosition2D<Scalar>
+calculateTransactionalSegmentPosition(const BasicPerson<Scalar> &person,
+                                      const Scalar &stride) {
   if (person.pose().rotation()) {
     // use thepersons transactional space
-    return Person::calculateTransactionalSegmentPosition(
+    return BasicPerson<Scalar>::calculateTransactionalSegmentPosition(
         person.pose().position(), person.pose().rotation().get(), stride);
   } else {
     // the mean of the persons possible ts-centers is its position
@@ -154,9 +148,12 @@ calculateTransactionalSegmentPosition(const Person &person,
   }
 }
 
-static std::vector<Position2D> proposeNewCenters(
-    const AssignmentCosts &costs, const std::vector<Position2D> &groups,
-    const std::vector<Person> &persons, const Person::Stride &stride) {
+template <typename Scalar>
+static std::vector<BasicPosition2D<Scalar>>
+proposeNewCenters(const AssignmentCosts<Scalar> &costs,
+                  const std::vector<BasicPosition2D<Scalar>> &groups,
+                  const std::vector<BasicPerson<Scalar>> &persons,
+                  const Scalar &stride) {
   if (groups.empty()) {
     // initially create a mean group center for a single group
     return {fformation::Group::calculateCenter(persons, stride)};
@@ -164,16 +161,18 @@ static std::vector<Position2D> proposeNewCenters(
     // just add a new group for the max-cost person
     auto result = groups;
     auto best_assignment = findBestAssignment(costs);
-    const Person &max = persons[best_assignment.rbegin()->second.person_pos];
+    const BasicPerson<Scalar> &max =
+        persons[best_assignment.rbegin()->second.person_pos];
     result.push_back(calculateTransactionalSegmentPosition(max, stride));
     return result;
   }
 }
 
-static std::map<GroupNum, std::vector<Person>>
-createGroups(const AssignmentCosts &assignment,
-             const std::vector<Person> &persons) {
-  std::map<GroupNum, std::vector<Person>> result;
+template <typename Scalar>
+static std::map<GroupNum, std::vector<BasicPerson<Scalar>>>
+createGroups(const AssignmentCosts<Scalar> &assignment,
+             const std::vector<BasicPerson<Scalar>> &persons) {
+  std::map<GroupNum, std::vector<BasicPerson<Scalar>>> result;
   for (auto assign : assignment) {
     result[assign.second.group_pos].push_back(
         persons[assign.second.person_pos]);
@@ -181,13 +180,14 @@ createGroups(const AssignmentCosts &assignment,
   return result;
 }
 
-static std::vector<Position2D> updateCenters(const std::vector<Position2D> old,
-                                             const std::vector<Person> &persons,
-                                             const AssignmentCosts &assignment,
-                                             const Person::Stride &stride) {
-  std::map<GroupNum, std::vector<Person>> groups =
+template <typename Scalar>
+static std::vector<BasicPosition2D<Scalar>>
+updateCenters(const std::vector<BasicPosition2D<Scalar>> old,
+              const std::vector<BasicPerson<Scalar>> &persons,
+              const AssignmentCosts<Scalar> &assignment, const Scalar &stride) {
+  std::map<GroupNum, std::vector<BasicPerson<Scalar>>> groups =
       createGroups(assignment, persons);
-  std::vector<Position2D> result;
+  std::vector<BasicPosition2D<Scalar>> result;
   result.reserve(groups.size());
   for (auto group : groups) {
     result.push_back(fformation::Group::calculateCenter(group.second, stride));
@@ -195,21 +195,32 @@ static std::vector<Position2D> updateCenters(const std::vector<Position2D> old,
   return result;
 }
 
-static AssignmentCosts optimizeCenters(std::vector<Position2D> &centers,
-                                       const std::vector<Person> &persons,
-                                       const Person::Stride &stride) {
-  auto assign = calculateAssignmentCosts(persons, centers, stride);
+template <typename Scalar>
+static AssignmentCosts<Scalar>
+optimizeCenters(std::vector<BasicPosition2D<Scalar>> &centers,
+                const std::vector<BasicPerson<Scalar>> &persons,
+                const Scalar &stride, const VisibilityModel &visibility,
+                fformation::DetectionStats &stats) {
+  fformation::DetectionStats::Stopwatch stopwatch(stats.em_seconds,
+                                                  stats.timed);
+  auto assign = calculateAssignmentCosts(persons, centers, stride, visibility,
+                                         stats);
   auto best_assign = findBestAssignment(assign);
-  double costs = sumCosts(best_assign, 0.);
+  Scalar costs = sumCosts(best_assign, Scalar(0.));
   size_t count = 0;
   while (++count) {
+    ++stats.em_iterations;
     // E
     auto new_centers = updateCenters(centers, persons, best_assign, stride);
     // M
-    auto new_assign = calculateAssignmentCosts(persons, new_centers, stride);
+    auto new_assign =
+        calculateAssignmentCosts(persons, new_centers, stride, visibility,
+                                 stats);
     auto new_best_assign = findBestAssignment(new_assign);
-    double new_costs =
-        sumCosts(new_best_assign, 0.); // mdl not important in this case
+    Scalar new_costs =
+        sumCosts(new_best_assign, Scalar(0.)); // mdl not important in this case
+    traceIteration("optimize_centers", count, costs, new_costs,
+                   new_centers.size());
     if (new_costs < costs) {           // loop
       costs = new_costs;
       assign = new_assign;
@@ -222,54 +233,100 @@ static AssignmentCosts optimizeCenters(std::vector<Position2D> &centers,
   return assign;
 }
 
+template <typename Scalar>
 static Classification
 createClassification(const fformation::Timestamp &timestamp,
-                     const std::vector<Person> &persons,
-                     const AssignmentCosts &costs) {
+                     const std::vector<BasicPerson<Scalar>> &persons,
+                     const AssignmentCosts<Scalar> &costs) {
   using fformation::IdGroup;
-  using fformation::PersonId;
   auto groups = createGroups(costs, persons);
   std::vector<IdGroup> id_groups;
   id_groups.reserve(groups.size());
   for (auto group : groups) {
-    std::set<PersonId> person_ids;
-    for (auto person : group.second) {
+    IdGroup::Persons person_ids;
+    person_ids.reserve(group.second.size());
+    for (auto &person : group.second) {
       person_ids.insert(person.id());
     }
-    id_groups.push_back(IdGroup(person_ids));
+    id_groups.push_back(IdGroup(std::move(person_ids)));
   }
   return Classification(timestamp, id_groups);
 }
 
-Classification
-fformation::GroupDetectorGrow::detect(const Observation &observation) const {
+static std::vector<Person> generatePersonList(const Observation &observation,
+                                              double) {
+  return observation.generatePersonList();
+}
+
+static std::vector<BasicPerson<float>>
+generatePersonList(const Observation &observation, float) {
+  // the observation keeps double precision, only the working set is narrowed
+  std::vector<BasicPerson<float>> result;
+  result.reserve(observation.size());
+  for (auto &person : observation.generatePersonList()) {
+    result.emplace_back(person);
+  }
+  return result;
+}
+
+template <typename Scalar>
+Classification fformation::BasicGroupDetectorGrow<Scalar>::detect(
+    const Observation &observation) const {
+  DetectionStats stats;
+  stats.timed = false;
+  return detect(observation, stats);
+}
+
+template <typename Scalar>
+Classification fformation::BasicGroupDetectorGrow<Scalar>::detect(
+    const Observation &observation, DetectionStats &stats) const {
   // edge case
-  if (observation.group().persons().size() < 2) {
+  if (observation.size() < 2) {
     OneGroupDetector det;
-    return det.detect(observation);
+    return det.detect(observation, stats);
   }
-
-  std::vector<Person> persons = observation.group().generatePersonList();
-  std::vector<Position2D> centers;
-  AssignmentCosts costs;
-  double sum_costs = std::numeric_limits<double>::max();
+  DetectionStats::Stopwatch stopwatch(stats.total_seconds, stats.timed);
+  stats.persons = observation.size();
+
+  const Scalar stride(_parameters.stride);
+  const Scalar mdl(_parameters.mdl);
+  std::vector<BasicPerson<Scalar>> persons =
+      generatePersonList(observation, Scalar());
+  Trace::Scope scope("grow", "detector",
+                      {{"timestamp", observation.timestamp().time()},
+                       {"persons", double(persons.size())}});
+  std::vector<BasicPosition2D<Scalar>> centers;
+  AssignmentCosts<Scalar> costs;
+  Scalar sum_costs = std::numeric_limits<Scalar>::max();
 
   size_t count = 0;
   while (++count) {
+    ++stats.outer_iterations;
     // propose new center
-    auto new_centers = proposeNewCenters(costs, centers, persons, _stride);
+    std::vector<BasicPosition2D<Scalar>> new_centers;
+    {
+      DetectionStats::Stopwatch propose(stats.propose_seconds, stats.timed);
+      new_centers = proposeNewCenters(costs, centers, persons, stride);
+    }
     // update centers through em
     // calculate assignment costs, sum costs
-    auto new_costs = optimizeCenters(new_centers, persons, _stride);
+    auto new_costs = optimizeCenters(new_centers, persons, stride,
+                                     _parameters.visibility, stats);
     // if sum_costs < previous
-    double new_sum_costs = sumCosts(findBestAssignment(new_costs), _mdl);
-    LOG_COSTS("GROW", sum_costs, new_sum_costs, costs, new_costs);
+    Scalar new_sum_costs;
+    {
+      DetectionStats::Stopwatch cost(stats.cost_seconds, stats.timed);
+      new_sum_costs = sumCosts(findBestAssignment(new_costs), mdl);
+    }
+    traceIteration("grow_iteration", count, sum_costs, new_sum_costs,
+                   new_centers.size());
     if (new_sum_costs < sum_costs) {
       // insert centers, assignment, sum into log
       centers = new_centers;
       costs = new_costs;
       sum_costs = new_sum_costs;
     } else {
+      stats.converged = true;
       break;
     }
   }
@@ -279,13 +336,14 @@ fformation::GroupDetectorGrow::detect(const Observation &observation) const {
 
 /// shrink detector
 
-static GroupNum findLeastCostIncrease(const AssignmentCosts &costs,
+template <typename Scalar>
+static GroupNum findLeastCostIncrease(const AssignmentCosts<Scalar> &costs,
                                       GroupNum groups_count) {
   if (groups_count == 1) {
     return 0;
   } // edge case
   auto best_costs = findBestAssignment(costs);
-  std::vector<double> group_move_costs(groups_count, 0.);
+  std::vector<Scalar> group_move_costs(groups_count, 0.);
   for (auto it : best_costs) {
     for (auto it2 = costs.begin(); it2 != costs.end(); ++it2) {
       if (it2->second.group_pos != it.second.group_pos &&
@@ -299,7 +357,7 @@ static GroupNum findLeastCostIncrease(const AssignmentCosts &costs,
     }
   }
   GroupNum least = 0;
-  double least_cost = group_move_costs.front();
+  Scalar least_cost = group_move_costs.front();
   for (GroupNum g = 0; g < group_move_costs.size(); ++g) {
     if (group_move_costs[g] < least_cost) {
       least = g;
@@ -309,10 +367,13 @@ static GroupNum findLeastCostIncrease(const AssignmentCosts &costs,
   return least;
 }
 
-static std::vector<Position2D> proposeLessCenters(
-    const AssignmentCosts &costs, const std::vector<Position2D> &groups,
-    const std::vector<Person> &persons, const Person::Stride &stride) {
-  std::vector<Position2D> centers;
+template <typename Scalar>
+static std::vector<BasicPosition2D<Scalar>>
+proposeLessCenters(const AssignmentCosts<Scalar> &costs,
+                   const std::vector<BasicPosition2D<Scalar>> &groups,
+                   const std::vector<BasicPerson<Scalar>> &persons,
+                   const Scalar &stride) {
+  std::vector<BasicPosition2D<Scalar>> centers;
   centers.reserve(persons.size());
   if (groups.empty()) {
     // initially create a group for each person in the observation
@@ -331,40 +392,69 @@ static std::vector<Position2D> proposeLessCenters(
   }
 }
 
-fformation::GroupDetectorShrink::GroupDetectorShrink(const Options &options)
-    : GroupDetector(options),
-      _mdl(options.getOption("mdl").validate(fv::Min<double>(0.))),
-      _stride(options.getOption("stride").validate(fv::Min<double>(0.))) {}
+template <typename Scalar>
+fformation::BasicGroupDetectorShrink<Scalar>::BasicGroupDetectorShrink(
+    const Options &options)
+    : GroupDetector(options), _parameters(EMOptions::parse(options)) {}
+
+template <typename Scalar>
+Classification fformation::BasicGroupDetectorShrink<Scalar>::detect(
+    const Observation &observation) const {
+  DetectionStats stats;
+  stats.timed = false;
+  return detect(observation, stats);
+}
 
-Classification
-fformation::GroupDetectorShrink::detect(const Observation &observation) const {
+template <typename Scalar>
+Classification fformation::BasicGroupDetectorShrink<Scalar>::detect(
+    const Observation &observation, DetectionStats &stats) const {
   // edge case
-  if (observation.group().persons().size() < 2) {
+  if (observation.size() < 2) {
     OneGroupDetector det;
-    return det.detect(observation);
+    return det.detect(observation, stats);
   }
-
-  std::vector<Person> persons = observation.group().generatePersonList();
-  std::vector<Position2D> centers;
-  AssignmentCosts costs;
-  double sum_costs = std::numeric_limits<double>::max();
+  DetectionStats::Stopwatch stopwatch(stats.total_seconds, stats.timed);
+  stats.persons = observation.size();
+
+  const Scalar stride(_parameters.stride);
+  const Scalar mdl(_parameters.mdl);
+  std::vector<BasicPerson<Scalar>> persons =
+      generatePersonList(observation, Scalar());
+  Trace::Scope scope("shrink", "detector",
+                      {{"timestamp", observation.timestamp().time()},
+                       {"persons", double(persons.size())}});
+  std::vector<BasicPosition2D<Scalar>> centers;
+  AssignmentCosts<Scalar> costs;
+  Scalar sum_costs = std::numeric_limits<Scalar>::max();
 
   size_t count = 0;
   while (++count) {
+    ++stats.outer_iterations;
     // remove a group center
-    auto new_centers = proposeLessCenters(costs, centers, persons, _stride);
+    std::vector<BasicPosition2D<Scalar>> new_centers;
+    {
+      DetectionStats::Stopwatch propose(stats.propose_seconds, stats.timed);
+      new_centers = proposeLessCenters(costs, centers, persons, stride);
+    }
     // update centers through em
     // calculate assignment costs, sum costs
-    auto new_costs = optimizeCenters(new_centers, persons, _stride);
+    auto new_costs = optimizeCenters(new_centers, persons, stride,
+                                     _parameters.visibility, stats);
     // if sum_costs < previous
-    double new_sum_costs = sumCosts(findBestAssignment(new_costs), _mdl);
-    LOG_COSTS("SHRINK", sum_costs, new_sum_costs, costs, new_costs);
+    Scalar new_sum_costs;
+    {
+      DetectionStats::Stopwatch cost(stats.cost_seconds, stats.timed);
+      new_sum_costs = sumCosts(findBestAssignment(new_costs), mdl);
+    }
+    traceIteration("shrink_iteration", count, sum_costs, new_sum_costs,
+                   new_centers.size());
     if (new_sum_costs < sum_costs) {
       // insert centers, assignment, sum into log
       centers = new_centers;
       costs = new_costs;
       sum_costs = new_sum_costs;
     } else {
+      stats.converged = true;
       break;
     }
   }
@@ -372,59 +462,99 @@ fformation::GroupDetectorShrink::detect(const Observation &observation) const {
                               findBestAssignment(costs));
 }
 
-fformation::GroupDetectorShrink2::GroupDetectorShrink2(const Options &options)
-    : GroupDetector(options),
-      _mdl(options.getOption("mdl").validate(fv::Min<double>(0.))),
-      _stride(options.getOption("stride").validate(fv::Min<double>(0.))) {}
+template <typename Scalar>
+fformation::BasicGroupDetectorShrink2<Scalar>::BasicGroupDetectorShrink2(
+    const Options &options)
+    : GroupDetector(options), _parameters(EMOptions::parse(options)) {}
+
+template <typename Scalar>
+Classification fformation::BasicGroupDetectorShrink2<Scalar>::detect(
+    const Observation &observation) const {
+  DetectionStats stats;
+  stats.timed = false;
+  return detect(observation, stats);
+}
 
-Classification
-fformation::GroupDetectorShrink2::detect(const Observation &observation) const {
+template <typename Scalar>
+Classification fformation::BasicGroupDetectorShrink2<Scalar>::detect(
+    const Observation &observation, DetectionStats &stats) const {
   // edge case
-  if (observation.group().persons().size() < 2) {
+  if (observation.size() < 2) {
     OneGroupDetector det;
-    return det.detect(observation);
+    return det.detect(observation, stats);
   }
-
-  std::vector<Person> persons = observation.group().generatePersonList();
-  std::vector<Position2D> centers;
-  AssignmentCosts costs;
+  DetectionStats::Stopwatch stopwatch(stats.total_seconds, stats.timed);
+  stats.persons = observation.size();
+
+  const Scalar stride(_parameters.stride);
+  const Scalar mdl(_parameters.mdl);
+  std::vector<BasicPerson<Scalar>> persons =
+      generatePersonList(observation, Scalar());
+  Trace::Scope scope("shrink2", "detector",
+                      {{"timestamp", observation.timestamp().time()},
+                       {"persons", double(persons.size())}});
+  std::vector<BasicPosition2D<Scalar>> centers;
+  AssignmentCosts<Scalar> costs;
   double sum_costs = std::numeric_limits<double>::max();
 
   size_t count = 0;
   while (++count) {
+    ++stats.outer_iterations;
     // remove a group center
-    auto new_centers = proposeLessCenters(costs, centers, persons, _stride);
+    std::vector<BasicPosition2D<Scalar>> new_centers;
+    {
+      DetectionStats::Stopwatch propose(stats.propose_seconds, stats.timed);
+      new_centers = proposeLessCenters(costs, centers, persons, stride);
+    }
     // update centers through em
     // calculate assignment costs, sum costs
-    auto new_costs = optimizeCenters(new_centers, persons, _stride);
+    auto new_costs = optimizeCenters(new_centers, persons, stride,
+                                     _parameters.visibility, stats);
     // if sum_costs < previous
-    double new_sum_costs =
-        createClassification(observation.timestamp(), persons,
-                             findBestAssignment(new_costs))
-            .calculateCosts(observation, _stride, _mdl);
-    LOG_COSTS("SHRINK2", sum_costs, new_sum_costs, costs, new_costs);
+    double new_sum_costs;
+    {
+      DetectionStats::Stopwatch cost(stats.cost_seconds, stats.timed);
+      new_sum_costs = createClassification(observation.timestamp(), persons,
+                                           findBestAssignment(new_costs))
+                          .calculateCosts(observation, _parameters.stride,
+                                          _parameters.mdl,
+                                          _parameters.visibility);
+    }
+    traceIteration("shrink2_iteration", count, sum_costs, new_sum_costs,
+                   new_centers.size());
     if (new_sum_costs < sum_costs) {
       // insert centers, assignment, sum into log
       centers = new_centers;
       costs = new_costs;
       sum_costs = new_sum_costs;
     } else {
-      Assignment worse = Assignment(0, 0, 0.);
+      Assignment<Scalar> worse = Assignment<Scalar>(0, 0, 0.);
       auto best_assignment = findBestAssignment(costs);
       for (auto it : findBestAssignment(costs)) {
         if (it.second.costs > worse.costs) {
           worse = it.second;
         }
       }
-      if (worse.costs > _mdl) {
-        LOG("Personal distance costs are higher than MDL. This may "
-            "happen when by removing a group not only the MDL cost is "
-            "decreased but the assignment of a person moves the group"
-            "center to a position with better overall visibility.");
+      if (worse.costs > mdl) {
+        // Personal distance costs are higher than MDL. This may happen when
+        // by removing a group not only the MDL cost is decreased but the
+        // assignment of a person moves the group center to a position with
+        // better overall visibility.
+        Trace::instant("mdl_exceeded", "em",
+                       {{"costs", double(worse.costs)},
+                        {"mdl", _parameters.mdl}});
       }
+      stats.converged = true;
       break;
     }
   }
   return createClassification(observation.timestamp(), persons,
                               findBestAssignment(costs));
 }
+
+template class fformation::BasicGroupDetectorGrow<double>;
+template class fformation::BasicGroupDetectorGrow<float>;
+template class fformation::BasicGroupDetectorShrink<double>;
+template class fformation::BasicGroupDetectorShrink<float>;
+template class fformation::BasicGroupDetectorShrink2<double>;
+template class fformation::BasicGroupDetectorShrink2<float>;
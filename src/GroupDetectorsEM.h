@@ -20,41 +20,102 @@
 #include "GroupDetector.h"
 #include "Observation.h"
 #include "Options.h"
+#include "VisibilityModel.h"
 #include <memory>
 
 namespace fformation {
 
-class GroupDetectorGrow : public GroupDetector {
+/**
+ * @brief EMOptions the options of the EM detectors. mdl and stride are
+ * required and must not be negative. The visibility_* options configure the
+ * VisibilityModel.
+ */
+struct EMOptions {
+  double mdl = 0.;
+  Person::Stride stride = 0.;
+  VisibilityModel visibility;
+
+  static const OptionSchema<EMOptions> &schema();
+  static EMOptions parse(const Options &options);
+};
+
+/**
+ * @brief BasicGroupDetectorGrow starts with a single group and adds a group
+ * center for the person with the highest costs until the MDL weighted costs
+ * stop decreasing. Scalar is the precision of the geometry and cost kernels.
+ */
+template <typename Scalar>
+class BasicGroupDetectorGrow : public GroupDetector {
 public:
-  GroupDetectorGrow(const Options &options);
+  BasicGroupDetectorGrow(const Options &options);
 
   virtual Classification detect(const Observation &observation) const final;
+  virtual Classification detect(const Observation &observation,
+                                DetectionStats &stats) const final;
+
+  virtual Ptr clone() const final {
+    return Ptr(new BasicGroupDetectorGrow(*this));
+  }
 
 private:
-  double _mdl;
-  Person::Stride _stride;
+  EMOptions _parameters;
 };
 
-class GroupDetectorShrink : public GroupDetector {
+extern template class BasicGroupDetectorGrow<double>;
+extern template class BasicGroupDetectorGrow<float>;
+typedef BasicGroupDetectorGrow<double> GroupDetectorGrow;
+
+/**
+ * @brief BasicGroupDetectorShrink starts with a group per person and removes
+ * the group center that is the cheapest to drop until the MDL weighted costs
+ * stop decreasing. Scalar is the precision of the geometry and cost kernels.
+ */
+template <typename Scalar>
+class BasicGroupDetectorShrink : public GroupDetector {
 public:
-  GroupDetectorShrink(const Options &options);
+  BasicGroupDetectorShrink(const Options &options);
 
   virtual Classification detect(const Observation &observation) const final;
+  virtual Classification detect(const Observation &observation,
+                                DetectionStats &stats) const final;
+
+  virtual Ptr clone() const final {
+    return Ptr(new BasicGroupDetectorShrink(*this));
+  }
 
 private:
-  double _mdl;
-  Person::Stride _stride;
+  EMOptions _parameters;
 };
 
-class GroupDetectorShrink2 : public GroupDetector {
+extern template class BasicGroupDetectorShrink<double>;
+extern template class BasicGroupDetectorShrink<float>;
+typedef BasicGroupDetectorShrink<double> GroupDetectorShrink;
+
+/**
+ * @brief BasicGroupDetectorShrink2 shrinks like BasicGroupDetectorShrink but
+ * rates each iteration with Classification::calculateCosts until the MDL
+ * weighted costs stop decreasing. Scalar is the precision of the geometry
+ * and cost kernels.
+ */
+template <typename Scalar>
+class BasicGroupDetectorShrink2 : public GroupDetector {
 public:
-  GroupDetectorShrink2(const Options &options);
+  BasicGroupDetectorShrink2(const Options &options);
 
   virtual Classification detect(const Observation &observation) const final;
+  virtual Classification detect(const Observation &observation,
+                                DetectionStats &stats) const final;
+
+  virtual Ptr clone() const final {
+    return Ptr(new BasicGroupDetectorShrink2(*this));
+  }
 
 private:
-  double _mdl;
-  Person::Stride _stride;
+  EMOptions _parameters;
 };
 
+extern template class BasicGroupDetectorShrink2<double>;
+extern template class BasicGroupDetectorShrink2<float>;
+typedef BasicGroupDetectorShrink2<double> GroupDetectorShrink2;
+
 } // namespace fformation
@@ -0,0 +1,183 @@
+/********************************************************************
+**                                                                 **
+** File   : src/JsonLinesEvaluation.cpp                            **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "JsonLinesEvaluation.h"
+#include "Features.h"
+#include "GroundTruth.h"
+#include "Parallel.h"
+#include "Pipeline.h"
+#include "RotationDropout.h"
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using fformation::JsonLinesEvaluation;
+using fformation::Evaluation;
+using fformation::Features;
+using fformation::GroundTruth;
+using fformation::GroupDetector;
+using fformation::Classification;
+using fformation::ConfusionMatrix;
+using fformation::Observation;
+using fformation::RotationDropout;
+using fformation::Parallel;
+using fformation::Pipeline;
+using fformation::Options;
+using fformation::Json;
+
+namespace {
+struct Line {
+  size_t number = 0;
+  std::string text;
+};
+
+struct Result {
+  size_t number = 0;
+  std::string text;
+  bool failed = false;
+  bool scored = false;
+  ConfusionMatrix confusion_matrix;
+};
+}
+
+/**
+ * Writes NaN as null to keep the line valid json.
+ */
+static void writeNumber(std::ostream &out, double value) {
+  if (std::isnan(value)) {
+    out << "null";
+  } else {
+    out << value;
+  }
+}
+
+/**
+ * Reads the next non empty line into line. The buffer of line is reused.
+ */
+static bool readLine(std::istream &in, Line &line, size_t &number) {
+  while (std::getline(in, line.text)) {
+    line.number = ++number;
+    if (line.text.find_first_not_of(" \t\r") != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void evaluateLine(const Line &line, Result &result,
+                         const GroupDetector &detector,
+                         const Evaluation::Parameters &parameters) {
+  std::stringstream out;
+  out << std::setprecision(8);
+  result.number = line.number;
+  result.failed = false;
+  result.scored = false;
+  try {
+    Json json = Json::parse(line.text);
+    Observation observation = Features::readObservationJson(json);
+    Classification classification;
+    if (json.count("groups")) {
+      Classification ground_truth = GroundTruth::readClassificationJson(json);
+      observation = RotationDropout::modify(observation, ground_truth,
+                                            parameters.modification);
+      classification = detector.detect(observation);
+      result.confusion_matrix = classification.createConfusionMatrix(
+          ground_truth, parameters.threshold);
+      result.scored = true;
+    } else {
+      classification = detector.detect(observation);
+    }
+    out << "{ \"line\": " << line.number
+        << ", \"classification\": " << classification;
+    if (result.scored) {
+      auto precision = result.confusion_matrix.calculatePrecision();
+      auto recall = result.confusion_matrix.calculateRecall();
+      out << ", \"precision\": ";
+      writeNumber(out, precision);
+      out << ", \"recall\": ";
+      writeNumber(out, recall);
+      out << ", \"f1\": ";
+      writeNumber(out, ConfusionMatrix::calculateF1Score(precision, recall));
+    }
+    out << " }\n";
+  } catch (const std::exception &e) {
+    Json error;
+    error["line"] = line.number;
+    error["error"] = e.what();
+    out.str("");
+    out << error.dump() << "\n";
+    result.failed = true;
+  }
+  result.text = out.str();
+}
+
+JsonLinesEvaluation::JsonLinesEvaluation(const GroupDetector &detector,
+                                         const Options &options)
+    : _detector(detector), _parameters(Evaluation::Parameters::parse(options)) {
+  _summary.quantiles = _parameters.quantiles;
+}
+
+void JsonLinesEvaluation::run(std::istream &in, std::ostream &out) {
+  auto write = [&](Result &result) {
+    out << result.text << std::flush;
+    ++_frames;
+    if (result.failed) {
+      ++_failures;
+    } else if (result.scored) {
+      _summary.add({result.confusion_matrix});
+    }
+  };
+  size_t number = 0;
+  size_t threads = (_parameters.threads == 0) ? Parallel::defaultThreads()
+                                              : _parameters.threads;
+  if (threads == 1) {
+    Line line;
+    Result result;
+    while (readLine(in, line, number)) {
+      evaluateLine(line, result, _detector, _parameters);
+      write(result);
+    }
+  } else {
+    std::vector<GroupDetector::Ptr> detectors;
+    for (size_t i = 0; i < threads; ++i) {
+      detectors.push_back(_detector.clone());
+    }
+    Pipeline<Line, Result> pipeline(threads, 16 * threads);
+    pipeline.run([&](Line &line) { return readLine(in, line, number); },
+                 [&](Line &line, size_t worker) {
+                   Result result;
+                   evaluateLine(line, result, *detectors[worker], _parameters);
+                   return result;
+                 },
+                 write);
+  }
+}
+
+void JsonLinesEvaluation::writeSummary(std::ostream &out) const {
+  auto precision = _summary.precision.mean();
+  auto recall = _summary.recall.mean();
+  out << std::setprecision(8) << "{ \"frames\": " << _frames
+      << ", \"failures\": " << _failures
+      << ", \"scored\": " << _summary.precision.count()
+      << ", \"precision\": ";
+  writeNumber(out, precision);
+  out << ", \"recall\": ";
+  writeNumber(out, recall);
+  out << ", \"f1\": ";
+  writeNumber(out, ConfusionMatrix::calculateF1Score(precision, recall));
+  out << " }" << std::endl;
+}
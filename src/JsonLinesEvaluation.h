@@ -0,0 +1,72 @@
+/********************************************************************
+**                                                                 **
+** File   : src/JsonLinesEvaluation.h                              **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "Evaluation.h"
+#include "GroupDetector.h"
+#include "Options.h"
+#include <istream>
+#include <ostream>
+
+namespace fformation {
+
+/**
+ * @brief JsonLinesEvaluation detects and scores frames that arrive as one json
+ * object per line.
+ *
+ * A frame line contains an observation and optionally its ground truth:
+ * { "timestamp": t, "persons": [ [id, x, y, rotation], ... ],
+ *   "groups": [ [id, ...], ... ] }.
+ * For every frame a line { "line": n, "classification": {...} } is written and
+ * flushed as soon as the frame is done. Frames with ground truth additionally
+ * contain the "precision", "recall" and "f1" of the main threshold and are
+ * modified according to the rotation dropout options first. Lines that cannot
+ * be read or detected are answered with { "line": n, "error": "..." }.
+ *
+ * Uses the evaluation options threshold, threads and the rotation dropout
+ * options. With more than one thread, lines are parsed and detected in a
+ * Pipeline and written in input order.
+ */
+class JsonLinesEvaluation {
+public:
+  JsonLinesEvaluation(const GroupDetector &detector,
+                      const Options &options = Options());
+
+  /**
+   * @brief run evaluates all lines of in until its end.
+   */
+  void run(std::istream &in, std::ostream &out);
+
+  /**
+   * @brief writeSummary writes a line with the number of frames and the
+   * mean precision, recall and f1 score of the frames with ground truth.
+   */
+  void writeSummary(std::ostream &out) const;
+
+  const Evaluation::Summary &summary() const { return _summary; }
+  size_t frames() const { return _frames; }
+  size_t failures() const { return _failures; }
+
+private:
+  const GroupDetector &_detector;
+  Evaluation::Parameters _parameters;
+  Evaluation::Summary _summary;
+  size_t _frames = 0;
+  size_t _failures = 0;
+};
+
+} // namespace fformation
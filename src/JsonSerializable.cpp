@@ -16,3 +16,10 @@
 ********************************************************************/
 
 #include "JsonSerializable.h"
+#include <sstream>
+
+void fformation::JsonSerializable::serializeJson(BufferedWriter &out) const {
+  std::stringstream str;
+  serializeJson(str);
+  out << str.str();
+}
@@ -16,6 +16,7 @@
 ********************************************************************/
 
 #pragma once
+#include "BufferedWriter.h"
 #include "OstreamPrinter.h"
 #include <ostream>
 
@@ -25,10 +26,19 @@ class JsonSerializable {
 public:
   virtual void serializeJson(std::ostream &out) const = 0;
 
+  /**
+   * @brief serializeJson writes the same json as serializeJson(std::ostream&)
+   * to a BufferedWriter. The default implementation formats into a
+   * stringstream, types printed per frame override it.
+   */
+  virtual void serializeJson(BufferedWriter &out) const;
+
   virtual void print(std::ostream &out) const final { serializeJson(out); }
 
-  template <typename T>
-  static void serializeIterable(std::ostream &out, const T &iterable) {
+  virtual void print(BufferedWriter &out) const final { serializeJson(out); }
+
+  template <typename Stream, typename T>
+  static void serializeIterable(Stream &out, const T &iterable) {
     if (iterable.begin() == iterable.end()) {
       out << "[ ]";
     } else {
@@ -45,8 +55,8 @@ public:
       out << " ]";
     }
   }
-  template <typename T>
-  static void serializeMapAsVector(std::ostream &out, const T &map) {
+  template <typename Stream, typename T>
+  static void serializeMapAsVector(Stream &out, const T &map) {
     if (map.begin() == map.end()) {
       out << "[ ]";
     } else {
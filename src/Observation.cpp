@@ -16,3 +16,58 @@
 ********************************************************************/
 
 #include "Observation.h"
+#include "Exception.h"
+#include <algorithm>
+
+using fformation::Observation;
+using fformation::Group;
+using fformation::Person;
+using fformation::Exception;
+
+const Group &Observation::group() const {
+  if (!_overlay) {
+    return *_group;
+  }
+  std::call_once(_overlay->materialized,
+                 [this]() { _overlay->group = Group(generatePersonList()); });
+  return _overlay->group;
+}
+
+std::vector<Person> Observation::generatePersonList() const {
+  if (!_overlay) {
+    return _group->generatePersonList();
+  }
+  std::vector<Person> result;
+  result.reserve(_overlay->size);
+  auto visibility = _overlay->mask.begin();
+  for (auto &it : _group->persons()) {
+    switch (*visibility++) {
+    case Visibility::Visible:
+      result.push_back(it.second);
+      break;
+    case Visibility::WithoutRotation:
+      result.push_back(Person(it.first, {it.second.pose().position()}));
+      break;
+    case Visibility::Removed:
+      break;
+    }
+  }
+  return result;
+}
+
+Observation Observation::masked(Mask mask) const {
+  if (_overlay) {
+    // masks index the visible persons, start from a plain table
+    return Observation(_timestamp, group()).masked(std::move(mask));
+  }
+  Exception::check(mask.size() == _group->persons().size(),
+                   "An observation mask needs one entry per person.");
+  Observation result(*this);
+  result._overlay = std::make_shared<Overlay>();
+  result._overlay->size = size_t(
+      std::count_if(mask.begin(), mask.end(), [](Visibility visibility) {
+        return visibility != Visibility::Removed;
+      }));
+  result._overlay->mask = std::move(mask);
+  return result;
+}
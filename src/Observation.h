@@ -19,28 +19,91 @@
 #include "Group.h"
 #include "JsonSerializable.h"
 #include "Timestamp.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace fformation {
 
+/**
+ * @brief Observation the persons observed at a point in time.
+ *
+ * The person table is immutable and shared between copies, so copying an
+ * observation is cheap. A Mask creates a lightweight overlay that hides
+ * rotations or persons without copying the table. Detectors read the persons
+ * through size() and generatePersonList(), which apply the mask on the fly.
+ * group() materializes a masked observation once, on first use.
+ */
 class Observation : public JsonSerializable {
 public:
+  /**
+   * @brief Visibility how a person of the table appears in an overlay.
+   */
+  enum class Visibility : uint8_t { Visible, WithoutRotation, Removed };
+
+  /**
+   * @brief Mask one Visibility per person of group(), in id order.
+   */
+  typedef std::vector<Visibility> Mask;
+
   Observation(Timestamp timestamp = 0.,
               const Group &group = std::vector<Person>())
-      : _timestamp(timestamp), _group(group) {}
+      : _timestamp(timestamp), _group(std::make_shared<const Group>(group)) {}
 
   const Timestamp &timestamp() const { return _timestamp; }
-  const Group &group() const { return _group; }
+
+  /**
+   * @brief group the visible persons. Materialized on first use if the
+   * observation is masked.
+   */
+  const Group &group() const;
+
+  /**
+   * @brief size the number of visible persons.
+   */
+  size_t size() const {
+    return _overlay ? _overlay->size : _group->persons().size();
+  }
+
+  /**
+   * @brief generatePersonList the visible persons in id order, without
+   * materializing the group of a masked observation.
+   */
+  std::vector<Person> generatePersonList() const;
+
+  /**
+   * @brief masked creates an overlay that shares the person table of this
+   * observation.
+   *
+   * @param mask one entry per person of group()
+   */
+  Observation masked(Mask mask) const;
 
   virtual void serializeJson(std::ostream &out) const override {
+    writeJson(out);
+  }
+  virtual void serializeJson(BufferedWriter &out) const override {
+    writeJson(out);
+  }
+
+private:
+  struct Overlay {
+    Mask mask;
+    size_t size = 0;
+    std::once_flag materialized;
+    Group group;
+  };
+
+  template <typename Stream> void writeJson(Stream &out) const {
     out << "{ \"timestamp\": " << _timestamp << ", \"persons\": ";
-    serializeMapAsVector(out, _group.persons());
+    serializeMapAsVector(out, group().persons());
     out << " }";
   }
 
-private:
   Timestamp _timestamp;
-  Group _group;
+  std::shared_ptr<const Group> _group;
+  std::shared_ptr<Overlay> _overlay;
 };
 
 } // namespace fformation
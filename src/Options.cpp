@@ -29,7 +29,10 @@ template <> std::string Option::convertValue() const { return _value; }
 
 namespace fformation {
 template <> bool Option::convertValue() const {
-  if (_value == "1" || _value == "true" || _value == "True" ||
+  if (!_has_value) {
+    // a flag without value
+    return true;
+  } else if (_value == "1" || _value == "true" || _value == "True" ||
       _value == "TRUE") {
     return true;
   } else {
@@ -128,3 +131,17 @@ Options::parseFromString(const std::string &options,
   }
   return result;
 }
+
+std::string Options::toString(const std::string &separator) const {
+  std::stringstream result;
+  for (auto it = this->begin(); it != this->end(); ++it) {
+    if (it != this->begin()) {
+      result << separator;
+    }
+    result << it->name();
+    if (it->has_value()) {
+      result << "=" << it->value();
+    }
+  }
+  return result.str();
+}
@@ -17,6 +17,7 @@
 
 #pragma once
 #include "Exception.h"
+#include <functional>
 #include <set>
 #include <sstream>
 #include <string>
@@ -111,7 +112,7 @@ public:
   }
 
 private:
-  const std::vector<T> &_list;
+  std::vector<T> _list;
   bool _result;
 };
 
@@ -143,7 +144,10 @@ public:
   template <typename T> T convertValue() const {
     T result;
     std::stringstream str(_value);
-    str >> result;
+    if (!(str >> result)) {
+      throw Exception("Cannot convert option '" + _name + "'='" + _value +
+                      "'.");
+    }
     return result;
   }
 
@@ -151,8 +155,8 @@ public:
   T validate(const validators::Validator<T> &validator) const {
     T result = convertValue<T>();
     if (!validator.validate(result)) {
-      Exception("Cannot convert option '" + _name + "'='" + _value +
-                "' to a valid value.");
+      throw Exception("Cannot convert option '" + _name + "'='" + _value +
+                      "' to a valid value.");
     }
     return result;
   }
@@ -173,6 +177,9 @@ private:
   bool _has_value;
 };
 
+template <> std::string Option::convertValue() const;
+template <> bool Option::convertValue() const;
+
 class Options : public std::set<Option, Option::Comp> {
 public:
   Options() = default;
@@ -201,7 +208,8 @@ public:
     if(hasOption(name)){
       return getOption(name).validate(validator);
     } else {
-      validator.validate(fallback);
+      Exception::check(validator.validate(fallback),
+                       "Invalid default value of option '" + name + "'.");
       return fallback;
     }
   }
@@ -209,6 +217,91 @@ public:
   static Options
   parseFromString(const std::string &options,
                   const std::string &separator = "@");
+
+  /**
+   * @brief toString creates a string that can be read by parseFromString.
+   */
+  std::string toString(const std::string &separator = "@") const;
+};
+
+/**
+ * @brief OptionSchema describes how Options are parsed into the fields of a
+ * plain struct.
+ *
+ * The schema is declared once. parse() converts and validates all options at
+ * once, so code that runs per frame reads struct fields instead of looking up
+ * and converting strings. Defaults are the values of a default constructed
+ * Target. Options the schema does not know are ignored.
+ */
+template <typename Target> class OptionSchema {
+public:
+  typedef std::function<void(const Options &, Target &)> Field;
+
+  /**
+   * @brief optional sets member from the option name if it is present.
+   */
+  template <typename T, typename V = validators::Accept<T>>
+  OptionSchema &optional(const Option::NameType &name, T Target::*member,
+                         const V &validator = V()) {
+    _names.push_back(name);
+    _fields.push_back([name, member, validator](const Options &options,
+                                                Target &target) {
+      if (options.hasOption(name)) {
+        target.*member = options.getOption(name).validate<T>(validator);
+      }
+    });
+    return *this;
+  }
+
+  /**
+   * @brief required sets member from the option name and throws if it is
+   * missing.
+   */
+  template <typename T, typename V = validators::Accept<T>>
+  OptionSchema &required(const Option::NameType &name, T Target::*member,
+                         const V &validator = V()) {
+    _names.push_back(name);
+    _fields.push_back([name, member, validator](const Options &options,
+                                                Target &target) {
+      target.*member = options.getOption(name).validate<T>(validator);
+    });
+    return *this;
+  }
+
+  /**
+   * @brief custom sets member from the option name with a user defined
+   * conversion if the option is present. convert throws on invalid values.
+   */
+  template <typename T>
+  OptionSchema &custom(const Option::NameType &name, T Target::*member,
+                       std::function<T(const Option &)> convert) {
+    _names.push_back(name);
+    _fields.push_back([name, member, convert](const Options &options,
+                                              Target &target) {
+      if (options.hasOption(name)) {
+        target.*member = convert(options.getOption(name));
+      }
+    });
+    return *this;
+  }
+
+  /**
+   * @brief parse applies all fields in declaration order to a default
+   * constructed Target. Throws fformation::Exception on invalid values.
+   */
+  Target parse(const Options &options) const {
+    Target result;
+    for (auto &field : _fields) {
+      field(options, result);
+    }
+    return result;
+  }
+
+  const std::vector<Option::NameType> &names() const { return _names; }
+
+private:
+  std::vector<Option::NameType> _names;
+  std::vector<Field> _fields;
 };
 
 } // namespace fformation
@@ -20,6 +20,8 @@
 
 namespace fformation {
 
+class BufferedWriter;
+
 /**
  * Print-function to ostream printer template.
  */
@@ -30,4 +32,36 @@ auto operator<<(std::ostream &out, const T &data)
   return out;
 }
 
+/**
+ * Print-function to BufferedWriter printer template.
+ */
+template <class T>
+auto operator<<(BufferedWriter &out, const T &data)
+    -> decltype(data.print(out), out) {
+  data.print(out);
+  return out;
+}
+
+/**
+ * Free serializeJson-function to ostream printer template. Used by the value
+ * types which have no vtable and are serialized by a serializeJson(out, data)
+ * function found by argument dependent lookup.
+ */
+template <class T>
+auto operator<<(std::ostream &out, const T &data)
+    -> decltype(serializeJson(out, data), out) {
+  serializeJson(out, data);
+  return out;
+}
+
+/**
+ * Free serializeJson-function to BufferedWriter printer template.
+ */
+template <class T>
+auto operator<<(BufferedWriter &out, const T &data)
+    -> decltype(serializeJson(out, data), out) {
+  serializeJson(out, data);
+  return out;
+}
+
 } // namespace fformation
@@ -0,0 +1,73 @@
+/********************************************************************
+**                                                                 **
+** File   : src/Parallel.cpp                                       **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "Parallel.h"
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using fformation::Parallel;
+
+size_t Parallel::defaultThreads() {
+  size_t result = std::thread::hardware_concurrency();
+  return (result == 0) ? 1 : result;
+}
+
+void Parallel::forEach(size_t count, size_t threads,
+                       const std::function<void(size_t)> &function) {
+  if (threads == 0) {
+    threads = defaultThreads();
+  }
+  if (threads > count) {
+    threads = count;
+  }
+  if (threads <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+  std::atomic<size_t> next(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto worker = [&]() {
+    for (size_t i = next++; i < count; i = next++) {
+      try {
+        function(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = count; // stop handing out work
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (size_t t = 0; t < threads; ++t) {
+    workers.push_back(std::thread(worker));
+  }
+  for (auto &thread : workers) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
@@ -0,0 +1,48 @@
+/********************************************************************
+**                                                                 **
+** File   : src/Parallel.h                                         **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <functional>
+
+namespace fformation {
+
+class Parallel {
+public:
+  /**
+   * @brief defaultThreads the number of threads used when 0 is requested.
+   * @return the hardware concurrency or 1 if it is unknown.
+   */
+  static size_t defaultThreads();
+
+  /**
+   * @brief forEach calls function(i) for every i in [0, count) using up to
+   * threads worker threads.
+   *
+   * Indices are handed out dynamically so long running calls do not block
+   * the remaining work. The first exception thrown by function is rethrown
+   * in the calling thread after all workers finished.
+   *
+   * @param count the number of indices to process
+   * @param threads the number of worker threads. 0 = defaultThreads()
+   * @param function the work to do for a single index. must be thread safe.
+   */
+  static void forEach(size_t count, size_t threads,
+                      const std::function<void(size_t)> &function);
+};
+
+} // namespace fformation
@@ -0,0 +1,228 @@
+/********************************************************************
+**                                                                 **
+** File   : src/ParameterSweep.cpp                                 **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "ParameterSweep.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <boost/tokenizer.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+
+using fformation::ParameterSweep;
+using fformation::Options;
+using fformation::Option;
+using fformation::Exception;
+using fformation::ConfusionMatrix;
+
+ParameterSweep::ParameterSweep(const Features &features,
+                               const GroundTruth &ground_truth,
+                               const std::string &detector,
+                               const Options &evaluation_options,
+                               const GroupDetectorFactory &factory)
+    : _detector(detector), _factory(factory),
+      _frames(Evaluation::prepareFrames(features, ground_truth,
+                                        evaluation_options)) {
+  // validated like in the Evaluation, so both accept the same options
+  _threshold = Evaluation::Parameters::parse(evaluation_options).threshold;
+}
+
+ParameterSweep::Result ParameterSweep::evaluate(const Options &options) const {
+  std::vector<size_t> frames(_frames.size());
+  std::iota(frames.begin(), frames.end(), 0);
+  return evaluate(options, frames);
+}
+
+ParameterSweep::Result
+ParameterSweep::evaluate(const Options &options,
+                         const std::vector<size_t> &frames) const {
+  auto detector = _factory.create(_detector, options);
+  Result result;
+  result.options = options;
+  for (auto index : frames) {
+    auto &frame = _frames.at(index);
+    try {
+      auto cm = detector->detect(frame.first)
+                    .createConfusionMatrix(frame.second, _threshold);
+      result.precision += cm.calculatePrecision();
+      result.recall += cm.calculateRecall();
+      ++result.frames;
+    } catch (const Exception &e) {
+      std::cerr << "Classification failed: " << e.what() << std::endl;
+    }
+  }
+  if (result.frames > 0) {
+    result.precision /= ConfusionMatrix::RealType(result.frames);
+    result.recall /= ConfusionMatrix::RealType(result.frames);
+    result.f1 =
+        ConfusionMatrix::calculateF1Score(result.precision, result.recall);
+  }
+  return result;
+}
+
+std::vector<ParameterSweep::Result>
+ParameterSweep::run(const std::vector<Options> &configurations,
+                    size_t threads) const {
+  std::vector<Result> results(configurations.size());
+  Parallel::forEach(configurations.size(), threads, [&](size_t i) {
+    results[i] = evaluate(configurations[i]);
+  });
+  return results;
+}
+
+static double rankOf(const ParameterSweep::Result &result) {
+  // undefined f1 scores (precision = recall = 0) rank last
+  return std::isnan(result.f1) ? -std::numeric_limits<double>::infinity()
+                               : result.f1;
+}
+
+ParameterSweep::Result
+ParameterSweep::tune(const std::vector<Options> &configurations,
+                     size_t initial_frames, size_t seed, size_t threads,
+                     std::vector<Rung> *rungs) const {
+  Exception::check(!configurations.empty(),
+                   "Tuning needs at least one configuration.");
+  Exception::check(!_frames.empty(), "Tuning needs at least one frame.");
+  // every round uses a prefix of the same permutation, so the frames of a
+  // round are always a superset of the frames of the previous rounds.
+  std::vector<size_t> order(_frames.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::mt19937 generator(seed);
+  std::shuffle(order.begin(), order.end(), generator);
+
+  std::vector<Options> candidates = configurations;
+  size_t budget = std::max<size_t>(1, std::min(initial_frames, order.size()));
+  while (candidates.size() > 1) {
+    std::vector<size_t> subset(order.begin(), order.begin() + budget);
+    std::vector<Result> results(candidates.size());
+    Parallel::forEach(candidates.size(), threads, [&](size_t i) {
+      results[i] = evaluate(candidates[i], subset);
+    });
+    std::stable_sort(results.begin(), results.end(),
+                     [](const Result &a, const Result &b) {
+                       return rankOf(a) > rankOf(b);
+                     });
+    size_t survivors =
+        (budget < order.size()) ? (candidates.size() + 1) / 2 : 1;
+    if (rungs != nullptr) {
+      rungs->push_back({candidates.size(), budget, results.front()});
+    }
+    candidates.clear();
+    for (size_t i = 0; i < survivors; ++i) {
+      candidates.push_back(results[i].options);
+    }
+    budget = std::min(budget * 2, order.size());
+  }
+  return evaluate(candidates.front());
+}
+
+static std::vector<Option::ValueType> parseRange(const std::string &name,
+                                                 const std::string &range) {
+  boost::char_separator<char> separator(":", "", boost::keep_empty_tokens);
+  boost::tokenizer<boost::char_separator<char>> tokens(range, separator);
+  std::vector<double> values;
+  for (auto token : tokens) {
+    std::stringstream str(token);
+    double value;
+    str >> value;
+    Exception::check(!str.fail() && str.eof(),
+                     "Sweep range of '" + name + "' must be numeric. Got: '" +
+                         range + "'");
+    values.push_back(value);
+  }
+  Exception::check(values.size() == 3, "Sweep range of '" + name +
+                                           "' must be start:step:stop. Got: '" +
+                                           range + "'");
+  double start = values[0];
+  double step = values[1];
+  double stop = values[2];
+  Exception::check(step > 0., "Sweep range step of '" + name +
+                                  "' must be positive. Got: '" + range + "'");
+  std::vector<Option::ValueType> result;
+  // tolerate rounding errors at the inclusive upper bound
+  double tolerance = step * 1e-9;
+  for (size_t i = 0; start + double(i) * step <= stop + tolerance; ++i) {
+    result.push_back(Option::fromValue(start + double(i) * step));
+  }
+  return result;
+}
+
+static std::vector<Option::ValueType> parseValues(const Option &option) {
+  Exception::check(option.has_value(),
+                   "Sweep option '" + option.name() + "' needs values.");
+  if (option.value().find(':') != std::string::npos) {
+    return parseRange(option.name(), option.value());
+  }
+  std::vector<Option::ValueType> result;
+  boost::char_separator<char> separator(",");
+  boost::tokenizer<boost::char_separator<char>> tokens(option.value(),
+                                                       separator);
+  for (auto token : tokens) {
+    result.push_back(token);
+  }
+  Exception::check(!result.empty(),
+                   "Sweep option '" + option.name() + "' needs values.");
+  return result;
+}
+
+ParameterSweep::SweepSpec ParameterSweep::parseSweep(const std::string &spec) {
+  SweepSpec result;
+  for (auto option : Options::parseFromString(spec)) {
+    result[option.name()] = parseValues(option);
+  }
+  return result;
+}
+
+std::vector<Options> ParameterSweep::expand(const Options &base,
+                                            const SweepSpec &spec) {
+  std::vector<Options> result = {base};
+  for (auto &parameter : spec) {
+    std::vector<Options> expanded;
+    expanded.reserve(result.size() * parameter.second.size());
+    for (auto &options : result) {
+      for (auto &value : parameter.second) {
+        Options copy = options;
+        copy.override(Option(parameter.first, value));
+        expanded.push_back(copy);
+      }
+    }
+    result.swap(expanded);
+  }
+  return result;
+}
+
+std::ostream &ParameterSweep::printTable(std::ostream &out,
+                                         const std::vector<Result> &results,
+                                         const SweepSpec &spec) {
+  const std::string s = "\t";
+  for (auto &parameter : spec) {
+    out << parameter.first << s;
+  }
+  out << "precision" << s << "recall" << s << "f1" << s << "frames"
+      << "\n";
+  for (auto &result : results) {
+    for (auto &parameter : spec) {
+      out << result.options.getOption(parameter.first).value() << s;
+    }
+    out << std::setprecision(8) << std::fixed << result.precision << s
+        << result.recall << s << result.f1 << s << result.frames << "\n";
+  }
+  return out;
+}
@@ -0,0 +1,156 @@
+/********************************************************************
+**                                                                 **
+** File   : src/ParameterSweep.h                                   **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "ConfusionMatrix.h"
+#include "Evaluation.h"
+#include "GroupDetectorFactory.h"
+#include "Options.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief ParameterSweep evaluates one detector with many option sets on a
+ * dataset that is loaded and prepared only once.
+ */
+class ParameterSweep {
+public:
+  /**
+   * @brief SweepSpec maps option names to the list of values to evaluate.
+   */
+  typedef std::map<Option::NameType, std::vector<Option::ValueType>> SweepSpec;
+
+  struct Result {
+    Options options;
+    ConfusionMatrix::RealType precision = 0.;
+    ConfusionMatrix::RealType recall = 0.;
+    ConfusionMatrix::RealType f1 = 0.;
+    size_t frames = 0;
+  };
+
+  /**
+   * @brief Rung one round of the successive halving in tune: the number of
+   * evaluated configurations, the number of frames they were evaluated on and
+   * the best result of the round.
+   */
+  struct Rung {
+    size_t configurations = 0;
+    size_t frames = 0;
+    Result best;
+  };
+
+  /**
+   * @brief ParameterSweep prepares the frames of the dataset.
+   *
+   * @param features the observations to evaluate
+   * @param ground_truth the annotations of the observations
+   * @param detector the name of the detector as known by factory
+   * @param evaluation_options options as used by Evaluation (threshold,
+   * modify_rotations, ...)
+   * @param factory is used to create one detector per configuration
+   */
+  ParameterSweep(const Features &features, const GroundTruth &ground_truth,
+                 const std::string &detector,
+                 const Options &evaluation_options = Options(),
+                 const GroupDetectorFactory &factory =
+                     GroupDetectorFactory::getDefaultInstance());
+
+  const std::vector<Evaluation::Frame> &frames() const { return _frames; }
+
+  /**
+   * @brief evaluate runs the detector with options on all frames.
+   */
+  Result evaluate(const Options &options) const;
+
+  /**
+   * @brief evaluate runs the detector with options on a subset of frames.
+   * Precision, recall and f1 are 0 when no frame could be evaluated.
+   *
+   * @param options the detector options
+   * @param frames the indices of the frames to evaluate
+   */
+  Result evaluate(const Options &options,
+                  const std::vector<size_t> &frames) const;
+
+  /**
+   * @brief run evaluates all configurations in parallel.
+   *
+   * @param configurations the detector options of each run
+   * @param threads the number of worker threads. 0 = hardware concurrency
+   * @return one result per configuration in the same order
+   */
+  std::vector<Result> run(const std::vector<Options> &configurations,
+                          size_t threads = 0) const;
+
+  /**
+   * @brief tune searches the best configuration by successive halving.
+   *
+   * All configurations are evaluated on a random subset of initial_frames
+   * frames. The better half (by F1 score) survives and the subset is doubled
+   * for the next round. This repeats until a single configuration is left,
+   * which is then evaluated on all frames.
+   *
+   * @param configurations the candidate detector options
+   * @param initial_frames the number of frames of the first round
+   * @param seed seeds the selection of the frame subsets
+   * @param threads the number of worker threads. 0 = hardware concurrency
+   * @param rungs when not null every round is appended to it
+   * @return the result of the best configuration on all frames
+   */
+  Result tune(const std::vector<Options> &configurations,
+              size_t initial_frames = 16, size_t seed = 0, size_t threads = 0,
+              std::vector<Rung> *rungs = nullptr) const;
+
+  /**
+   * @brief parseSweep parses a sweep specification.
+   *
+   * The specification uses the Options syntax. Every value is either a comma
+   * separated list 'stride=0.5,0.7,0.9' or an inclusive numeric range in the
+   * form 'mdl=start:step:stop'. Example: 'mdl=1:1:20@stride=0.5,0.7'
+   */
+  static SweepSpec parseSweep(const std::string &spec);
+
+  /**
+   * @brief expand creates the cartesian product of all sweep values.
+   *
+   * @param base the options every configuration starts from
+   * @param spec the values to override in base
+   * @return one Options set per grid point. base if spec is empty.
+   */
+  static std::vector<Options> expand(const Options &base,
+                                     const SweepSpec &spec);
+
+  /**
+   * @brief printTable prints one tab separated line per result containing the
+   * values of the swept options followed by precision, recall, f1 and the
+   * number of evaluated frames.
+   */
+  static std::ostream &printTable(std::ostream &out,
+                                  const std::vector<Result> &results,
+                                  const SweepSpec &spec);
+
+private:
+  std::string _detector;
+  double _threshold = 2. / 3.;
+  const GroupDetectorFactory &_factory;
+  std::vector<Evaluation::Frame> _frames;
+};
+
+} // namespace fformation
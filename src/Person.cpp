@@ -20,29 +20,26 @@
 #include <cmath>
 #include <iostream>
 
-const static double max_visibility_constraint_cost = 10000000.;
+using fformation::BasicPerson;
+using fformation::VisibilityModel;
 
-using fformation::Person;
-using fformation::Position2D;
-using fformation::Settings;
-using fformation::RotationRadian;
-using fformation::OptionalRotationRadian;
-
-Position2D
-Person::calculateTransactionalSegmentPosition(const Position2D &position,
-                                              const RotationRadian &rotation,
-                                              const Person::Stride &stride) {
-  return Position2D(position.x() + (stride * std::cos(rotation)),
-                    position.y() + (stride * std::sin(rotation)));
+template <typename Scalar>
+typename BasicPerson<Scalar>::Position
+BasicPerson<Scalar>::calculateTransactionalSegmentPosition(
+    const Position &position, const Scalar &rotation, const Stride &stride) {
+  return Position(position.x() + (stride * std::cos(rotation)),
+                  position.y() + (stride * std::sin(rotation)));
 }
 
-double Person::calculateDistanceCosts(const Position2D &group_center,
-                                      Person::Stride stride) const {
+template <typename Scalar>
+Scalar BasicPerson<Scalar>::calculateDistanceCosts(const Position &group_center,
+                                                   Stride stride) const {
   if (_pose.rotation()) {
     auto ts = calculateTransactionalSegmentPosition(
         _pose.position(), _pose.rotation().get(), stride);
-    return std::pow(group_center.x() - ts.x(), 2) +
-           std::pow(group_center.y() - ts.y(), 2);
+    auto dx = group_center.x() - ts.x();
+    auto dy = group_center.y() - ts.y();
+    return dx * dx + dy * dy;
   } else { // calculate costs without knowing rotation
     auto dist = (group_center - _pose.position())
                     .norm(); // distance btw group and person
@@ -50,12 +47,14 @@ double Person::calculateDistanceCosts(const Position2D &group_center,
     // towards group
     // return std::pow(dist + stride,2); // pessimistic, person is oriented away
     // from group
-    return std::pow(dist, 2); // mean -> no assumption
+    return dist * dist; // mean -> no assumption
   }
 }
 
-double Person::calculateVisibilityCost(const Position2D &group_center,
-                                       const Person &other) const {
+template <typename Scalar>
+Scalar BasicPerson<Scalar>::calculateVisibilityCost(
+    const Position &group_center, const BasicPerson &other,
+    const VisibilityModel &model) const {
   if (_id == other.id()) {
     return 0.; // same person
   }
@@ -73,15 +72,14 @@ double Person::calculateVisibilityCost(const Position2D &group_center,
   }
   auto cosinus_angle =
       this_vector.dot(other_vector) / (this_distance * other_distance);
-  if (cosinus_angle > _acos_of_theta) {
+  if (cosinus_angle > model.threshold()) {
     return 0.; // angle is too big
   }
-  // exp(ln(k) * cos(\theta) * (d_i/d_j)) can be rearranged to k^(cos(\theta) *
-  // (d_i/d_j))
-  double result =
-      pow(_ln_of_k, cosinus_angle * (this_distance / other_distance));
+  // k^(cos(\theta) * (d_i/d_j)) = exp(ln(k) * cos(\theta) * (d_i/d_j))
+  Scalar result = model.cost(cosinus_angle * (this_distance / other_distance));
   assert(result >= 0.);
-  return (result < max_visibility_constraint_cost)
-             ? result
-             : max_visibility_constraint_cost;
+  return result;
 }
+
+template class fformation::BasicPerson<double>;
+template class fformation::BasicPerson<float>;
@@ -16,25 +16,39 @@
 ********************************************************************/
 
 #pragma once
-#include "JsonSerializable.h"
 #include "PersonId.h"
 #include "Pose.h"
 #include "Settings.h"
+#include "VisibilityModel.h"
 
 namespace fformation {
 
-class Person : public JsonSerializable {
+/**
+ * @brief BasicPerson an identified pose with coordinates of type Scalar. Has
+ * no vtable, but owns the string of its id and is therefore not trivially
+ * copyable. Instantiated for double (Person) and float, which the EM
+ * detectors use in their single precision mode.
+ */
+template <typename Scalar> class BasicPerson {
 public:
   /**
    * @brief Stride the distance between a persons position and the center of its
    * transactional space.
    */
-  typedef Position2D::Coordinate Stride;
+  typedef Scalar Stride;
+  typedef BasicPosition2D<Scalar> Position;
 
-  Person(PersonId id, Pose2D pose) : _id(id), _pose(pose) {}
+  BasicPerson(PersonId id, BasicPose2D<Scalar> pose) : _id(id), _pose(pose) {}
+
+  /**
+   * @brief BasicPerson converts a person of another scalar type.
+   */
+  template <typename Other>
+  explicit BasicPerson(const BasicPerson<Other> &other)
+      : _id(other.id()), _pose(other.pose()) {}
 
   const PersonId &id() const { return _id; }
-  const Pose2D &pose() const { return _pose; }
+  const BasicPose2D<Scalar> &pose() const { return _pose; }
 
   /**
    * @brief calculateTransactionalSegmentPosition calculates the center of the
@@ -49,15 +63,11 @@ public:
    * actually used unit of scale and overall 'crowdedness' of the scene.
    * @return person-position + stride * viewing-direction
    */
-  static Position2D
-  calculateTransactionalSegmentPosition(const Position2D &position,
-                                        const RotationRadian &rotation,
+  static Position
+  calculateTransactionalSegmentPosition(const Position &position,
+                                        const Scalar &rotation,
                                         const Stride &stride);
 
-  static const RotationRadian visibilityAngleThreshold() {
-    return RotationRadian(0.75);
-  }
-
   /**
    * @brief calculateDistanceCosts calculates squared distance btw. this and the
    * passed group_center.
@@ -71,8 +81,8 @@ public:
    * segment.
    * @return (group_center - this.pose.position)^2
    */
-  double calculateDistanceCosts(const Position2D &group_center,
-                                Person::Stride stride) const;
+  Scalar calculateDistanceCosts(const Position &group_center,
+                                Stride stride) const;
 
   /**
    * @brief calculateVisibilityCost the visibility-constraint-costs caused by
@@ -83,14 +93,13 @@ public:
    *
    * Given \f$\theta_{i,j}^g\f$ being the angle btw. the persons relative to the
    * passed group center, \f$d_i^g\f$ the distance of this and \f$d_j^g\f$ the
-   * distance oth ther to the group center, \f$\hat\theta = 0.75\f$ and
-   * \f$K=100\f$. This fuction calculates:
+   * distance oth ther to the group center, \f$\hat\theta\f$ and \f$K\f$ the
+   * threshold and ln(k) of the VisibilityModel (0.75 and ln(100) by default).
+   * This fuction calculates:
    *
    * \f$ R = 0 \f$ if \f$cos(\theta_{i,j}^g) < \hat\theta\f$ or \f$d_i^g <
-   * d_j^g\f$ and in all other cases:
-   *
-   * We use the constants \f$\hat\theta=acos(0.75)\f$ and \f$K=ln(100)\f$ and
-   * the Formula from the original matlab code:
+   * d_j^g\f$ and in all other cases the Formula from the original matlab
+   * code:
    *
    * \f[ R = exp(K cos(\theta_{i,j}^g)) \frac{d_i^g}{d_j^g} \f]
    *
@@ -105,30 +114,36 @@ public:
    *
    * @param group_center the assumed center of a group this person may be in.
    * @param other the other person. not necessarily in the same group.
+   * @param model the visibility parameters
    * @return the cost of the occlusion produced by other btw. this and
    *         group_center.
    *         * 0. if other == this
    *         * 0. if other farther away from center than this
    *         * 0. if the cos of the angle btw. this and other rel. to the center
-   *           is bigger than 0.75 radians.
+   *           is bigger than the threshold of the model.
    *         * 0. if group_center == other.pose().position()
    *         * a cost value depending on the angles btw. the persons and their
    *           distancces to the group center
    */
-  double calculateVisibilityCost(const Position2D &group_center,
-                                 const Person &other) const;
-
-  virtual void serializeJson(std::ostream &out) const override {
-    out << "{ \"id\": " << _id;
-    out << ", \"pose\": " << _pose;
-    out << " }";
-  }
+  Scalar calculateVisibilityCost(
+      const Position &group_center, const BasicPerson &other,
+      const VisibilityModel &model = VisibilityModel::standard()) const;
 
 private:
   PersonId _id;
-  Pose2D _pose;
-  double _acos_of_theta = 0.75;
-  double _ln_of_k = 100;
+  BasicPose2D<Scalar> _pose;
 };
 
+extern template class BasicPerson<double>;
+extern template class BasicPerson<float>;
+
+typedef BasicPerson<double> Person;
+
+template <typename Stream, typename Scalar>
+void serializeJson(Stream &out, const BasicPerson<Scalar> &person) {
+  out << "{ \"id\": " << person.id();
+  out << ", \"pose\": " << person.pose();
+  out << " }";
+}
+
 } // namespace fformation
@@ -16,17 +16,24 @@
 ********************************************************************/
 
 #pragma once
-#include "JsonSerializable.h"
+#include "BufferedWriter.h"
+#include "OstreamPrinter.h"
 #include <sstream>
 
 namespace fformation {
 
-class PersonId : public JsonSerializable {
+/**
+ * @brief PersonId the string id of a person. Has no vtable, but owns its
+ * string and is therefore not trivially copyable.
+ */
+class PersonId {
 public:
   typedef std::string PersonIdType;
 
   PersonId(PersonIdType id) : _id(id) {}
 
+  const PersonIdType &value() const { return _id; }
+
   friend bool operator==(const PersonId &lhs, const PersonId &rhs) {
     return lhs._id == rhs._id;
   }
@@ -39,8 +46,6 @@ public:
     return lhs._id < rhs._id;
   }
 
-  virtual void serializeJson(std::ostream &out) const override { out << _id; }
-
   template <typename T> static PersonId from(T data) {
     std::stringstream str;
     str << data;
@@ -58,4 +63,9 @@ private:
   PersonIdType _id;
 };
 
+template <typename Stream>
+void serializeJson(Stream &out, const PersonId &id) {
+  out << id.value();
+}
+
 } // namespace fformation
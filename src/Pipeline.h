@@ -0,0 +1,154 @@
+/********************************************************************
+**                                                                 **
+** File   : src/Pipeline.h                                         **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "BoundedQueue.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief Pipeline runs a read -> process -> write chain on concurrent stages.
+ *
+ * A reader thread produces inputs, worker threads process them and the
+ * calling thread writes the outputs in input order. The stages are connected
+ * by BoundedQueues and at most capacity items are in flight, so reading and
+ * writing overlap with processing while the memory stays bounded. The first
+ * exception thrown by any stage stops the pipeline and is rethrown by run.
+ */
+template <typename Input, typename Output> class Pipeline {
+public:
+  /// fills the next input, returns false at the end of the input
+  typedef std::function<bool(Input &)> Reader;
+  /// processes an input on the worker with the passed index
+  typedef std::function<Output(Input &, size_t worker)> Processor;
+  /// receives the outputs in input order
+  typedef std::function<void(Output &)> Writer;
+
+  /**
+   * @param workers the number of processing threads. 0 = defaultThreads()
+   * @param capacity the maximal number of items in flight
+   */
+  Pipeline(size_t workers, size_t capacity = 256)
+      : _workers(workers == 0 ? Parallel::defaultThreads() : workers),
+        _capacity(std::max<size_t>(capacity, 1)) {}
+
+  size_t workers() const { return _workers; }
+
+  void run(const Reader &read, const Processor &process,
+           const Writer &write) const {
+    typedef std::pair<size_t, Input> In;
+    typedef std::pair<size_t, Output> Out;
+    BoundedQueue<In> inputs(_capacity);
+    BoundedQueue<Out> outputs(_capacity);
+    std::atomic<size_t> written(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto fail = [&]() {
+      {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+      failed = true;
+      // wake up the stages blocked on full queues
+      inputs.close();
+      outputs.close();
+    };
+
+    std::thread reader([&]() {
+      try {
+        In item;
+        for (item.first = 0; !failed && read(item.second); ++item.first) {
+          // limit the items in flight, the writer may wait for a slow one
+          while (!failed && item.first >= written + _capacity) {
+            std::this_thread::yield();
+          }
+          if (!inputs.push(std::move(item))) {
+            break;
+          }
+        }
+      } catch (...) {
+        fail();
+      }
+      inputs.close();
+    });
+
+    std::atomic<size_t> running(_workers);
+    std::vector<std::thread> workers;
+    workers.reserve(_workers);
+    for (size_t w = 0; w < _workers; ++w) {
+      workers.push_back(std::thread([&, w]() {
+        try {
+          In item;
+          while (!failed && inputs.pop(item)) {
+            if (!outputs.push(Out(item.first, process(item.second, w)))) {
+              break;
+            }
+          }
+        } catch (...) {
+          fail();
+        }
+        if (--running == 0) {
+          outputs.close();
+        }
+      }));
+    }
+
+    try {
+      // outputs that arrive before their predecessors wait here
+      std::map<size_t, Output> pending;
+      Out item;
+      while (!failed && outputs.pop(item)) {
+        pending.emplace(item.first, std::move(item.second));
+        for (auto it = pending.begin();
+             it != pending.end() && it->first == written;
+             it = pending.erase(it)) {
+          write(it->second);
+          ++written;
+        }
+      }
+    } catch (...) {
+      fail();
+    }
+
+    reader.join();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+private:
+  size_t _workers;
+  size_t _capacity;
+};
+
+} // namespace fformation
@@ -16,7 +16,6 @@
 ********************************************************************/
 
 #pragma once
-#include "JsonSerializable.h"
 #include "Position.h"
 #include <boost/optional.hpp>
 #include <boost/optional/optional_io.hpp>
@@ -26,24 +25,44 @@ namespace fformation {
 typedef double RotationRadian;
 typedef boost::optional<RotationRadian> OptionalRotationRadian;
 
-class Pose2D : public JsonSerializable {
+/**
+ * @brief BasicPose2D a trivially copyable position with an optional rotation
+ * of type Scalar. Instantiated for double (Pose2D) and float.
+ */
+template <typename Scalar> class BasicPose2D {
 public:
-  Pose2D(const Position2D &position = Position2D(0., 0.),
-         OptionalRotationRadian rotation_radian = OptionalRotationRadian(false,0.))
-      : _position(position), _rotation_radian(rotation_radian) {}
+  typedef boost::optional<Scalar> OptionalRotation;
 
-  const Position2D &position() const { return _position; }
-  const OptionalRotationRadian &rotation() const { return _rotation_radian; }
+  BasicPose2D(const BasicPosition2D<Scalar> &position =
+                  BasicPosition2D<Scalar>(0., 0.),
+              OptionalRotation rotation_radian = OptionalRotation())
+      : _position(position), _rotation_radian(rotation_radian) {}
 
-  virtual void serializeJson(std::ostream &out) const override {
-    out << "{ \"position\": ";
-    _position.serializeJson(out);
-    out << ", \"rotation_radian\": " << _rotation_radian << " }";
+  /**
+   * @brief BasicPose2D converts a pose of another scalar type.
+   */
+  template <typename Other>
+  explicit BasicPose2D(const BasicPose2D<Other> &other)
+      : _position(other.position()) {
+    if (other.rotation()) {
+      _rotation_radian = Scalar(other.rotation().get());
+    }
   }
 
+  const BasicPosition2D<Scalar> &position() const { return _position; }
+  const OptionalRotation &rotation() const { return _rotation_radian; }
+
 private:
-  Position2D _position;
-  OptionalRotationRadian _rotation_radian;
+  BasicPosition2D<Scalar> _position;
+  OptionalRotation _rotation_radian;
 };
 
+typedef BasicPose2D<double> Pose2D;
+
+template <typename Stream, typename Scalar>
+void serializeJson(Stream &out, const BasicPose2D<Scalar> &pose) {
+  out << "{ \"position\": " << pose.position()
+      << ", \"rotation_radian\": " << pose.rotation() << " }";
+}
+
 } // namespace fformation
@@ -19,12 +19,16 @@
 #include "cmath"
 #include <algorithm>
 
-using fformation::Position2D;
+using fformation::BasicPosition2D;
 
-const Position2D::Coordinate Position2D::dot(const Position2D &other) {
+template <typename Scalar>
+const Scalar BasicPosition2D<Scalar>::dot(const BasicPosition2D &other) {
   return (_x * other._x) + (_y * other._y);
 }
 
-double Position2D::norm() const {
-  return std::sqrt(std::pow(_x, 2) + std::pow(_y, 2));
+template <typename Scalar> Scalar BasicPosition2D<Scalar>::norm() const {
+  return std::sqrt(_x * _x + _y * _y);
 }
+
+template class fformation::BasicPosition2D<double>;
+template class fformation::BasicPosition2D<float>;
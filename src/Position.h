@@ -16,49 +16,61 @@
 ********************************************************************/
 
 #pragma once
-#include "JsonSerializable.h"
+#include "BufferedWriter.h"
+#include "OstreamPrinter.h"
 #include <ostream>
 
 namespace fformation {
 
-class Position2D : public JsonSerializable {
+/**
+ * @brief BasicPosition2D a trivially copyable 2D position with coordinates of
+ * type Scalar. Instantiated for double (Position2D) and float.
+ */
+template <typename Scalar> class BasicPosition2D {
 public:
-  typedef double Coordinate;
+  typedef Scalar Coordinate;
 
-  Position2D(const Coordinate x, const Coordinate y) : _x(x), _y(y) {}
+  BasicPosition2D(const Coordinate x, const Coordinate y) : _x(x), _y(y) {}
+
+  /**
+   * @brief BasicPosition2D converts the coordinates of another scalar type.
+   */
+  template <typename Other>
+  explicit BasicPosition2D(const BasicPosition2D<Other> &other)
+      : _x(Coordinate(other.x())), _y(Coordinate(other.y())) {}
 
   const Coordinate &x() const { return _x; }
   const Coordinate &y() const { return _y; }
-  const Coordinate dot(const Position2D &other);
+  const Coordinate dot(const BasicPosition2D &other);
 
-  double norm() const;
+  Coordinate norm() const;
 
-  Position2D normalized() const {
+  BasicPosition2D normalized() const {
     return *this / norm();
   }
 
-  Position2D perpendicular() const {
-    return Position2D(-_y,_x);
-  }
-
-  virtual void serializeJson(std::ostream &out) const override {
-    out << "{ \"x\": " << _x << ", \"y\": " << _y << " }";
+  BasicPosition2D perpendicular() const {
+    return BasicPosition2D(-_y,_x);
   }
 
-  friend Position2D operator+(const Position2D &a, const Position2D &b) {
-    return Position2D(a.x() + b.x(), a.y() + b.y());
+  friend BasicPosition2D operator+(const BasicPosition2D &a,
+                                   const BasicPosition2D &b) {
+    return BasicPosition2D(a.x() + b.x(), a.y() + b.y());
   }
 
-  friend Position2D operator-(const Position2D &a, const Position2D &b) {
-    return Position2D(a.x() - b.x(), a.y() - b.y());
+  friend BasicPosition2D operator-(const BasicPosition2D &a,
+                                   const BasicPosition2D &b) {
+    return BasicPosition2D(a.x() - b.x(), a.y() - b.y());
   }
 
-  friend Position2D operator/(const Position2D &a, const Coordinate &divisor) {
-    return Position2D(a.x() / divisor, a.y() / divisor);
+  friend BasicPosition2D operator/(const BasicPosition2D &a,
+                                   const Coordinate &divisor) {
+    return BasicPosition2D(a.x() / divisor, a.y() / divisor);
   }
 
-  friend Position2D operator*(const Position2D &a, const Coordinate &scale) {
-    return Position2D(a.x() * scale, a.y() * scale);
+  friend BasicPosition2D operator*(const BasicPosition2D &a,
+                                   const Coordinate &scale) {
+    return BasicPosition2D(a.x() * scale, a.y() * scale);
   }
 
 private:
@@ -66,4 +78,15 @@ private:
   Coordinate _y;
 };
 
+extern template class BasicPosition2D<double>;
+extern template class BasicPosition2D<float>;
+
+typedef BasicPosition2D<double> Position2D;
+
+template <typename Stream, typename Scalar>
+void serializeJson(Stream &out, const BasicPosition2D<Scalar> &position) {
+  out << "{ \"x\": " << position.x() << ", \"y\": " << position.y()
+      << " }";
+}
+
 } // namespace fformation
@@ -0,0 +1,218 @@
+/********************************************************************
+**                                                                 **
+** File   : src/ResultLog.cpp                                      **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "ResultLog.h"
+#include "BinaryIO.h"
+#include "Exception.h"
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+using fformation::ResultLog;
+using fformation::BinaryIO;
+using fformation::BufferedWriter;
+using fformation::Classification;
+using fformation::ConfusionMatrix;
+using fformation::DetectionStats;
+using fformation::Exception;
+using fformation::IdGroup;
+using fformation::PersonId;
+
+static const char magic[4] = {'F', 'F', 'R', 'L'};
+
+enum Record : uint8_t { PersonRecord = 1, FrameRecord = 2 };
+
+ResultLog::Writer::Writer(const std::string &path, double threshold,
+                          const std::vector<double> &thresholds)
+    : _file(new std::ofstream(path, std::ios::binary | std::ios::trunc)) {
+  Exception::check(_file->is_open(), "Cannot open result log " + path);
+  _out.reset(new BufferedWriter(*_file));
+  writeHeader(threshold, thresholds);
+}
+
+ResultLog::Writer::Writer(std::ostream &out, double threshold,
+                          const std::vector<double> &thresholds)
+    : _out(new BufferedWriter(out)) {
+  writeHeader(threshold, thresholds);
+}
+
+void ResultLog::Writer::writeHeader(double threshold,
+                                    const std::vector<double> &thresholds) {
+  _matrices = thresholds.size() + 1;
+  _out->write(magic, sizeof(magic));
+  BinaryIO::writeU32(*_out, version);
+  BinaryIO::writeF64(*_out, threshold);
+  BinaryIO::writeU32(*_out, uint32_t(thresholds.size()));
+  for (auto t : thresholds) {
+    BinaryIO::writeF64(*_out, t);
+  }
+}
+
+void ResultLog::Writer::intern(const Classification &classification) {
+  for (auto &group : classification.idGroups()) {
+    for (auto &person : group.persons()) {
+      if (_ids.find(person) != _ids.end()) {
+        continue;
+      }
+      uint32_t index = uint32_t(_ids.size());
+      _ids.insert(std::make_pair(person, index));
+      BinaryIO::writeU8(*_out, PersonRecord);
+      BinaryIO::writeString(*_out, person.value());
+    }
+  }
+}
+
+void ResultLog::Writer::writeGroups(const Classification &classification) {
+  BinaryIO::writeF64(*_out, classification.timestamp().time());
+  BinaryIO::writeVarint(*_out, classification.idGroups().size());
+  for (auto &group : classification.idGroups()) {
+    BinaryIO::writeVarint(*_out, group.persons().size());
+    for (auto &person : group.persons()) {
+      BinaryIO::writeVarint(*_out, _ids.at(person));
+    }
+  }
+}
+
+void ResultLog::Writer::write(
+    const Classification &ground_truth, const Classification &classification,
+    const std::vector<ConfusionMatrix> &confusion_matrices,
+    const DetectionStats *stats) {
+  Exception::check(confusion_matrices.size() == _matrices,
+                   "A result log frame needs one confusion matrix per "
+                   "threshold.");
+  intern(ground_truth);
+  intern(classification);
+  BinaryIO::writeU8(*_out, FrameRecord);
+  writeGroups(ground_truth);
+  writeGroups(classification);
+  for (auto &matrix : confusion_matrices) {
+    for (auto value : matrix.data()) {
+      BinaryIO::writeVarint(*_out, uint32_t(value));
+    }
+  }
+  BinaryIO::writeU8(*_out, stats != nullptr);
+  if (stats != nullptr) {
+    BinaryIO::writeVarint(*_out, stats->persons);
+    BinaryIO::writeVarint(*_out, stats->outer_iterations);
+    BinaryIO::writeVarint(*_out, stats->em_iterations);
+    BinaryIO::writeVarint(*_out, stats->cost_evaluations);
+    BinaryIO::writeVarint(*_out, stats->visibility_evaluations);
+    BinaryIO::writeU8(*_out, stats->converged);
+    BinaryIO::writeF64(*_out, stats->propose_seconds);
+    BinaryIO::writeF64(*_out, stats->em_seconds);
+    BinaryIO::writeF64(*_out, stats->cost_seconds);
+    BinaryIO::writeF64(*_out, stats->total_seconds);
+  }
+  ++_frames;
+}
+
+ResultLog::Reader::Reader(const std::string &path)
+    : _file(new std::ifstream(path, std::ios::binary)), _in(_file.get()) {
+  Exception::check(_file->is_open(), "Cannot open result log " + path);
+  readHeader();
+}
+
+ResultLog::Reader::Reader(std::istream &in) : _in(&in) { readHeader(); }
+
+void ResultLog::Reader::readHeader() {
+  char header[sizeof(magic)];
+  BinaryIO::readBytes(*_in, header, sizeof(header));
+  Exception::check(std::memcmp(header, magic, sizeof(magic)) == 0,
+                   "Not a result log.");
+  uint32_t log_version = BinaryIO::readU32(*_in);
+  Exception::check(log_version == version,
+                   "Unsupported result log version " +
+                       std::to_string(log_version));
+  _threshold = BinaryIO::readF64(*_in);
+  for (uint32_t i = BinaryIO::readU32(*_in); i > 0; --i) {
+    _thresholds.push_back(BinaryIO::readF64(*_in));
+  }
+}
+
+Classification ResultLog::Reader::readClassification() {
+  double timestamp = BinaryIO::readF64(*_in);
+  // counts are only trusted as far as the interned persons allow, a group
+  // holds distinct persons. A corrupt group count fails on the truncation.
+  uint64_t count = BinaryIO::readVarint(*_in);
+  std::vector<IdGroup> groups;
+  groups.reserve(size_t(std::min<uint64_t>(count, _ids.size())));
+  for (uint64_t g = 0; g < count; ++g) {
+    uint64_t size = BinaryIO::readVarint(*_in);
+    Exception::check(size <= _ids.size(),
+                     "Result log contains a group larger than its persons.");
+    IdGroup::Persons persons;
+    persons.reserve(size);
+    for (uint64_t i = 0; i < size; ++i) {
+      uint64_t index = BinaryIO::readVarint(*_in);
+      Exception::check(index < _ids.size(),
+                       "Result log references an unknown person.");
+      persons.insert(_ids[index]);
+    }
+    groups.push_back(IdGroup(std::move(persons)));
+  }
+  return Classification(timestamp, groups);
+}
+
+bool ResultLog::Reader::next(Frame &frame) {
+  while (true) {
+    int record = _in->get();
+    if (record == std::char_traits<char>::eof()) {
+      return false;
+    }
+    if (record == PersonRecord) {
+      _ids.push_back(PersonId(BinaryIO::readString(*_in)));
+      continue;
+    }
+    Exception::check(record == FrameRecord, "Result log is corrupt.");
+    frame.ground_truth = readClassification();
+    frame.classification = readClassification();
+    frame.confusion_matrices.resize(_thresholds.size() + 1);
+    for (auto &matrix : frame.confusion_matrices) {
+      std::array<ConfusionMatrix::IntType, 4> data;
+      for (auto &value : data) {
+        value = ConfusionMatrix::IntType(BinaryIO::readVarint(*_in));
+      }
+      matrix = ConfusionMatrix(data);
+    }
+    frame.stats = boost::none;
+    if (BinaryIO::readU8(*_in) != 0) {
+      DetectionStats stats;
+      stats.persons = BinaryIO::readVarint(*_in);
+      stats.outer_iterations = BinaryIO::readVarint(*_in);
+      stats.em_iterations = BinaryIO::readVarint(*_in);
+      stats.cost_evaluations = BinaryIO::readVarint(*_in);
+      stats.visibility_evaluations = BinaryIO::readVarint(*_in);
+      stats.converged = BinaryIO::readU8(*_in) != 0;
+      stats.propose_seconds = BinaryIO::readF64(*_in);
+      stats.em_seconds = BinaryIO::readF64(*_in);
+      stats.cost_seconds = BinaryIO::readF64(*_in);
+      stats.total_seconds = BinaryIO::readF64(*_in);
+      frame.stats = stats;
+    }
+    return true;
+  }
+}
+
+std::vector<ResultLog::Frame> ResultLog::read(const std::string &path) {
+  Reader reader(path);
+  std::vector<Frame> result;
+  Frame frame;
+  while (reader.next(frame)) {
+    result.push_back(frame);
+  }
+  return result;
+}
@@ -0,0 +1,146 @@
+/********************************************************************
+**                                                                 **
+** File   : src/ResultLog.h                                        **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "BufferedWriter.h"
+#include "Classification.h"
+#include "ConfusionMatrix.h"
+#include "DetectionStats.h"
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+
+namespace fformation {
+
+/**
+ * @brief ResultLog a compact binary log of the per frame results of an
+ * evaluation.
+ *
+ * The log starts with the intersection thresholds the confusion matrices were
+ * created with. Every frame stores the ground truth and the classification
+ * with their timestamps, one confusion matrix per threshold and optionally
+ * the DetectionStats of the detection. Person ids are interned: the first
+ * frame using an id is preceded by a record defining its index, frames only
+ * store the indices. Counts, indices and confusion counts are stored as
+ * varints, timestamps and durations as little endian doubles.
+ *
+ * Logs are written by Evaluation when the 'result_log' option is set and can
+ * be replayed by Evaluation to print or re-score a run without detection.
+ */
+class ResultLog {
+public:
+  static const uint32_t version = 2;
+
+  struct Frame {
+    Classification ground_truth;
+    Classification classification;
+    /// the matrix of threshold() followed by one per thresholds()
+    std::vector<ConfusionMatrix> confusion_matrices;
+    boost::optional<DetectionStats> stats;
+  };
+
+  class Writer {
+  public:
+    /**
+     * @brief Writer creates or truncates the file at path and writes the
+     * header.
+     */
+    Writer(const std::string &path, double threshold,
+           const std::vector<double> &thresholds);
+
+    /**
+     * @brief Writer writes the log to out. out must be opened in binary mode.
+     */
+    Writer(std::ostream &out, double threshold,
+           const std::vector<double> &thresholds);
+
+    /**
+     * @brief write appends a frame. confusion_matrices holds the matrix of
+     * the threshold followed by one per entry of thresholds.
+     */
+    void write(const Classification &ground_truth,
+               const Classification &classification,
+               const std::vector<ConfusionMatrix> &confusion_matrices,
+               const DetectionStats *stats = nullptr);
+    void write(const Frame &frame) {
+      write(frame.ground_truth, frame.classification,
+            frame.confusion_matrices, frame.stats.get_ptr());
+    }
+
+    /**
+     * @brief flush writes all buffered frames. The log is flushed on
+     * destruction too.
+     */
+    void flush() { _out->flush(); }
+
+    size_t frames() const { return _frames; }
+
+  private:
+    void writeHeader(double threshold, const std::vector<double> &thresholds);
+    void intern(const Classification &classification);
+    void writeGroups(const Classification &classification);
+
+    std::unique_ptr<std::ofstream> _file;
+    std::unique_ptr<BufferedWriter> _out;
+    std::map<PersonId, uint32_t> _ids;
+    size_t _matrices = 0;
+    size_t _frames = 0;
+  };
+
+  class Reader {
+  public:
+    /**
+     * @brief Reader opens the log at path and reads its header.
+     */
+    explicit Reader(const std::string &path);
+
+    /**
+     * @brief Reader reads the log from in. in must be opened in binary mode.
+     */
+    explicit Reader(std::istream &in);
+
+    double threshold() const { return _threshold; }
+    const std::vector<double> &thresholds() const { return _thresholds; }
+
+    /**
+     * @brief next reads the next frame.
+     *
+     * @return false at the end of the log
+     * @throws Exception when the log is truncated or corrupt
+     */
+    bool next(Frame &frame);
+
+  private:
+    void readHeader();
+    Classification readClassification();
+
+    std::unique_ptr<std::ifstream> _file;
+    std::istream *_in;
+    double _threshold = 0.;
+    std::vector<double> _thresholds;
+    std::vector<PersonId> _ids;
+  };
+
+  /**
+   * @brief read reads all frames of the log at path.
+   */
+  static std::vector<Frame> read(const std::string &path);
+};
+
+} // namespace fformation
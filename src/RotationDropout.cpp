@@ -0,0 +1,153 @@
+/********************************************************************
+**                                                                 **
+** File   : src/RotationDropout.cpp                                **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "RotationDropout.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using fformation::RotationDropout;
+using fformation::Observation;
+using fformation::Classification;
+using fformation::Options;
+using fformation::Option;
+using fformation::Exception;
+
+static size_t howManyToRemove(size_t with_size, size_t without_size,
+                              double proportion) {
+  // find out how many need to be removed to acchieve required proportion.
+  double remove =
+      double(with_size) - proportion * double(with_size + without_size);
+  if (remove <= 0.) {
+    return 0;
+  } else {
+    return std::round<size_t>(remove + 0.5); // always round up
+  }
+}
+
+RotationDropout::Mode RotationDropout::parseMode(const std::string &mode) {
+  if (mode == "keep") {
+    return Mode::Keep;
+  } else if (mode == "remove") {
+    return Mode::Remove;
+  } else if (mode == "group") {
+    return Mode::Group;
+  } else if (mode == "random") {
+    return Mode::Random;
+  }
+  throw Exception("Unknown config 'modify_rotations'='" + mode + "'");
+}
+
+RotationDropout::RotationDropout(const Observation &observation,
+                                 const Classification &ground_truth, Mode mode)
+    : _observation(observation), _mode(mode) {
+  if (mode != Mode::Random && mode != Mode::Group) {
+    return;
+  }
+  // Random uses a single unit, Group one per ground truth group. Persons
+  // that are not annotated are not part of a unit and dropped.
+  auto &groups = ground_truth.idGroups();
+  _units.resize(mode == Mode::Random ? 1 : groups.size());
+  _mask.resize(observation.size(), Observation::Visibility::Removed);
+  size_t position = 0;
+  for (auto &it : observation.group().persons()) {
+    size_t unit = 0;
+    if (mode == Mode::Group) {
+      while (unit < groups.size() && !groups[unit].has_person(it.first)) {
+        ++unit;
+      }
+    }
+    if (unit < _units.size()) {
+      _mask[position] = Observation::Visibility::Visible;
+      if (it.second.pose().rotation()) {
+        _units[unit].with_rotation.push_back(position);
+      } else {
+        ++_units[unit].without_rotation;
+      }
+    }
+    ++position;
+  }
+}
+
+Observation RotationDropout::apply(double proportion, size_t seed) const {
+  Exception::check(proportion >= 0. && proportion <= 1.,
+                   "The proportion must be between 0 and 1.");
+  switch (_mode) {
+  case Mode::Keep:
+    return _observation;
+  case Mode::Remove:
+    return _observation.masked(Observation::Mask(
+        _observation.size(), Observation::Visibility::WithoutRotation));
+  default:
+    break;
+  }
+  Observation::Mask mask = _mask;
+  std::vector<size_t> positions;
+  for (auto &unit : _units) {
+    positions = unit.with_rotation;
+    std::mt19937 generator(seed);
+    std::shuffle(positions.begin(), positions.end(), generator);
+    size_t num = std::min(howManyToRemove(unit.with_rotation.size(),
+                                          unit.without_rotation, proportion),
+                          positions.size());
+    for (size_t i = 0; i < num; ++i) {
+      mask[positions[i]] = Observation::Visibility::WithoutRotation;
+    }
+  }
+  return _observation.masked(std::move(mask));
+}
+
+const fformation::OptionSchema<RotationDropout::Parameters> &
+RotationDropout::Parameters::schema() {
+  static const OptionSchema<Parameters> schema =
+      OptionSchema<Parameters>()
+          .custom<Mode>("modify_rotations", &Parameters::mode,
+                        [](const Option &option) {
+                          return parseMode(option.value());
+                        })
+          .optional("modify_proportion", &Parameters::proportion,
+                    fformation::validators::MinMax<double>(0., 1.))
+          .optional("seed", &Parameters::seed);
+  return schema;
+}
+
+RotationDropout::Parameters
+RotationDropout::Parameters::parse(const Options &options) {
+  Parameters result = schema().parse(options);
+  if (result.mode == Mode::Group || result.mode == Mode::Random) {
+    Exception::check(result.proportion >= 0.,
+                     "Option 'modify_proportion' is required when rotations "
+                     "are modified.");
+  }
+  return result;
+}
+
+Observation RotationDropout::modify(const Observation &o,
+                                    const Classification &gt,
+                                    const Options &options) {
+  return modify(o, gt, Parameters::parse(options));
+}
+
+Observation RotationDropout::modify(const Observation &o,
+                                    const Classification &gt,
+                                    const Parameters &parameters) {
+  if (parameters.mode == Mode::Keep || parameters.mode == Mode::Remove) {
+    return RotationDropout(o, gt, parameters.mode).apply(0., 0);
+  }
+  return RotationDropout(o, gt, parameters.mode)
+      .apply(parameters.proportion, parameters.seed);
+}
@@ -0,0 +1,110 @@
+/********************************************************************
+**                                                                 **
+** File   : src/RotationDropout.h                                  **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "Classification.h"
+#include "Observation.h"
+#include "Options.h"
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief RotationDropout removes rotation information from the persons of an
+ * observation to simulate missing orientation estimates.
+ *
+ * The partition of the persons into units (all persons for Random, the ground
+ * truth groups for Group) and into persons with and without rotation does not
+ * depend on proportion and seed. It is calculated once on construction, so
+ * applying many proportion/seed combinations to the same observation is cheap.
+ * The modified observations are Observation::Mask overlays that share the
+ * person table of the original observation.
+ */
+class RotationDropout {
+public:
+  /**
+   * @brief Mode
+   *   * Keep: the observation is not modified
+   *   * Remove: all rotations are removed
+   *   * Group: rotations are removed in every ground truth group separately.
+   *     Persons that are not part of a ground truth group are dropped.
+   *   * Random: rotations are removed from randomly chosen persons
+   */
+  enum class Mode { Keep, Remove, Group, Random };
+
+  static Mode parseMode(const std::string &mode);
+
+  /**
+   * @brief Parameters the evaluation options modify_rotations,
+   * modify_proportion and seed. modify_proportion in [0, 1] is required for
+   * the Group and Random modes.
+   */
+  struct Parameters {
+    Mode mode = Mode::Keep;
+    double proportion = -1.;
+    size_t seed = 0;
+
+    static const OptionSchema<Parameters> &schema();
+    /**
+     * @brief parse parses and validates options once.
+     */
+    static Parameters parse(const Options &options);
+  };
+
+  RotationDropout(const Observation &observation,
+                  const Classification &ground_truth, Mode mode);
+
+  /**
+   * @brief apply creates the modified observation.
+   *
+   * @param proportion the proportion of persons in a unit that should keep
+   * their rotation, between 0 and 1.
+   * @param seed seeds the random choice of the persons.
+   */
+  Observation apply(double proportion, size_t seed) const;
+
+  /**
+   * @brief modify applies the modification configured by the evaluation
+   * options modify_rotations, modify_proportion and seed.
+   */
+  static Observation modify(const Observation &observation,
+                            const Classification &ground_truth,
+                            const Options &options);
+
+  /**
+   * @brief modify applies the modification described by already parsed
+   * parameters.
+   */
+  static Observation modify(const Observation &observation,
+                            const Classification &ground_truth,
+                            const Parameters &parameters);
+
+private:
+  /// positions of the persons in the observation mask
+  struct Unit {
+    std::vector<size_t> with_rotation;
+    size_t without_rotation = 0;
+  };
+
+  const Observation &_observation;
+  Mode _mode;
+  std::vector<Unit> _units;
+  /// the mask before removing rotations, drops persons outside of units
+  Observation::Mask _mask;
+};
+
+} // namespace fformation
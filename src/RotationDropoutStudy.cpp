@@ -0,0 +1,139 @@
+/********************************************************************
+**                                                                 **
+** File   : src/RotationDropoutStudy.cpp                           **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "RotationDropoutStudy.h"
+#include "GroupDetectorPool.h"
+#include "Parallel.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+using fformation::RotationDropoutStudy;
+using fformation::RunningStatistics;
+using fformation::ConfusionMatrix;
+
+RotationDropoutStudy::RotationDropoutStudy(const Features &features,
+                                           const GroundTruth &ground_truth,
+                                           RotationDropout::Mode mode,
+                                           double threshold)
+    : _threshold(threshold) {
+  Exception::check(mode == RotationDropout::Mode::Random ||
+                       mode == RotationDropout::Mode::Group,
+                   "A rotation dropout study needs random or group mode.");
+  auto ground_truths =
+      ground_truth.findClassifications(features.observations());
+  for (size_t i = 0; i < ground_truths.size(); ++i) {
+    auto &obs = features.observations()[i];
+    const Classification *gt = ground_truths[i];
+    if (gt != nullptr) {
+      try {
+        _dropouts.push_back(RotationDropout(obs, *gt, mode));
+        _ground_truths.push_back(*gt);
+      } catch (const Exception &e) {
+        std::cerr << "Observation modification failed: " << e.what()
+                  << std::endl;
+      }
+    }
+  }
+}
+
+std::vector<RotationDropoutStudy::Result>
+RotationDropoutStudy::run(const GroupDetector &detector,
+                          const std::vector<double> &proportions, size_t seeds,
+                          size_t first_seed, size_t threads) const {
+  struct Run {
+    double precision = 0.;
+    double recall = 0.;
+    size_t frames = 0;
+  };
+  for (double proportion : proportions) {
+    Exception::check(proportion >= 0. && proportion <= 1.,
+                     "The proportion must be between 0 and 1.");
+  }
+  std::vector<Run> runs(proportions.size() * seeds);
+  // every concurrent run uses its own clone of the detector
+  GroupDetectorPool pool(detector.clone());
+  Parallel::forEach(runs.size(), threads, [&](size_t i) {
+    double proportion = proportions[i / seeds];
+    size_t seed = first_seed + i % seeds;
+    Run &run = runs[i];
+    auto lease = pool.checkout();
+    for (size_t frame = 0; frame < _dropouts.size(); ++frame) {
+      try {
+        auto cm = lease->detect(_dropouts[frame].apply(proportion, seed))
+                      .createConfusionMatrix(_ground_truths[frame], _threshold);
+        run.precision += cm.calculatePrecision();
+        run.recall += cm.calculateRecall();
+        ++run.frames;
+      } catch (const Exception &e) {
+        std::cerr << "Classification failed: " << e.what() << std::endl;
+      }
+    }
+    if (run.frames > 0) {
+      run.precision /= double(run.frames);
+      run.recall /= double(run.frames);
+    }
+  });
+  std::vector<Result> results;
+  results.reserve(proportions.size());
+  for (size_t p = 0; p < proportions.size(); ++p) {
+    Result result;
+    result.proportion = proportions[p];
+    for (size_t s = 0; s < seeds; ++s) {
+      const Run &run = runs[p * seeds + s];
+      if (run.frames == 0) {
+        // nothing was evaluated, the run has no scores
+        ++result.empty_runs;
+        continue;
+      }
+      result.precision.add(run.precision);
+      result.recall.add(run.recall);
+      auto f1 = ConfusionMatrix::calculateF1Score(run.precision, run.recall);
+      // precision and recall of 0 leave the score undefined, it is the worst
+      result.f1.add(std::isnan(f1) ? 0. : f1);
+    }
+    results.push_back(result);
+  }
+  return results;
+}
+
+double RotationDropoutStudy::confidence(const RunningStatistics &statistics,
+                                        double z) {
+  if (statistics.count() < 2) {
+    return 0.;
+  }
+  return z * statistics.standardDeviation() /
+         std::sqrt(double(statistics.count()));
+}
+
+std::ostream &RotationDropoutStudy::printTable(
+    std::ostream &out, const std::vector<Result> &results, double z) {
+  const std::string s = "\t";
+  out << "proportion" << s << "seeds" << s << "empty" << s << "precision" << s
+      << "precision.ci" << s << "recall" << s << "recall.ci" << s << "f1"
+      << s << "f1.ci"
+      << "\n";
+  for (auto &result : results) {
+    out << std::setprecision(8) << std::fixed << result.proportion << s
+        << result.precision.count() << s << result.empty_runs << s
+        << result.precision.mean() << s
+        << confidence(result.precision, z) << s << result.recall.mean() << s
+        << confidence(result.recall, z) << s << result.f1.mean() << s
+        << confidence(result.f1, z) << "\n";
+  }
+  return out;
+}
@@ -0,0 +1,104 @@
+/********************************************************************
+**                                                                 **
+** File   : src/RotationDropoutStudy.h                             **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "Features.h"
+#include "GroundTruth.h"
+#include "GroupDetector.h"
+#include "RotationDropout.h"
+#include "RunningStatistics.h"
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief RotationDropoutStudy measures the robustness of a detector against
+ * missing rotations with a Monte-Carlo simulation.
+ *
+ * Every proportion is evaluated with many seeds. The mean precision, recall
+ * and F1 score of each run are aggregated per proportion.
+ */
+class RotationDropoutStudy {
+public:
+  /**
+   * @brief Result the aggregates of the runs of a proportion. Runs in which
+   * no frame could be evaluated are only counted in empty_runs.
+   */
+  struct Result {
+    double proportion;
+    RunningStatistics precision;
+    RunningStatistics recall;
+    /// runs with precision and recall of 0 score 0
+    RunningStatistics f1;
+    size_t empty_runs = 0;
+  };
+
+  /**
+   * @brief RotationDropoutStudy pairs observations and ground truth and
+   * prepares the rotation dropout of every frame.
+   *
+   * @param features the observations. must outlive this.
+   * @param ground_truth the annotations of the observations
+   * @param mode either RotationDropout::Mode::Random or Group
+   * @param threshold the group intersection threshold of a true positive
+   */
+  RotationDropoutStudy(const Features &features,
+                       const GroundTruth &ground_truth,
+                       RotationDropout::Mode mode, double threshold = 2. / 3.);
+
+  /**
+   * @brief run evaluates detector for every proportion with seeds different
+   * seeds in parallel.
+   *
+   * @param detector is cloned for every concurrent run.
+   * @param proportions the modify_proportion values to evaluate, each
+   * between 0 and 1
+   * @param seeds the number of runs per proportion
+   * @param first_seed the seeds first_seed, ..., first_seed + seeds - 1 are
+   * used
+   * @param threads the number of worker threads. 0 = hardware concurrency
+   * @return one result per proportion
+   */
+  std::vector<Result> run(const GroupDetector &detector,
+                          const std::vector<double> &proportions, size_t seeds,
+                          size_t first_seed = 0, size_t threads = 0) const;
+
+  /**
+   * @brief printTable prints the number of scored and empty runs, the mean
+   * and the half width of the confidence interval of precision, recall and
+   * F1 score per proportion.
+   *
+   * @param z the z-score of the confidence level. 1.96 = 95% assuming
+   * normally distributed run results.
+   */
+  static std::ostream &printTable(std::ostream &out,
+                                  const std::vector<Result> &results,
+                                  double z = 1.96);
+
+  /**
+   * @brief confidence the half width of the confidence interval of the mean.
+   */
+  static double confidence(const RunningStatistics &statistics,
+                           double z = 1.96);
+
+private:
+  double _threshold;
+  std::vector<Classification> _ground_truths;
+  std::vector<RotationDropout> _dropouts;
+};
+
+} // namespace fformation
@@ -0,0 +1,179 @@
+/********************************************************************
+**                                                                 **
+** File   : src/RunningStatistics.cpp                              **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "RunningStatistics.h"
+#include "Exception.h"
+#include <algorithm>
+#include <cmath>
+
+using fformation::RunningStatistics;
+using fformation::QuantileSketch;
+using fformation::RelativeQuantileSketch;
+using fformation::Exception;
+
+void RunningStatistics::add(double value) {
+  ++_count;
+  _sum += value;
+  double delta = value - _welford_mean;
+  _welford_mean += delta / double(_count);
+  _welford_m2 += delta * (value - _welford_mean);
+  _min = std::min(_min, value);
+  _max = std::max(_max, value);
+}
+
+double RunningStatistics::variance() const {
+  if (_count < 2) {
+    return 0.;
+  }
+  return _welford_m2 / double(_count - 1);
+}
+
+double RunningStatistics::standardDeviation() const {
+  return std::sqrt(variance());
+}
+
+RunningStatistics &RunningStatistics::
+operator+=(const RunningStatistics &other) {
+  if (other._count == 0) {
+    return *this;
+  }
+  if (_count == 0) {
+    *this = other;
+    return *this;
+  }
+  double count = double(_count + other._count);
+  double delta = other._welford_mean - _welford_mean;
+  _welford_mean += delta * double(other._count) / count;
+  _welford_m2 += other._welford_m2 +
+                 delta * delta * double(_count) * double(other._count) / count;
+  _count += other._count;
+  _sum += other._sum;
+  _min = std::min(_min, other._min);
+  _max = std::max(_max, other._max);
+  return *this;
+}
+
+QuantileSketch::QuantileSketch(double min, double max, size_t bins)
+    : _min(min), _max(max), _bins(bins, 0) {
+  Exception::check(min < max, "QuantileSketch needs min < max.");
+  Exception::check(bins > 0, "QuantileSketch needs at least one bin.");
+}
+
+void QuantileSketch::add(double value) {
+  double position = (value - _min) / (_max - _min) * double(_bins.size());
+  size_t bin = 0;
+  if (position >= double(_bins.size())) {
+    bin = _bins.size() - 1;
+  } else if (position > 0.) {
+    bin = size_t(position);
+  }
+  ++_bins[bin];
+  ++_count;
+}
+
+double QuantileSketch::quantile(double q) const {
+  if (_count == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  q = std::min(1., std::max(0., q));
+  double width = (_max - _min) / double(_bins.size());
+  double rank = q * double(_count);
+  size_t seen = 0;
+  for (size_t bin = 0; bin < _bins.size(); ++bin) {
+    if (_bins[bin] > 0 && double(seen + _bins[bin]) >= rank) {
+      // interpolate linearly inside of the bin
+      double inside = (rank - double(seen)) / double(_bins[bin]);
+      return _min + width * (double(bin) + std::max(0., inside));
+    }
+    seen += _bins[bin];
+  }
+  return _max;
+}
+
+QuantileSketch &QuantileSketch::operator+=(const QuantileSketch &other) {
+  Exception::check(_min == other._min && _max == other._max &&
+                       _bins.size() == other._bins.size(),
+                   "Only QuantileSketches of the same layout can be merged.");
+  for (size_t bin = 0; bin < _bins.size(); ++bin) {
+    _bins[bin] += other._bins[bin];
+  }
+  _count += other._count;
+  return *this;
+}
+
+RelativeQuantileSketch::RelativeQuantileSketch(double relative_error,
+                                               double min)
+    : _min(min), _gamma((1. + relative_error) / (1. - relative_error)),
+      _log_gamma(std::log(_gamma)) {
+  Exception::check(relative_error > 0. && relative_error < 1.,
+                   "RelativeQuantileSketch needs a relative error in (0, 1).");
+  Exception::check(min > 0., "RelativeQuantileSketch needs min > 0.");
+}
+
+void RelativeQuantileSketch::add(double value) {
+  if (value < _min) {
+    ++_zeros;
+  } else {
+    // bin i covers (min * gamma^(i-1), min * gamma^i]
+    ++_bins[long(std::ceil(std::log(value / _min) / _log_gamma))];
+  }
+  ++_count;
+  _lowest = std::min(_lowest, value);
+  _highest = std::max(_highest, value);
+}
+
+double RelativeQuantileSketch::quantile(double q) const {
+  if (_count == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  q = std::min(1., std::max(0., q));
+  size_t rank = size_t(q * double(_count - 1));
+  if (rank == 0) {
+    return _lowest;
+  }
+  if (rank == _count - 1) {
+    return _highest;
+  }
+  double value = 0.;
+  if (rank >= _zeros) {
+    size_t seen = _zeros;
+    for (auto &bin : _bins) {
+      seen += bin.second;
+      if (seen > rank) {
+        // the value with the same relative distance to both bin borders
+        value = 2. * _min * std::pow(_gamma, double(bin.first)) / (_gamma + 1.);
+        break;
+      }
+    }
+  }
+  return std::min(_highest, std::max(_lowest, value));
+}
+
+RelativeQuantileSketch &RelativeQuantileSketch::
+operator+=(const RelativeQuantileSketch &other) {
+  Exception::check(_min == other._min && _gamma == other._gamma,
+                   "Only RelativeQuantileSketches of the same layout can be "
+                   "merged.");
+  for (auto &bin : other._bins) {
+    _bins[bin.first] += bin.second;
+  }
+  _zeros += other._zeros;
+  _count += other._count;
+  _lowest = std::min(_lowest, other._lowest);
+  _highest = std::max(_highest, other._highest);
+  return *this;
+}
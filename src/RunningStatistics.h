@@ -0,0 +1,147 @@
+/********************************************************************
+**                                                                 **
+** File   : src/RunningStatistics.h                                **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief RunningStatistics aggregates a stream of values in constant memory.
+ *
+ * The mean is calculated as sum / count so it equals the mean of a stored
+ * sequence summed in the same order. The variance uses Welford's algorithm.
+ */
+class RunningStatistics {
+public:
+  void add(double value);
+
+  size_t count() const { return _count; }
+  double sum() const { return _sum; }
+  double min() const { return _min; }
+  double max() const { return _max; }
+
+  /**
+   * @brief mean sum / count. NaN if no values were added.
+   */
+  double mean() const { return _sum / double(_count); }
+
+  /**
+   * @brief variance the sample variance. 0 if less than two values were added.
+   */
+  double variance() const;
+
+  double standardDeviation() const;
+
+  /**
+   * @brief operator += merges the values aggregated by other into this.
+   */
+  RunningStatistics &operator+=(const RunningStatistics &other);
+
+private:
+  size_t _count = 0;
+  double _sum = 0.;
+  double _welford_mean = 0.;
+  double _welford_m2 = 0.;
+  double _min = std::numeric_limits<double>::infinity();
+  double _max = -std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief QuantileSketch approximates quantiles of a stream of values in
+ * constant memory.
+ *
+ * Values are counted in equally sized bins over [min, max]. Values outside of
+ * the range are counted in the first or last bin. The error of a quantile of
+ * values within the range is at most (max - min) / bins.
+ */
+class QuantileSketch {
+public:
+  QuantileSketch(double min = 0., double max = 1., size_t bins = 1000);
+
+  void add(double value);
+
+  size_t count() const { return _count; }
+
+  /**
+   * @brief quantile approximates the q-quantile of the added values.
+   * @param q btw. 0 and 1
+   * @return NaN if no values were added
+   */
+  double quantile(double q) const;
+
+  /**
+   * @brief operator += merges other into this. Both sketches must have the
+   * same range and number of bins.
+   */
+  QuantileSketch &operator+=(const QuantileSketch &other);
+
+private:
+  double _min;
+  double _max;
+  std::vector<size_t> _bins;
+  size_t _count = 0;
+};
+
+/**
+ * @brief RelativeQuantileSketch approximates quantiles of a stream of non
+ * negative values of unknown range with a bounded relative error.
+ *
+ * Values are counted in logarithmically growing bins, so a bin covers all
+ * values within relative_error of its center. Only used bins are stored and
+ * their number grows with the logarithm of max / min of the values, never
+ * with their count. Values below min are counted as 0. The 0- and 1-quantile
+ * are the exact smallest and largest added value, the other quantiles are
+ * clamped to their range.
+ */
+class RelativeQuantileSketch {
+public:
+  RelativeQuantileSketch(double relative_error = 0.01, double min = 1e-9);
+
+  void add(double value);
+
+  size_t count() const { return _count; }
+
+  /**
+   * @brief quantile approximates the q-quantile of the added values within
+   * the relative error.
+   * @param q btw. 0 and 1
+   * @return NaN if no values were added
+   */
+  double quantile(double q) const;
+
+  /**
+   * @brief operator += merges other into this. Both sketches must have the
+   * same relative error and min.
+   */
+  RelativeQuantileSketch &operator+=(const RelativeQuantileSketch &other);
+
+private:
+  double _min;
+  double _gamma;
+  double _log_gamma;
+  size_t _zeros = 0;
+  std::map<long, size_t> _bins;
+  size_t _count = 0;
+  double _lowest = std::numeric_limits<double>::infinity();
+  double _highest = -std::numeric_limits<double>::infinity();
+};
+
+} // namespace fformation
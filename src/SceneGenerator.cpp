@@ -0,0 +1,469 @@
+/********************************************************************
+**                                                                 **
+** File   : src/SceneGenerator.cpp                                 **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "SceneGenerator.h"
+#include "BinaryIO.h"
+#include "Exception.h"
+#include <boost/tokenizer.hpp>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <random>
+
+using fformation::SceneGenerator;
+using fformation::Features;
+using fformation::GroundTruth;
+using fformation::Settings;
+using fformation::Classification;
+using fformation::Observation;
+using fformation::Group;
+using fformation::IdGroup;
+using fformation::Person;
+using fformation::PersonId;
+using fformation::Options;
+using fformation::Option;
+using fformation::Exception;
+using fformation::BinaryIO;
+using fformation::BufferedWriter;
+
+namespace validators = fformation::validators;
+
+static const char scene_magic[4] = {'F', 'F', 'S', 'C'};
+static const uint32_t scene_version = 1;
+
+struct GeneratedGroup {
+  std::vector<size_t> members;
+  double x;
+  double y;
+  double vx;
+  double vy;
+};
+
+static std::vector<double> parseWeights(const Option &option) {
+  std::vector<double> result;
+  boost::char_separator<char> separator(",");
+  boost::tokenizer<boost::char_separator<char>> tokens(option.value(),
+                                                       separator);
+  for (auto token : tokens) {
+    result.push_back(Option(option.name(), token)
+                         .validate(validators::Min<double>(0.)));
+  }
+  return result;
+}
+
+SceneGenerator::Parameters
+SceneGenerator::Parameters::fromOptions(const Options &options) {
+  typedef SceneGenerator::Parameters P;
+  static const fformation::OptionSchema<P> schema =
+      fformation::OptionSchema<P>()
+          .optional("persons", &P::persons)
+          .optional("frames", &P::frames)
+          .custom<std::vector<double>>("group_size_weights",
+                                       &P::group_size_weights, parseWeights)
+          .optional("stride", &P::stride, validators::Min<double>(0.))
+          .optional("mdl", &P::mdl)
+          .optional("spacing", &P::spacing, validators::Min<double>(0.))
+          .optional("position_noise", &P::position_noise,
+                    validators::Min<double>(0.))
+          .optional("orientation_noise", &P::orientation_noise,
+                    validators::Min<double>(0.))
+          .optional("missing_rotation", &P::missing_rotation,
+                    validators::MinMax<double>(0., 1.))
+          .optional("speed", &P::speed, validators::Min<double>(0.))
+          .optional("frame_duration", &P::frame_duration,
+                    validators::Min<double>(0.))
+          .optional("seed", &P::seed);
+  return schema.parse(options);
+}
+
+/**
+ * Folds a travelled distance into [-limit, limit] as if bouncing between
+ * two walls.
+ */
+static double reflect(double distance, double limit) {
+  if (limit <= 0.) {
+    return 0.;
+  }
+  double folded = std::fmod(distance + limit, 4. * limit);
+  if (folded < 0.) {
+    folded += 4. * limit;
+  }
+  return (folded < 2. * limit ? folded : 4. * limit - folded) - limit;
+}
+
+static std::vector<GeneratedGroup>
+createGroups(const SceneGenerator::Parameters &parameters,
+             std::mt19937 &generator) {
+  Exception::check(!parameters.group_size_weights.empty(),
+                   "SceneGenerator needs at least one group size weight.");
+  std::discrete_distribution<size_t> size_distribution(
+      parameters.group_size_weights.begin(),
+      parameters.group_size_weights.end());
+  std::vector<GeneratedGroup> groups;
+  size_t person = 0;
+  while (person < parameters.persons) {
+    size_t size = std::min(size_distribution(generator) + 1,
+                           parameters.persons - person);
+    GeneratedGroup group;
+    for (size_t i = 0; i < size; ++i) {
+      group.members.push_back(person++);
+    }
+    groups.push_back(group);
+  }
+  // every group gets its own grid cell, so o-spaces never overlap
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  size_t columns = size_t(std::ceil(std::sqrt(double(groups.size()))));
+  double cell = 2. * parameters.stride + parameters.spacing;
+  for (size_t g = 0; g < groups.size(); ++g) {
+    groups[g].x = cell * double(g % columns);
+    groups[g].y = cell * double(g / columns);
+    double direction = 2. * M_PI * uniform(generator);
+    double speed = parameters.speed * uniform(generator);
+    groups[g].vx = speed * std::cos(direction);
+    groups[g].vy = speed * std::sin(direction);
+  }
+  return groups;
+}
+
+SceneGenerator::SceneGenerator(const Parameters &parameters)
+    : _settings({1., 0., 0., 0., 1., 0., 0., 0., 1.}, 0., parameters.stride,
+                20, 1., parameters.mdl, parameters.stride) {
+  std::mt19937 generator(parameters.seed);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::normal_distribution<double> position_noise(0., 1.);
+  std::normal_distribution<double> orientation_noise(0., 1.);
+
+  auto groups = createGroups(parameters, generator);
+  // the position on the circle and the rotation availability are fixed
+  std::vector<double> angles(parameters.persons);
+  std::vector<bool> has_rotation(parameters.persons);
+  for (auto &group : groups) {
+    double offset = 2. * M_PI * uniform(generator);
+    for (size_t i = 0; i < group.members.size(); ++i) {
+      angles[group.members[i]] =
+          offset + 2. * M_PI * double(i) / double(group.members.size());
+    }
+  }
+  for (size_t p = 0; p < parameters.persons; ++p) {
+    has_rotation[p] = uniform(generator) >= parameters.missing_rotation;
+  }
+
+  std::vector<IdGroup> id_groups;
+  for (auto &group : groups) {
+    if (group.members.size() > 1) {
+      IdGroup::Persons ids;
+      ids.reserve(group.members.size());
+      for (auto member : group.members) {
+        ids.insert(PersonId::from(member + 1));
+      }
+      id_groups.push_back(IdGroup(std::move(ids)));
+    }
+  }
+
+  std::vector<Observation> observations;
+  std::vector<Classification> classifications;
+  observations.reserve(parameters.frames);
+  classifications.reserve(parameters.frames);
+  for (size_t frame = 0; frame < parameters.frames; ++frame) {
+    double time = double(frame) * parameters.frame_duration;
+    std::vector<Person> persons;
+    persons.reserve(parameters.persons);
+    for (auto &group : groups) {
+      // groups bounce inside their cell, so they never meet
+      double cx = group.x + reflect(time * group.vx, parameters.spacing / 2.);
+      double cy = group.y + reflect(time * group.vy, parameters.spacing / 2.);
+      bool alone = group.members.size() == 1;
+      for (auto member : group.members) {
+        double radius = alone ? 0. : parameters.stride;
+        double x = cx + radius * std::cos(angles[member]) +
+                   parameters.position_noise * position_noise(generator);
+        double y = cy + radius * std::sin(angles[member]) +
+                   parameters.position_noise * position_noise(generator);
+        double rotation =
+            alone ? angles[member]
+                  : std::atan2(cy - y, cx - x) +
+                        parameters.orientation_noise *
+                            orientation_noise(generator);
+        auto optional_rotation = fformation::OptionalRotationRadian();
+        if (has_rotation[member]) {
+          optional_rotation = std::remainder(rotation, 2. * M_PI);
+        }
+        persons.push_back(
+            Person(PersonId::from(member + 1), {{x, y}, optional_rotation}));
+      }
+    }
+    observations.push_back(Observation(time, Group(persons)));
+    classifications.push_back(Classification(time, id_groups));
+  }
+  _features = Features(observations);
+  _ground_truth = GroundTruth(classifications);
+}
+
+void SceneGenerator::writeFeatures(std::ostream &out,
+                                   const Features &features) {
+  out.precision(std::numeric_limits<double>::max_digits10);
+  out << "{\"features\": [";
+  bool first_frame = true;
+  for (auto &observation : features.observations()) {
+    out << (first_frame ? "[" : ", [");
+    first_frame = false;
+    bool first_person = true;
+    for (auto &person : observation.group().persons()) {
+      out << (first_person ? "[" : ", [");
+      first_person = false;
+      out << person.first << ", " << person.second.pose().position().x() << ", "
+          << person.second.pose().position().y();
+      if (person.second.pose().rotation()) {
+        out << ", " << person.second.pose().rotation().get();
+      }
+      out << "]";
+    }
+    out << "]";
+  }
+  out << "], \"timestamp\": [";
+  first_frame = true;
+  for (auto &observation : features.observations()) {
+    out << (first_frame ? "" : ", ") << observation.timestamp().time();
+    first_frame = false;
+  }
+  out << "]}";
+}
+
+void SceneGenerator::writeGroundTruth(std::ostream &out,
+                                      const GroundTruth &ground_truth) {
+  out.precision(std::numeric_limits<double>::max_digits10);
+  out << "{\"GTgroups\": [";
+  bool first_frame = true;
+  for (auto &classification : ground_truth.classifications()) {
+    out << (first_frame ? "[" : ", [");
+    first_frame = false;
+    bool first_group = true;
+    for (auto &group : classification.idGroups()) {
+      out << (first_group ? "[" : ", [");
+      first_group = false;
+      bool first_person = true;
+      for (auto &id : group.persons()) {
+        out << (first_person ? "" : ", ") << id;
+        first_person = false;
+      }
+      out << "]";
+    }
+    out << "]";
+  }
+  out << "], \"GTtimestamp\": [";
+  first_frame = true;
+  for (auto &classification : ground_truth.classifications()) {
+    out << (first_frame ? "" : ", ") << classification.timestamp().time();
+    first_frame = false;
+  }
+  out << "]}";
+}
+
+void SceneGenerator::writeSettings(std::ostream &out,
+                                   const Settings &settings) {
+  out.precision(std::numeric_limits<double>::max_digits10);
+  auto &m = settings.covariance_matrix();
+  out << "{\"params\": {\"covmat\": [[" << m[0] << ", " << m[1] << ", " << m[2]
+      << "], [" << m[3] << ", " << m[4] << ", " << m[5] << "], [" << m[6]
+      << ", " << m[7] << ", " << m[8] << "]], \"empty\": " << settings.empty()
+      << ", \"radius\": " << settings.radius()
+      << ", \"nsamples\": " << settings.nsamples()
+      << ", \"quant\": " << settings.quant() << "}, \"mdl\": " << settings.mdl()
+      << ", \"stride\": " << settings.stride() << "}";
+}
+
+void SceneGenerator::writeMatlabJson(const std::string &path) const {
+  std::ofstream features(path + "/features.json");
+  Exception::check(features.good(),
+                   "Could not open " + path + "/features.json for writing.");
+  writeFeatures(features, _features);
+  std::ofstream ground_truth(path + "/groundtruth.json");
+  Exception::check(ground_truth.good(), "Could not open " + path +
+                                            "/groundtruth.json for writing.");
+  writeGroundTruth(ground_truth, _ground_truth);
+  std::ofstream settings(path + "/settings.json");
+  Exception::check(settings.good(),
+                   "Could not open " + path + "/settings.json for writing.");
+  writeSettings(settings, _settings);
+}
+
+static uint32_t internId(std::map<PersonId, uint32_t> &ids,
+                         std::vector<const PersonId *> &table,
+                         const PersonId &id) {
+  auto inserted = ids.insert(std::make_pair(id, uint32_t(ids.size())));
+  if (inserted.second) {
+    table.push_back(&inserted.first->first);
+  }
+  return inserted.first->second;
+}
+
+void SceneGenerator::writeBinary(std::ostream &out, const Features &features,
+                                 const GroundTruth &ground_truth,
+                                 const Settings &settings) {
+  std::map<PersonId, uint32_t> ids;
+  std::vector<const PersonId *> table;
+  for (auto &observation : features.observations()) {
+    for (auto &person : observation.group().persons()) {
+      internId(ids, table, person.first);
+    }
+  }
+  for (auto &classification : ground_truth.classifications()) {
+    for (auto &group : classification.idGroups()) {
+      for (auto &id : group.persons()) {
+        internId(ids, table, id);
+      }
+    }
+  }
+
+  BufferedWriter writer(out);
+  writer.write(scene_magic, sizeof(scene_magic));
+  BinaryIO::writeU32(writer, scene_version);
+  for (auto value : settings.covariance_matrix()) {
+    BinaryIO::writeF64(writer, value);
+  }
+  BinaryIO::writeF64(writer, settings.empty());
+  BinaryIO::writeF64(writer, settings.radius());
+  BinaryIO::writeVarint(writer, settings.nsamples());
+  BinaryIO::writeF64(writer, settings.quant());
+  BinaryIO::writeF64(writer, settings.mdl());
+  BinaryIO::writeF64(writer, settings.stride());
+
+  BinaryIO::writeVarint(writer, table.size());
+  for (auto id : table) {
+    BinaryIO::writeString(writer, id->value());
+  }
+  BinaryIO::writeVarint(writer, features.observations().size());
+  for (auto &observation : features.observations()) {
+    auto &persons = observation.group().persons();
+    BinaryIO::writeF64(writer, observation.timestamp().time());
+    BinaryIO::writeVarint(writer, persons.size());
+    for (auto &person : persons) {
+      auto &pose = person.second.pose();
+      BinaryIO::writeVarint(writer, ids.at(person.first));
+      BinaryIO::writeF64(writer, pose.position().x());
+      BinaryIO::writeF64(writer, pose.position().y());
+      BinaryIO::writeU8(writer, bool(pose.rotation()));
+      if (pose.rotation()) {
+        BinaryIO::writeF64(writer, pose.rotation().get());
+      }
+    }
+  }
+  BinaryIO::writeVarint(writer, ground_truth.classifications().size());
+  for (auto &classification : ground_truth.classifications()) {
+    BinaryIO::writeF64(writer, classification.timestamp().time());
+    BinaryIO::writeVarint(writer, classification.idGroups().size());
+    for (auto &group : classification.idGroups()) {
+      BinaryIO::writeVarint(writer, group.persons().size());
+      for (auto &id : group.persons()) {
+        BinaryIO::writeVarint(writer, ids.at(id));
+      }
+    }
+  }
+}
+
+void SceneGenerator::writeBinary(const std::string &path) const {
+  std::ofstream out(path + "/scene.bin", std::ios::binary | std::ios::trunc);
+  Exception::check(out.good(),
+                   "Could not open " + path + "/scene.bin for writing.");
+  writeBinary(out, _features, _ground_truth, _settings);
+}
+
+static const PersonId &readIndex(std::istream &in,
+                                 const std::vector<PersonId> &ids) {
+  uint64_t index = BinaryIO::readVarint(in);
+  Exception::check(index < ids.size(),
+                   "Binary scene references an unknown person.");
+  return ids[index];
+}
+
+SceneGenerator::Scene SceneGenerator::readBinary(std::istream &in) {
+  char header[sizeof(scene_magic)];
+  BinaryIO::readBytes(in, header, sizeof(header));
+  Exception::check(std::memcmp(header, scene_magic, sizeof(scene_magic)) == 0,
+                   "Not a binary scene.");
+  uint32_t version = BinaryIO::readU32(in);
+  Exception::check(version == scene_version,
+                   "Unsupported binary scene version " +
+                       std::to_string(version));
+  Scene scene;
+  Settings::Matrix3D covariance_matrix;
+  for (auto &value : covariance_matrix) {
+    value = BinaryIO::readF64(in);
+  }
+  scene.settings.covariance_matrix(covariance_matrix);
+  scene.settings.empty(BinaryIO::readF64(in));
+  scene.settings.radius(BinaryIO::readF64(in));
+  scene.settings.nsamples(BinaryIO::readVarint(in));
+  scene.settings.quant(BinaryIO::readF64(in));
+  scene.settings.mdl(BinaryIO::readF64(in));
+  scene.settings.stride(BinaryIO::readF64(in));
+
+  // counts are not trusted for reservations, a corrupt count ends in a
+  // truncation error instead of a huge allocation
+  std::vector<PersonId> ids;
+  for (uint64_t i = BinaryIO::readVarint(in); i > 0; --i) {
+    ids.push_back(PersonId(BinaryIO::readString(in)));
+  }
+  std::vector<Observation> observations;
+  for (uint64_t i = BinaryIO::readVarint(in); i > 0; --i) {
+    double time = BinaryIO::readF64(in);
+    uint64_t size = BinaryIO::readVarint(in);
+    Exception::check(size <= ids.size(),
+                     "Binary scene contains more persons than ids.");
+    std::vector<Person> persons;
+    persons.reserve(size);
+    for (uint64_t p = 0; p < size; ++p) {
+      const PersonId &id = readIndex(in, ids);
+      double x = BinaryIO::readF64(in);
+      double y = BinaryIO::readF64(in);
+      auto rotation = fformation::OptionalRotationRadian();
+      if (BinaryIO::readU8(in) != 0) {
+        rotation = BinaryIO::readF64(in);
+      }
+      persons.push_back(Person(id, {{x, y}, rotation}));
+    }
+    observations.push_back(Observation(time, Group(persons)));
+  }
+  std::vector<Classification> classifications;
+  for (uint64_t i = BinaryIO::readVarint(in); i > 0; --i) {
+    double time = BinaryIO::readF64(in);
+    std::vector<IdGroup> groups;
+    for (uint64_t g = BinaryIO::readVarint(in); g > 0; --g) {
+      uint64_t size = BinaryIO::readVarint(in);
+      Exception::check(size <= ids.size(),
+                       "Binary scene contains more persons than ids.");
+      IdGroup::Persons members;
+      members.reserve(size);
+      for (uint64_t p = 0; p < size; ++p) {
+        members.insert(readIndex(in, ids));
+      }
+      groups.push_back(IdGroup(std::move(members)));
+    }
+    classifications.push_back(Classification(time, groups));
+  }
+  scene.features = Features(observations);
+  scene.ground_truth = GroundTruth(classifications);
+  return scene;
+}
+
+SceneGenerator::Scene SceneGenerator::readBinary(const std::string &filename) {
+  std::ifstream in(filename, std::ios::binary);
+  Exception::check(in.is_open(), "Could not open " + filename);
+  return readBinary(in);
+}
@@ -0,0 +1,131 @@
+/********************************************************************
+**                                                                 **
+** File   : src/SceneGenerator.h                                   **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "Features.h"
+#include "GroundTruth.h"
+#include "Options.h"
+#include "Settings.h"
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief SceneGenerator creates synthetic features and the matching ground
+ * truth.
+ *
+ * Persons are partitioned into groups once. Every group is placed in its own
+ * cell of a grid and its members stand on a circle of radius stride around
+ * the o-space center, facing it. The groups drift with a constant random
+ * velocity over the frames. Singletons look in a random direction. The result
+ * only depends on the parameters, so the same seed always creates the same
+ * scene.
+ */
+class SceneGenerator {
+public:
+  struct Parameters {
+    /// the number of persons in every frame
+    size_t persons = 20;
+    /// the number of frames
+    size_t frames = 1;
+    /// the relative frequency of the group sizes 1, 2, 3, ...
+    std::vector<double> group_size_weights = {1., 4., 3., 2., 1.};
+    /// the distance of the persons to their o-space center
+    double stride = 0.7;
+    /// the minimum description length written to the settings
+    double mdl = 2.;
+    /// the free space between the cells of two groups
+    double spacing = 1.5;
+    /// the standard deviation of the position noise in meters
+    double position_noise = 0.05;
+    /// the standard deviation of the orientation noise in radian
+    double orientation_noise = 0.2;
+    /// the proportion of persons without rotation information
+    double missing_rotation = 0.;
+    /// the maximal speed of a group in meters per second
+    double speed = 0.;
+    /// the time between two frames in seconds
+    double frame_duration = 1.;
+    size_t seed = 0;
+
+    /**
+     * @brief fromOptions reads the parameters from options with the same
+     * names. group_size_weights is a comma separated list. Missing options
+     * keep their default value.
+     */
+    static Parameters fromOptions(const Options &options);
+  };
+
+  /**
+   * @brief Scene the content of a dataset.
+   */
+  struct Scene {
+    Features features;
+    GroundTruth ground_truth;
+    Settings settings;
+  };
+
+  SceneGenerator(const Parameters &parameters);
+
+  const Features &features() const { return _features; }
+  const GroundTruth &groundTruth() const { return _ground_truth; }
+  const Settings &settings() const { return _settings; }
+
+  /**
+   * @brief writeMatlabJson writes features.json, groundtruth.json and
+   * settings.json to path in the format read by the readMatlabJson functions.
+   * The files are streamed, no json document is built in memory.
+   */
+  void writeMatlabJson(const std::string &path) const;
+
+  static void writeFeatures(std::ostream &out, const Features &features);
+  static void writeGroundTruth(std::ostream &out,
+                               const GroundTruth &ground_truth);
+  static void writeSettings(std::ostream &out, const Settings &settings);
+
+  /**
+   * @brief writeBinary writes the scene to path/scene.bin.
+   *
+   * The binary scene holds the settings, the features and the ground truth.
+   * Person ids are stored once in a table and referenced by index, counts and
+   * indices are varints and coordinates little endian doubles, so the file is
+   * several times smaller and faster to read than the json files.
+   */
+  void writeBinary(const std::string &path) const;
+
+  /**
+   * @brief writeBinary writes a binary scene to out. out must be opened in
+   * binary mode.
+   */
+  static void writeBinary(std::ostream &out, const Features &features,
+                          const GroundTruth &ground_truth,
+                          const Settings &settings);
+
+  /**
+   * @brief readBinary reads a scene written by writeBinary.
+   * @throws Exception when the file is truncated or corrupt
+   */
+  static Scene readBinary(const std::string &filename);
+  static Scene readBinary(std::istream &in);
+
+private:
+  Features _features;
+  GroundTruth _ground_truth;
+  Settings _settings;
+};
+
+} // namespace fformation
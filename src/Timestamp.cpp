@@ -21,9 +21,20 @@
 
 using fformation::Timestamp;
 
-void Timestamp::serializeJson(std::ostream &out) const {
+void fformation::serializeJson(std::ostream &out,
+                               const Timestamp &timestamp) {
   std::stringstream s;
   s.precision(std::numeric_limits<double>::max_digits10);
-  s << std::scientific << _timestamp;
+  s << std::scientific << timestamp.time();
   out << s.str();
 }
+
+void fformation::serializeJson(BufferedWriter &out,
+                               const Timestamp &timestamp) {
+  auto format = out.format();
+  auto precision = out.precision();
+  out.format(BufferedWriter::Format::Scientific)
+          .precision(std::numeric_limits<double>::max_digits10)
+      << timestamp.time();
+  out.format(format).precision(precision);
+}
@@ -16,13 +16,17 @@
 ********************************************************************/
 
 #pragma once
-#include "JsonSerializable.h"
+#include "BufferedWriter.h"
+#include "OstreamPrinter.h"
 #include <cmath>
 #include <limits>
 
 namespace fformation {
 
-class Timestamp : public JsonSerializable {
+/**
+ * @brief Timestamp a trivially copyable point in time in seconds.
+ */
+class Timestamp {
 public:
   typedef double TimestampType;
 
@@ -47,10 +51,15 @@ public:
            std::numeric_limits<TimestampType>::epsilon();
   }
 
-  virtual void serializeJson(std::ostream &out) const override;
-
 private:
   double _timestamp;
 };
 
+/**
+ * @brief serializeJson writes the time in scientific notation with all
+ * significant digits.
+ */
+void serializeJson(std::ostream &out, const Timestamp &timestamp);
+void serializeJson(BufferedWriter &out, const Timestamp &timestamp);
+
 } // namespace fformation
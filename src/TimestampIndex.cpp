@@ -0,0 +1,95 @@
+/********************************************************************
+**                                                                 **
+** File   : src/TimestampIndex.cpp                                 **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "TimestampIndex.h"
+#include "Exception.h"
+#include <algorithm>
+#include <numeric>
+
+using fformation::TimestampIndex;
+using fformation::Timestamp;
+using fformation::Exception;
+
+const size_t TimestampIndex::npos;
+
+TimestampIndex::TimestampIndex(const std::vector<Timestamp> &timestamps,
+                               Timestamp::TimestampType tolerance)
+    : _tolerance(tolerance), _positions(timestamps.size()) {
+  std::iota(_positions.begin(), _positions.end(), 0);
+  std::stable_sort(_positions.begin(), _positions.end(),
+                   [&timestamps](size_t a, size_t b) {
+                     return timestamps[a].time() < timestamps[b].time();
+                   });
+  _times.reserve(timestamps.size());
+  for (auto position : _positions) {
+    _times.push_back(timestamps[position].time());
+  }
+  for (size_t i = 1; i < _times.size(); ++i) {
+    Exception::check(_times[i] - _times[i - 1] >= _tolerance,
+                     "Timestamps of an index must not match each other.");
+  }
+}
+
+size_t TimestampIndex::closest(size_t i,
+                               Timestamp::TimestampType timestamp) const {
+  // the entries are at least tolerance apart, at most two can match
+  size_t result = npos;
+  auto best = _tolerance;
+  for (size_t end = std::min(i + 2, _times.size()); i < end; ++i) {
+    auto distance = std::fabs(_times[i] - timestamp);
+    if (distance < best) {
+      best = distance;
+      result = _positions[i];
+    }
+  }
+  return result;
+}
+
+size_t TimestampIndex::find(const Timestamp &timestamp) const {
+  auto it = std::lower_bound(_times.begin(), _times.end(),
+                             timestamp.time() - _tolerance);
+  return closest(size_t(it - _times.begin()), timestamp.time());
+}
+
+std::vector<size_t>
+TimestampIndex::match(const std::vector<Timestamp> &queries) const {
+  std::vector<size_t> result(queries.size(), npos);
+  bool sorted = std::is_sorted(queries.begin(), queries.end());
+  size_t i = 0;
+  for (size_t q = 0; q < queries.size(); ++q) {
+    auto time = queries[q].time();
+    if (!sorted) {
+      result[q] = find(time);
+      continue;
+    }
+    while (i < _times.size() && _times[i] < time - _tolerance) {
+      ++i;
+    }
+    result[q] = closest(i, time);
+  }
+  return result;
+}
+
+std::vector<size_t> TimestampIndex::range(const Timestamp &begin,
+                                          const Timestamp &end) const {
+  auto first = std::lower_bound(_times.begin(), _times.end(),
+                                begin.time() - _tolerance);
+  auto last =
+      std::upper_bound(first, _times.end(), end.time() + _tolerance);
+  return std::vector<size_t>(_positions.begin() + (first - _times.begin()),
+                             _positions.begin() + (last - _times.begin()));
+}
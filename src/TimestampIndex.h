@@ -0,0 +1,80 @@
+/********************************************************************
+**                                                                 **
+** File   : src/TimestampIndex.h                                   **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "Timestamp.h"
+#include <cstddef>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief TimestampIndex a sorted, contiguous index over a sequence of
+ * timestamps.
+ *
+ * Two timestamps match when they differ by less than the tolerance, which
+ * defaults to the epsilon of Timestamp::equals. Lookups return the position of
+ * the closest matching timestamp in the indexed sequence. Timestamps of the
+ * sequence must not match each other.
+ */
+class TimestampIndex {
+public:
+  static const size_t npos = size_t(-1);
+
+  /**
+   * @brief TimestampIndex sorts the timestamps.
+   * @throws Exception if two timestamps match each other
+   */
+  TimestampIndex(const std::vector<Timestamp> &timestamps =
+                     std::vector<Timestamp>(),
+                 Timestamp::TimestampType tolerance =
+                     std::numeric_limits<Timestamp::TimestampType>::epsilon());
+
+  size_t size() const { return _times.size(); }
+  Timestamp::TimestampType tolerance() const { return _tolerance; }
+
+  /**
+   * @brief find binary searches the closest timestamp within the tolerance.
+   * @return its position in the indexed sequence or npos
+   */
+  size_t find(const Timestamp &timestamp) const;
+
+  /**
+   * @brief match finds every query. Sorted queries are matched with a single
+   * linear merge join, unsorted ones with a binary search each.
+   * @return the position of the match for every query, npos if there is none
+   */
+  std::vector<size_t> match(const std::vector<Timestamp> &queries) const;
+
+  /**
+   * @brief range the positions of all timestamps in [begin, end] (widened by
+   * the tolerance) in time order.
+   */
+  std::vector<size_t> range(const Timestamp &begin,
+                            const Timestamp &end) const;
+
+private:
+  /// the closest match at or after sorted position i, which must be the first
+  /// time >= timestamp - tolerance
+  size_t closest(size_t i, Timestamp::TimestampType timestamp) const;
+
+  Timestamp::TimestampType _tolerance;
+  std::vector<Timestamp::TimestampType> _times;
+  std::vector<size_t> _positions;
+};
+
+} // namespace fformation
@@ -0,0 +1,169 @@
+/********************************************************************
+**                                                                 **
+** File   : src/Trace.cpp                                          **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+using fformation::Trace;
+
+std::atomic<bool> Trace::_enabled(false);
+
+namespace {
+
+struct Buffer {
+  std::vector<Trace::Event> events;
+  size_t next = 0;
+  bool wrapped = false;
+  size_t thread = 0;
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  size_t capacity = 1 << 16;
+  // incremented by enable(), threads then replace their buffer
+  std::atomic<size_t> generation{0};
+  std::chrono::steady_clock::time_point start;
+};
+
+Registry &registry() {
+  static Registry instance;
+  return instance;
+}
+
+} // namespace
+
+static std::shared_ptr<Buffer> createBuffer() {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto buffer = std::make_shared<Buffer>();
+  buffer->events.resize(reg.capacity);
+  buffer->thread = reg.buffers.size();
+  reg.buffers.push_back(buffer);
+  return buffer;
+}
+
+void Trace::enable(size_t capacity) {
+  Registry &reg = registry();
+  {
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.buffers.clear();
+    reg.capacity = std::max<size_t>(capacity, 1);
+    reg.start = std::chrono::steady_clock::now();
+    ++reg.generation;
+  }
+  _enabled.store(true);
+}
+
+void Trace::disable() { _enabled.store(false); }
+
+void Trace::record(const char *name, const char *category, Phase phase,
+                   std::initializer_list<Argument> arguments) {
+  // the registry lock is only taken when a thread starts tracing. The
+  // thread keeps its buffer alive, so a concurrent enable() is harmless.
+  static thread_local std::shared_ptr<Buffer> buffer;
+  static thread_local size_t generation = 0;
+  Registry &reg = registry();
+  size_t current = reg.generation.load();
+  if (!buffer || generation != current) {
+    buffer = createBuffer();
+    generation = current;
+  }
+  Event &event = buffer->events[buffer->next];
+  event.name = name;
+  event.category = category;
+  event.phase = phase;
+  event.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - reg.start)
+                   .count();
+  event.thread = buffer->thread;
+  event.argument_count = 0;
+  for (auto &argument : arguments) {
+    if (event.argument_count == max_arguments) {
+      break;
+    }
+    event.arguments[event.argument_count++] = argument;
+  }
+  if (++buffer->next == buffer->events.size()) {
+    buffer->next = 0;
+    buffer->wrapped = true;
+  }
+}
+
+std::vector<Trace::Event> Trace::events() {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::vector<Event> result;
+  for (auto &buffer : reg.buffers) {
+    if (buffer->wrapped) {
+      result.insert(result.end(), buffer->events.begin() + buffer->next,
+                    buffer->events.end());
+    }
+    result.insert(result.end(), buffer->events.begin(),
+                  buffer->events.begin() + buffer->next);
+  }
+  std::stable_sort(result.begin(), result.end(),
+                   [](const Event &lhs, const Event &rhs) {
+                     return lhs.time < rhs.time;
+                   });
+  return result;
+}
+
+static void writeJsonNumber(std::ostream &out, double value) {
+  if (std::isfinite(value)) {
+    out << value;
+  } else {
+    out << "null";
+  }
+}
+
+void Trace::writeChromeJson(std::ostream &out) {
+  auto flags = out.flags();
+  auto precision = out.precision(std::numeric_limits<double>::max_digits10);
+  out << "{\"traceEvents\": [";
+  bool first = true;
+  for (auto &event : events()) {
+    out << (first ? "\n  " : ",\n  ");
+    first = false;
+    out << "{\"name\": \"" << event.name << "\", \"cat\": \"" << event.category
+        << "\", \"ph\": \"" << char(event.phase)
+        << "\", \"ts\": " << std::fixed << std::setprecision(3)
+        << double(event.time) / 1000. << std::defaultfloat
+        << std::setprecision(std::numeric_limits<double>::max_digits10)
+        << ", \"pid\": 0, \"tid\": " << event.thread;
+    if (event.phase == Phase::Instant) {
+      out << ", \"s\": \"t\"";
+    }
+    if (event.argument_count > 0) {
+      out << ", \"args\": {";
+      for (size_t a = 0; a < event.argument_count; ++a) {
+        out << (a ? ", \"" : "\"") << event.arguments[a].name << "\": ";
+        writeJsonNumber(out, event.arguments[a].value);
+      }
+      out << "}";
+    }
+    out << "}";
+  }
+  out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+  out.flags(flags);
+  out.precision(precision);
+}
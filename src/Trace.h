@@ -0,0 +1,127 @@
+/********************************************************************
+**                                                                 **
+** File   : src/Trace.h                                            **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace fformation {
+
+/**
+ * @brief Trace records structured events into per-thread ring buffers.
+ *
+ * Tracing is switched on and off at runtime. When it is off recording costs a
+ * single relaxed atomic load. Every thread writes into its own ring buffer, so
+ * recording never takes a lock. When a buffer is full the oldest events are
+ * overwritten. Names and argument names must be string literals (or live at
+ * least as long as the trace).
+ *
+ * The recorded events can be written in the Chrome trace event format and
+ * viewed with chrome://tracing or https://ui.perfetto.dev.
+ */
+class Trace {
+public:
+  enum class Phase : char { Begin = 'B', End = 'E', Instant = 'i' };
+
+  struct Argument {
+    const char *name;
+    double value;
+  };
+
+  static const size_t max_arguments = 4;
+
+  struct Event {
+    const char *name;
+    const char *category;
+    Phase phase;
+    /// nanoseconds since the trace was enabled
+    uint64_t time;
+    size_t thread;
+    size_t argument_count;
+    Argument arguments[max_arguments];
+  };
+
+  static bool enabled() { return _enabled.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief enable starts recording. Previously recorded events are dropped.
+   * @param capacity the number of events kept per thread.
+   */
+  static void enable(size_t capacity = 1 << 16);
+  static void disable();
+
+  /**
+   * @brief record adds an event to the ring buffer of the calling thread.
+   * At most max_arguments arguments are kept.
+   */
+  static void record(const char *name, const char *category, Phase phase,
+                     std::initializer_list<Argument> arguments = {});
+
+  static void instant(const char *name, const char *category,
+                      std::initializer_list<Argument> arguments = {}) {
+    if (enabled()) {
+      record(name, category, Phase::Instant, arguments);
+    }
+  }
+
+  /**
+   * @brief events returns the recorded events of all threads ordered by time.
+   * Should only be called while no other thread records events.
+   */
+  static std::vector<Event> events();
+
+  /**
+   * @brief writeChromeJson writes the recorded events as Chrome trace event
+   * json.
+   */
+  static void writeChromeJson(std::ostream &out);
+
+  /**
+   * @brief Scope records a Begin event on construction and the matching End
+   * event on destruction.
+   */
+  class Scope {
+  public:
+    Scope(const char *name, const char *category,
+          std::initializer_list<Argument> arguments = {})
+        : _name(name), _category(category), _active(enabled()) {
+      if (_active) {
+        record(_name, _category, Phase::Begin, arguments);
+      }
+    }
+    ~Scope() {
+      if (_active) {
+        record(_name, _category, Phase::End);
+      }
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    const char *_name;
+    const char *_category;
+    bool _active;
+  };
+
+private:
+  static std::atomic<bool> _enabled;
+};
+
+} // namespace fformation
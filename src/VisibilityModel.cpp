@@ -0,0 +1,65 @@
+/********************************************************************
+**                                                                 **
+** File   : src/VisibilityModel.cpp                                **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "VisibilityModel.h"
+
+using fformation::Exception;
+using fformation::Option;
+using fformation::OptionSchema;
+using fformation::VisibilityModel;
+
+VisibilityModel::Mode VisibilityModel::parseMode(const std::string &mode) {
+  if (mode == "exact") {
+    return Mode::Exact;
+  } else if (mode == "approximate") {
+    return Mode::Approximate;
+  }
+  throw Exception("Unknown config 'visibility_mode'='" + mode + "'");
+}
+
+const OptionSchema<VisibilityModel::Parameters> &
+VisibilityModel::Parameters::schema() {
+  static const OptionSchema<Parameters> schema =
+      OptionSchema<Parameters>()
+          .optional("visibility_threshold", &Parameters::threshold,
+                    fformation::validators::MinMax<double>(-1., 1.))
+          .optional("visibility_k", &Parameters::k,
+                    fformation::validators::Min<double>(0., true))
+          .custom<Mode>("visibility_mode", &Parameters::mode,
+                        [](const Option &option) {
+                          return parseMode(option.value());
+                        });
+  return schema;
+}
+
+VisibilityModel::Parameters
+VisibilityModel::Parameters::parse(const Options &options) {
+  return schema().parse(options);
+}
+
+VisibilityModel::VisibilityModel() : VisibilityModel(Parameters()) {}
+
+VisibilityModel::VisibilityModel(const Parameters &parameters)
+    : _parameters(parameters), _log_k(std::log(parameters.k)),
+      _log_max_cost(std::log(max_cost())) {
+  Exception::check(parameters.k > 0., "visibility_k must be positive.");
+}
+
+const VisibilityModel &VisibilityModel::standard() {
+  static const VisibilityModel model;
+  return model;
+}
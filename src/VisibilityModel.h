@@ -0,0 +1,116 @@
+/********************************************************************
+**                                                                 **
+** File   : src/VisibilityModel.h                                  **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "Options.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace fformation {
+
+/**
+ * @brief VisibilityModel the parameters of the visibility constraint, shared
+ * by all persons a detector evaluates.
+ *
+ * An occluder at the cosine c of the angle to the group center and the
+ * distance ratio r costs k^(c * r), capped at max_cost(). Persons are only
+ * occluded by others below the cosine threshold. log(k) is calculated once,
+ * so the kernel is a single exp. In Approximate mode the exp is replaced by
+ * a polynomial with a relative error below 3e-7.
+ *
+ * The options visibility_threshold (default 0.75), visibility_k (default
+ * 100) and visibility_mode (exact | approximate) configure the model.
+ */
+class VisibilityModel {
+public:
+  enum class Mode { Exact, Approximate };
+
+  static Mode parseMode(const std::string &mode);
+
+  struct Parameters {
+    double threshold = 0.75;
+    double k = 100.;
+    Mode mode = Mode::Exact;
+
+    static const OptionSchema<Parameters> &schema();
+    static Parameters parse(const Options &options);
+  };
+
+  VisibilityModel();
+  explicit VisibilityModel(const Parameters &parameters);
+
+  /**
+   * @brief standard the model with the constants of the original matlab code.
+   */
+  static const VisibilityModel &standard();
+
+  const Parameters &parameters() const { return _parameters; }
+  double threshold() const { return _parameters.threshold; }
+
+  static double max_cost() { return 10000000.; }
+
+  /**
+   * @brief cost k^exponent, capped at max_cost(). Calculated in the precision
+   * of Scalar.
+   */
+  template <typename Scalar> Scalar cost(Scalar exponent) const {
+    Scalar y = Scalar(_log_k) * exponent;
+    if (y >= Scalar(_log_max_cost)) {
+      return Scalar(max_cost());
+    }
+    Scalar result = _parameters.mode == Mode::Exact
+                        ? std::exp(y)
+                        : Scalar(approximateExp(y));
+    return std::min(result, Scalar(max_cost()));
+  }
+
+  /**
+   * @brief approximateExp e^y for y <= log(max_cost()) with a relative error
+   * below 3e-7. Returns 0 for y < -708.
+   */
+  static double approximateExp(double y) {
+    if (y < -708.) {
+      return 0.;
+    }
+    // y = n * ln(2) + r with |r| <= ln(2) / 2. adding and subtracting 1.5 *
+    // 2^52 rounds to the nearest integer without a call to nearbyint.
+    const double shift = 6755399441055744.;
+    double n = (y * 1.4426950408889634 + shift) - shift;
+    double r = y - n * 0.6931471805599453;
+    // e^r by its taylor polynomial of degree 6
+    double p =
+        1. +
+        r * (1. +
+             r * (1. / 2. +
+                  r * (1. / 6. +
+                       r * (1. / 24. + r * (1. / 120. + r * (1. / 720.))))));
+    // 2^n from the exponent bits
+    uint64_t bits = uint64_t(int64_t(n) + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+  }
+
+private:
+  Parameters _parameters;
+  double _log_k;
+  double _log_max_cost;
+};
+
+} // namespace fformation
@@ -0,0 +1,135 @@
+/********************************************************************
+**                                                                 **
+** File   : support/AllocationTracker.h                            **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace fformation {
+
+/**
+ * @brief AllocationTracker counts the calls of the global operator new and
+ * new[] and the requested bytes of all threads, including the allocations
+ * inside the library.
+ *
+ * The counting operator new/delete are only compiled into the translation unit
+ * that defines FFORMATION_TRACK_ALLOCATIONS before including this header.
+ * Exactly one translation unit of an executable must do so. Without it the
+ * counters stay 0.
+ */
+class AllocationTracker {
+public:
+  struct Count {
+    size_t allocations = 0;
+    size_t bytes = 0;
+  };
+
+  static std::atomic<size_t> &allocations() {
+    static std::atomic<size_t> counter(0);
+    return counter;
+  }
+
+  static std::atomic<size_t> &bytes() {
+    static std::atomic<size_t> counter(0);
+    return counter;
+  }
+
+  static Count current() {
+    Count result;
+    result.allocations = allocations().load();
+    result.bytes = bytes().load();
+    return result;
+  }
+
+  /**
+   * @brief measure returns the allocations done by function.
+   */
+  template <typename Function> static Count measure(Function function) {
+    Count before = current();
+    function();
+    Count after = current();
+    Count result;
+    result.allocations = after.allocations - before.allocations;
+    result.bytes = after.bytes - before.bytes;
+    return result;
+  }
+};
+
+} // namespace fformation
+
+#ifdef FFORMATION_TRACK_ALLOCATIONS
+// Every replaced allocation function has its matching deallocation function,
+// so no pointer of the malloc heap reaches a default operator delete. The
+// helpers are not inlined: the optimizer would otherwise see malloc and free
+// behind new and delete, report them as mismatched and may elide pairs.
+#if defined(__GNUC__)
+#define FFORMATION_NOINLINE __attribute__((noinline))
+#else
+#define FFORMATION_NOINLINE
+#endif
+
+static FFORMATION_NOINLINE void *trackedAllocate(std::size_t size) noexcept {
+  ++fformation::AllocationTracker::allocations();
+  fformation::AllocationTracker::bytes() += size;
+  return std::malloc(size ? size : 1);
+}
+
+static FFORMATION_NOINLINE void trackedFree(void *pointer) noexcept {
+  std::free(pointer);
+}
+
+void *operator new(std::size_t size) {
+  void *result = trackedAllocate(size);
+  if (result == nullptr) {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+void *operator new[](std::size_t size) {
+  void *result = trackedAllocate(size);
+  if (result == nullptr) {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return trackedAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return trackedAllocate(size);
+}
+
+void operator delete(void *pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void *pointer) noexcept { trackedFree(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept {
+  trackedFree(pointer);
+}
+void operator delete[](void *pointer, std::size_t) noexcept {
+  trackedFree(pointer);
+}
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+  trackedFree(pointer);
+}
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+  trackedFree(pointer);
+}
+#endif
@@ -0,0 +1,135 @@
+/********************************************************************
+**                                                                 **
+** File   : test/Allocations.cpp                                   **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#define FFORMATION_TRACK_ALLOCATIONS
+#include "AllocationTracker.h"
+#include "../src/Evaluation.h"
+#include "../src/GroupDetectorFactory.h"
+#include "../src/SceneGenerator.h"
+#include "gtest/gtest.h"
+#include <iostream>
+
+using fformation::AllocationTracker;
+using fformation::Evaluation;
+using fformation::GroupDetectorFactory;
+using fformation::Options;
+using fformation::SceneGenerator;
+
+/*
+ * The upper bounds are the allocations per frame (or per call) measured when
+ * the bounds were set plus some headroom. Lower them when an optimization
+ * removes allocations.
+ */
+
+namespace {
+
+class NullBuffer : public std::streambuf {
+protected:
+  virtual int overflow(int c) override { return c; }
+};
+
+SceneGenerator scene() {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 12;
+  parameters.frames = 10;
+  parameters.missing_rotation = 0.25;
+  parameters.seed = 7;
+  return SceneGenerator(parameters);
+}
+
+void report(const std::string &component, const AllocationTracker::Count &count,
+            double calls) {
+  std::cout << component << ": " << double(count.allocations) / calls
+            << " allocations, " << double(count.bytes) / calls
+            << " bytes per call" << std::endl;
+}
+
+TEST(Allocations, Counting) {
+  // new expressions may be elided by the optimizer, direct calls may not
+  auto count = AllocationTracker::measure(
+      []() { ::operator delete(::operator new(sizeof(int))); });
+  EXPECT_EQ(1u, count.allocations);
+  EXPECT_EQ(sizeof(int), count.bytes);
+  count = AllocationTracker::measure(
+      []() { ::operator delete[](::operator new[](16)); });
+  EXPECT_EQ(1u, count.allocations);
+  EXPECT_EQ(16u, count.bytes);
+}
+
+TEST(Allocations, Detect) {
+  auto generated = scene();
+  auto &observations = generated.features().observations();
+  std::map<std::string, double> bounds = {{"none", 50.},
+                                          {"one", 45.},
+                                          {"grow", 3400.},
+                                          {"shrink", 3700.},
+                                          {"shrink2", 4800.}};
+  for (auto &bound : bounds) {
+    auto detector = GroupDetectorFactory::getDefaultInstance().create(
+        bound.first + "@mdl=2@stride=0.7");
+    auto count = AllocationTracker::measure([&]() {
+      for (auto &observation : observations) {
+        detector->detect(observation);
+      }
+    });
+    report("detect/" + bound.first, count, observations.size());
+    EXPECT_LE(double(count.allocations) / observations.size(), bound.second)
+        << bound.first;
+  }
+}
+
+TEST(Allocations, ConfusionMatrix) {
+  auto generated = scene();
+  auto detector =
+      GroupDetectorFactory::getDefaultInstance().create("grow@mdl=2@stride=0.7");
+  auto &observations = generated.features().observations();
+  auto &ground_truth = generated.groundTruth().classifications();
+  std::vector<fformation::Classification> classifications;
+  for (auto &observation : observations) {
+    classifications.push_back(detector->detect(observation));
+  }
+  auto count = AllocationTracker::measure([&]() {
+    for (size_t i = 0; i < classifications.size(); ++i) {
+      classifications[i].createConfusionMatrix(ground_truth[i], 2. / 3.);
+    }
+  });
+  report("createConfusionMatrix", count, classifications.size());
+  EXPECT_LE(double(count.allocations) / classifications.size(), 260.);
+}
+
+TEST(Allocations, Printers) {
+  auto generated = scene();
+  auto detector =
+      GroupDetectorFactory::getDefaultInstance().create("grow@mdl=2@stride=0.7");
+  NullBuffer buffer;
+  std::ostream out(&buffer);
+  std::map<std::string, double> bounds = {{"matlab", 30.},
+                                          {"tsv", 5.},
+                                          {"tsv_participants", 500.}};
+  for (auto &bound : bounds) {
+    Evaluation evaluation(
+        generated.features(), generated.groundTruth(), generated.settings(),
+        *detector, Options::parseFromString("evaluation_printer=" + bound.first));
+    auto count =
+        AllocationTracker::measure([&]() { evaluation.printOutput(out); });
+    double frames = evaluation.classifications().size();
+    report("printer/" + bound.first, count, frames);
+    EXPECT_LE(double(count.allocations) / frames, bound.second) << bound.first;
+  }
+}
+
+} // namespace
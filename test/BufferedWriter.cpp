@@ -0,0 +1,146 @@
+/********************************************************************
+**                                                                 **
+** File   : test/BufferedWriter.cpp                                **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "BufferedWriter.h"
+#include "Classification.h"
+#include "Timestamp.h"
+#include <boost/optional/optional_io.hpp>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace {
+using fformation::BufferedWriter;
+using fformation::Classification;
+using fformation::Group;
+using fformation::IdGroup;
+using fformation::Person;
+using fformation::PersonId;
+using fformation::Pose2D;
+using fformation::Position2D;
+using fformation::Timestamp;
+
+static const std::vector<double> doubles = {
+    0.,   -0.,         1.,    -1.,    0.1,   1. / 3.,    2. / 3.,    123456.,
+    1e-7, 1234567.891, 1e21,  -1e-21, 0.5,   0.0000125,  29.6000001, 1e300,
+    std::numeric_limits<double>::infinity(),
+    std::numeric_limits<double>::quiet_NaN()};
+
+static void writeAll(std::ostream &out) {
+  for (auto value : doubles) {
+    out << value << "\t";
+  }
+  out << "\n";
+}
+
+static void writeAll(BufferedWriter &out) {
+  for (auto value : doubles) {
+    out << value << "\t";
+  }
+  out << "\n";
+}
+
+TEST(BufferedWriterTest, Doubles) {
+  std::ostringstream expected;
+  std::ostringstream actual;
+  {
+    BufferedWriter writer(actual);
+    writeAll(expected);
+    writeAll(writer);
+    expected << std::setprecision(8) << std::fixed;
+    writer.precision(8).format(BufferedWriter::Format::Fixed);
+    writeAll(expected);
+    writeAll(writer);
+    expected << std::setprecision(17) << std::scientific;
+    writer.precision(17).format(BufferedWriter::Format::Scientific);
+    writeAll(expected);
+    writeAll(writer);
+  }
+  EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST(BufferedWriterTest, Integers) {
+  std::ostringstream expected;
+  std::ostringstream actual;
+  {
+    BufferedWriter writer(actual);
+    for (long long value : {0ll, 1ll, -1ll, 42ll, -1234567890123ll,
+                            std::numeric_limits<long long>::min(),
+                            std::numeric_limits<long long>::max()}) {
+      expected << value << " ";
+      writer << value << " ";
+    }
+    expected << std::numeric_limits<unsigned long>::max() << " " << int(-7)
+             << " " << 7u << " " << true << false;
+    writer << std::numeric_limits<unsigned long>::max() << " " << int(-7)
+           << " " << 7u << " " << true << false;
+  }
+  EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST(BufferedWriterTest, Optional) {
+  std::ostringstream expected;
+  std::ostringstream actual;
+  {
+    BufferedWriter writer(actual);
+    boost::optional<double> empty;
+    boost::optional<double> value(0.25);
+    expected << empty << value;
+    writer << empty << value;
+  }
+  EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST(BufferedWriterTest, LargeWrites) {
+  std::string small(1000, 'a');
+  std::string large(3 * BufferedWriter::chunk_size + 17, 'b');
+  std::ostringstream actual;
+  {
+    BufferedWriter writer(actual);
+    for (size_t i = 0; i < 100; ++i) {
+      writer << small;
+    }
+    writer << large << small;
+    writer.flush();
+    EXPECT_EQ(101 * small.size() + large.size(), actual.str().size());
+  }
+  EXPECT_EQ(std::string(100000, 'a') + large + small, actual.str());
+}
+
+TEST(BufferedWriterTest, Serializable) {
+  Group group(std::vector<Person>{
+      Person(PersonId("1"), Pose2D(Position2D(1., 2.))),
+      Person(PersonId("2"), Pose2D(Position2D(2., 3.), 0.5))});
+  Classification classification(
+      Timestamp(29.6), {IdGroup({PersonId("1"), PersonId("2")}),
+                        IdGroup({PersonId("3")})});
+  std::ostringstream expected;
+  expected << classification << " " << group << " "
+           << classification.timestamp() << " " << 0.125;
+  std::ostringstream actual;
+  {
+    BufferedWriter writer(actual);
+    writer << classification << " " << group << " "
+           << classification.timestamp() << " " << 0.125;
+  }
+  EXPECT_EQ(expected.str(), actual.str());
+}
+
+} // namespace
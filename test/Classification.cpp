@@ -177,4 +177,73 @@ TEST(ClassificationTest, confusionMatrix) {
   EXPECT_EQ(1, cm.false_positive());
   EXPECT_EQ(0, cm.false_negative());
 }
+
+TEST(ClassificationTest, confusionMatrices) {
+  std::vector<double> thresholds = {0., 0.5, 0.6, 2. / 3., 0.75, 1.};
+  typedef std::array<ConfusionMatrix::IntType, 4> Counts; // tp, fp, tn, fn
+  struct Case {
+    Classification classification;
+    Classification ground_truth;
+    std::vector<Counts> expected; // one per threshold
+  };
+  std::vector<Case> cases = {
+      {ccl({}), ccl({}), std::vector<Counts>(6, {0, 0, 0, 0})},
+      // all three persons are missed
+      {ccl({}), ccl({{1, 2, 3}}), std::vector<Counts>(6, {0, 0, 0, 3})},
+      // intersection 1/2
+      {ccl({{1, 2}, {3}}),
+       ccl({}),
+       {{1, 0, 1, 0},
+        {1, 0, 1, 0},
+        {0, 1, 1, 0},
+        {0, 1, 1, 0},
+        {0, 1, 1, 0},
+        {0, 1, 1, 0}}},
+      // intersection 1/3, persons 4, 5 and 6 are missed
+      {ccl({{1, 2, 3}}),
+       ccl({{4, 5, 6}}),
+       {{1, 0, 0, 3},
+        {0, 1, 0, 3},
+        {0, 1, 0, 3},
+        {0, 1, 0, 3},
+        {0, 1, 0, 3},
+        {0, 1, 0, 3}}},
+      // intersections 1, 2/3 and 1/2, persons 8 and 9 are missed
+      {ccl({{1, 2}, {3, 4, 5}, {6, 7}}),
+       ccl({{1, 2}, {3, 4}, {8, 9}}),
+       {{3, 0, 0, 2},
+        {3, 0, 0, 2},
+        {2, 1, 0, 2},
+        {2, 1, 0, 2},
+        {1, 2, 0, 2},
+        {1, 2, 0, 2}}},
+      // intersections 2/3, 1 and 1/2, persons 6 and 7 are alone
+      {ccl({{1, 10, 2}, {3, 4, 5}, {6}, {7}, {8, 9}}),
+       ccl({{1, 2}, {3, 4, 5}}),
+       {{3, 0, 2, 0},
+        {3, 0, 2, 0},
+        {2, 1, 2, 0},
+        {2, 1, 2, 0},
+        {1, 2, 2, 0},
+        {1, 2, 2, 0}}},
+      // intersections 3/4 and 3/4
+      {ccl({{1, 2, 3, 4}, {5, 6, 7}}),
+       ccl({{1, 2, 3}, {4, 5, 6, 7}}),
+       {{2, 0, 0, 0},
+        {2, 0, 0, 0},
+        {2, 0, 0, 0},
+        {2, 0, 0, 0},
+        {2, 0, 0, 0},
+        {0, 2, 0, 0}}}};
+  for (size_t c = 0; c < cases.size(); ++c) {
+    auto matrices = cases[c].classification.createConfusionMatrices(
+        cases[c].ground_truth, thresholds);
+    ASSERT_EQ(thresholds.size(), matrices.size());
+    for (size_t i = 0; i < thresholds.size(); ++i) {
+      EXPECT_EQ(cases[c].expected[i], matrices[i].data())
+          << "case " << c << " threshold " << thresholds[i];
+    }
+  }
+  EXPECT_TRUE(ccl({{1, 2}}).createConfusionMatrices(ccl({}), {}).empty());
+}
 }
@@ -0,0 +1,189 @@
+/********************************************************************
+**                                                                 **
+** Copyright (C) 2014 Viktor Richter                               **
+**                                                                 **
+** File   : test/DetectionService.cpp                              **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "DetectionService.h"
+#include "Features.h"
+#include "GroupDetectorFactory.h"
+#include "Parallel.h"
+#include "SceneGenerator.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+namespace {
+using fformation::DetectionService;
+using fformation::Features;
+using fformation::GroupDetector;
+using fformation::GroupDetectorFactory;
+using fformation::GroupDetectorPool;
+using fformation::SceneGenerator;
+using fformation::Parallel;
+using fformation::Classification;
+using fformation::Observation;
+using fformation::Options;
+using fformation::Json;
+
+class Failing : public GroupDetector {
+public:
+  Failing() : GroupDetector(Options()) {}
+
+  virtual Classification detect(const Observation &observation) const final {
+    throw fformation::Exception("failed");
+  }
+
+  virtual Ptr clone() const final { return Ptr(new Failing(*this)); }
+};
+
+class Gated : public GroupDetector {
+public:
+  struct Gate {
+    std::atomic<size_t> entered{0};
+    std::shared_future<void> open;
+  };
+
+  Gated(std::shared_ptr<Gate> gate) : GroupDetector(Options()), _gate(gate) {}
+
+  virtual Classification detect(const Observation &observation) const final {
+    ++_gate->entered;
+    _gate->open.wait();
+    return Classification();
+  }
+
+  virtual Ptr clone() const final { return Ptr(new Gated(*this)); }
+
+private:
+  std::shared_ptr<Gate> _gate;
+};
+
+TEST(DetectionService, MatchesDirectDetection) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 10;
+  parameters.frames = 40;
+  SceneGenerator scene(parameters);
+  auto &observations = scene.features().observations();
+  auto pool = GroupDetectorFactory::getDefaultInstance().createPool(
+      "grow@mdl=2@stride=0.7");
+
+  std::vector<size_t> expected, found(observations.size());
+  for (auto &observation : observations) {
+    expected.push_back(pool->prototype().detect(observation).idGroups().size());
+  }
+  {
+    DetectionService service(pool, 3, 4);
+    EXPECT_EQ(3u, service.threads());
+    Parallel::forEach(observations.size(), 4, [&](size_t i) {
+      found[i] = service.detect(observations[i]).idGroups().size();
+    });
+    service.wait();
+    auto metrics = service.metrics();
+    EXPECT_EQ(observations.size(), metrics.requests);
+    EXPECT_EQ(observations.size(), metrics.latency.count());
+    EXPECT_EQ(0u, metrics.failures);
+    EXPECT_EQ(0u, metrics.pending);
+    EXPECT_GT(metrics.batches, 0u);
+    EXPECT_LE(metrics.batches, metrics.requests);
+  }
+  EXPECT_EQ(expected, found);
+  EXPECT_LE(pool->clones(), 3u);
+}
+
+TEST(DetectionService, Errors) {
+  DetectionService service(
+      std::make_shared<GroupDetectorPool>(GroupDetector::Ptr(new Failing())),
+      1);
+  EXPECT_THROW(service.detect(Observation()), fformation::Exception);
+  service.wait();
+  EXPECT_EQ(1u, service.metrics().failures);
+  EXPECT_THROW(DetectionService(nullptr), fformation::Exception);
+}
+
+TEST(DetectionService, BurstIsShared) {
+  std::promise<void> open;
+  auto gate = std::make_shared<Gated::Gate>();
+  gate->open = open.get_future().share();
+  auto ignore = [](const Classification &, std::exception_ptr, double) {};
+  DetectionService service(
+      std::make_shared<GroupDetectorPool>(GroupDetector::Ptr(new Gated(gate))),
+      2, 64);
+  // both workers block in one request each
+  service.submit(Observation(), ignore);
+  service.submit(Observation(), ignore);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (gate->entered < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(2u, gate->entered);
+  for (size_t i = 0; i < 20; ++i) {
+    service.submit(Observation(), ignore);
+  }
+  open.set_value();
+  service.wait();
+  auto metrics = service.metrics();
+  EXPECT_EQ(22u, metrics.requests);
+  // one worker taking all 20 would make it 3 batches
+  EXPECT_GE(metrics.batches, 4u);
+}
+
+TEST(DetectionService, ThrowingCallback) {
+  DetectionService service(
+      GroupDetectorFactory::getDefaultInstance().createPool("one"), 1);
+  for (size_t i = 0; i < 3; ++i) {
+    service.submit(Observation(), [](const Classification &,
+                                     std::exception_ptr, double) {
+      throw fformation::Exception("callback failed");
+    });
+  }
+  service.wait();
+  auto metrics = service.metrics();
+  EXPECT_EQ(3u, metrics.requests);
+  EXPECT_EQ(3u, metrics.failures);
+  EXPECT_EQ(3u, metrics.latency.count());
+  // the worker survived and still serves requests
+  EXPECT_NO_THROW(service.detect(Observation()));
+  service.wait();
+  EXPECT_EQ(4u, service.metrics().requests);
+}
+
+TEST(DetectionService, ReadObservationJson) {
+  auto observation = Features::readObservationJson(
+      Json::parse("{\"timestamp\": 2.5, \"persons\": "
+                  "[[1, 0.5, 1.5, 0.1], [\"b\", 2, 3]]}"));
+  EXPECT_EQ(2.5, observation.timestamp().time());
+  EXPECT_EQ(2u, observation.group().persons().size());
+  EXPECT_TRUE(observation.group().has_person(fformation::PersonId("b")));
+  EXPECT_TRUE(Features::readObservationJson(Json::parse("{\"timestamp\": 1}"))
+                  .group()
+                  .persons()
+                  .empty());
+  EXPECT_THROW(Features::readObservationJson(Json::parse("{\"persons\": []}")),
+               fformation::Exception);
+  // wrongly typed values must not escape as json library exceptions
+  for (auto request : {"{\"id\": 2, \"timestamp\": 1, \"persons\": "
+                       "[[1, \"a\", 0]]}",
+                       "{\"timestamp\": 1, \"persons\": [\"a\"]}",
+                       "{\"timestamp\": 1, \"persons\": 5}"}) {
+    EXPECT_THROW(Features::readObservationJson(Json::parse(request)),
+                 fformation::Exception)
+        << request;
+  }
+}
+}
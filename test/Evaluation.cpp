@@ -0,0 +1,284 @@
+/********************************************************************
+**                                                                 **
+** File   : test/Evaluation.cpp                                    **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+
+#include "Evaluation.h"
+#include "GroupDetectorFactory.h"
+#include "SceneGenerator.h"
+#include "TestScene.h"
+
+#include "gtest/gtest.h"
+#include <sstream>
+
+namespace {
+using fformation::Classification;
+using fformation::ConfusionMatrix;
+using fformation::Evaluation;
+using fformation::Features;
+using fformation::GroundTruth;
+using fformation::GroupDetector;
+using fformation::GroupDetectorFactory;
+using fformation::IdGroup;
+using fformation::Observation;
+using fformation::Options;
+using fformation::Person;
+using fformation::PersonId;
+using fformation::Pose2D;
+using fformation::Position2D;
+using fformation::RunningStatistics;
+using fformation::SceneGenerator;
+using fformation::Settings;
+
+static IdGroup group(const std::vector<size_t> &ids) {
+  std::set<PersonId> persons;
+  for (auto id : ids) {
+    persons.insert(PersonId(std::to_string(id)));
+  }
+  return IdGroup(persons);
+}
+
+static Classification ccl(const std::vector<std::vector<size_t>> &data,
+                          fformation::Timestamp timestamp = 0) {
+  std::vector<IdGroup> result;
+  for (auto &d : data) {
+    result.push_back(group(d));
+  }
+  return Classification(timestamp, result);
+}
+
+static Observation observation(size_t persons,
+                               fformation::Timestamp timestamp = 0) {
+  std::vector<Person> result;
+  for (size_t i = 1; i <= persons; ++i) {
+    result.push_back(Person(PersonId(std::to_string(i)),
+                            Pose2D(Position2D(double(i), 0.))));
+  }
+  return Observation(timestamp, result);
+}
+
+/**
+ * Returns a fixed classification for every observation but the one at
+ * failing_time.
+ */
+class FixedDetector : public GroupDetector {
+public:
+  FixedDetector(const Classification &classification,
+                double failing_time = -1.)
+      : GroupDetector(Options()),
+        _classification(classification), _failing_time(failing_time) {}
+
+  virtual Classification detect(const Observation &observation) const final {
+    fformation::Exception::check(observation.timestamp().time() !=
+                                     _failing_time,
+                                 "failing frame");
+    return Classification(observation.timestamp(),
+                          _classification.idGroups());
+  }
+
+  virtual Ptr clone() const final { return Ptr(new FixedDetector(*this)); }
+
+private:
+  Classification _classification;
+  double _failing_time;
+};
+
+static SceneGenerator scene() {
+  return fformation::test::scene(12, 12, 2, 0.2);
+}
+
+static void expectEqual(const RunningStatistics &expected,
+                        const RunningStatistics &actual) {
+  EXPECT_EQ(expected.count(), actual.count());
+  EXPECT_EQ(expected.mean(), actual.mean());
+  EXPECT_EQ(expected.min(), actual.min());
+  EXPECT_EQ(expected.max(), actual.max());
+}
+
+static std::string print(const Evaluation &evaluation) {
+  std::stringstream out;
+  evaluation.printOutput(out);
+  return out.str();
+}
+
+TEST(EvaluationTest, Thresholds) {
+  EXPECT_EQ(Evaluation::Parameters::defaultThresholds(),
+            Evaluation::Parameters::parse(Options()).thresholds);
+  EXPECT_EQ(21u, Evaluation::Parameters::defaultThresholds().size());
+  std::vector<double> expected = {0.25, 0.5, 1.};
+  EXPECT_EQ(expected, Evaluation::Parameters::parse(
+                          Options::parseFromString("thresholds=0.25,0.5,1"))
+                          .thresholds);
+  EXPECT_THROW(Evaluation::Parameters::parse(
+                   Options::parseFromString("thresholds=0.5,1.5")),
+               fformation::Exception);
+  EXPECT_THROW(Evaluation::Parameters::parse(
+                   Options::parseFromString("thresholds=0.5,x")),
+               fformation::Exception);
+}
+
+TEST(EvaluationTest, PrCurvePrinter) {
+  // best intersections 1, 2/3 and 1/2. persons 8 and 9 are false negatives
+  Features features({observation(9)});
+  GroundTruth ground_truth({ccl({{1, 2}, {3, 4}, {8, 9}})});
+  FixedDetector detector(ccl({{1, 2}, {3, 4, 5}, {6, 7}}));
+  Evaluation evaluation(
+      features, ground_truth, Settings(), detector,
+      Options::parseFromString("evaluation_printer=pr_curve@"
+                               "thresholds=0,0.6,1"));
+  EXPECT_EQ("threshold\tprecision\trecall\tf1\n"
+            "0.00000000\t1.00000000\t0.60000000\t0.75000000\n"
+            "0.60000000\t0.66666667\t0.50000000\t0.57142857\n"
+            "1.00000000\t0.33333333\t0.33333333\t0.33333333\n",
+            print(evaluation));
+}
+
+TEST(EvaluationTest, StreamingMatchesCollecting) {
+  auto generated = scene();
+  auto detector = GroupDetectorFactory::getDefaultInstance().create(
+      "grow@mdl=2@stride=0.7");
+  for (auto printer : {"matlab", "tsv", "tsv_participants", "pr_curve"}) {
+    auto options = Options::parseFromString(
+        std::string("quantiles@thresholds=0,0.5,1@evaluation_printer=") +
+        printer);
+    Evaluation collecting(generated.features(), generated.groundTruth(),
+                          generated.settings(), *detector, options);
+    std::stringstream stream;
+    Evaluation streaming(generated.features(), generated.groundTruth(),
+                         generated.settings(), *detector, options, stream);
+    // the streaming evaluation printed the frames already
+    streaming.printOutput(stream);
+    EXPECT_EQ(print(collecting), stream.str()) << printer;
+    EXPECT_TRUE(streaming.classifications().empty());
+
+    EXPECT_EQ(12u, collecting.frames());
+    EXPECT_EQ(collecting.frames(), streaming.frames());
+    auto &expected = collecting.summary();
+    auto &actual = streaming.summary();
+    expectEqual(expected.precision, actual.precision);
+    expectEqual(expected.recall, actual.recall);
+    ASSERT_EQ(3u, actual.threshold_precision.size());
+    for (size_t i = 0; i < 3; ++i) {
+      expectEqual(expected.threshold_precision[i],
+                  actual.threshold_precision[i]);
+      expectEqual(expected.threshold_recall[i], actual.threshold_recall[i]);
+    }
+    EXPECT_EQ(expected.f1_quantiles.quantile(0.5),
+              actual.f1_quantiles.quantile(0.5));
+  }
+}
+
+TEST(EvaluationTest, FailedFramesAreNotCounted) {
+  Features features({observation(4, 0.), observation(4, 1.),
+                     observation(4, 2.)});
+  GroundTruth ground_truth(
+      {ccl({{1, 2}, {3, 4}}, 0.), ccl({{1, 2}, {3, 4}}, 1.),
+       ccl({{1, 2}, {3, 4}}, 2.)});
+  FixedDetector detector(ccl({{1, 2}, {3, 4}}), 1.);
+  Evaluation collecting(features, ground_truth, Settings(), detector);
+  EXPECT_EQ(2u, collecting.frames());
+  EXPECT_EQ(2u, collecting.summary().precision.count());
+  EXPECT_NE(std::string::npos, print(collecting).find("Frame: 2/2\n"));
+
+  std::stringstream stream;
+  Evaluation streaming(features, ground_truth, Settings(), detector,
+                       Options(), stream);
+  EXPECT_EQ(2u, streaming.frames());
+  EXPECT_EQ(2u, streaming.summary().precision.count());
+}
+
+TEST(EvaluationTest, TimingPrinter) {
+  auto generated = scene();
+  auto detector = GroupDetectorFactory::getDefaultInstance().create(
+      "grow@mdl=2@stride=0.7");
+  Evaluation evaluation(generated.features(), generated.groundTruth(),
+                        generated.settings(), *detector,
+                        Options::parseFromString("evaluation_printer=timing"));
+  evaluation.addStage("load", 0.25, 10.);
+  evaluation.addStage("parse", 0.5);
+  evaluation.addStage("load", 0.25, 10.);
+
+  std::vector<std::vector<std::string>> rows;
+  std::stringstream out(print(evaluation));
+  std::string line;
+  while (std::getline(out, line)) {
+    std::vector<std::string> row;
+    std::stringstream cells(line);
+    std::string cell;
+    while (std::getline(cells, cell, '\t')) {
+      row.push_back(cell);
+    }
+    rows.push_back(row);
+  }
+  ASSERT_EQ(9u, rows.size());
+  std::vector<std::string> header = {"stage", "calls", "total_seconds",
+                                     "mean_seconds", "items_per_second"};
+  EXPECT_EQ(header, rows[0]);
+  std::vector<std::string> stages;
+  for (size_t i = 1; i < 6; ++i) {
+    ASSERT_EQ(5u, rows[i].size());
+    stages.push_back(rows[i][0]);
+  }
+  // the stages reported after the evaluation come first, in call order
+  std::vector<std::string> expected_stages = {"load", "parse", "modify",
+                                              "detect", "confusion_matrix"};
+  EXPECT_EQ(expected_stages, stages);
+  EXPECT_EQ("12", rows[4][1]);
+  std::vector<std::string> load = {"load", "2", "0.50000000", "0.25000000",
+                                   "40.00000000"};
+  EXPECT_EQ(load, rows[1]);
+  EXPECT_TRUE(rows[6].empty());
+  header = {"persons", "frames", "p50", "p90", "p99", "max"};
+  EXPECT_EQ(header, rows[7]);
+  EXPECT_EQ("12", rows[8][0]);
+  EXPECT_EQ("12", rows[8][1]);
+
+  // every detection of the 12 person frames is a latency sample
+  auto &summary = evaluation.summary();
+  ASSERT_EQ(1u, summary.detection_latencies.size());
+  auto &latencies = summary.detection_latencies.at(12);
+  auto &detect = summary.stages[3].second.seconds;
+  EXPECT_EQ(12u, latencies.statistics.count());
+  EXPECT_EQ(detect.sum(), latencies.statistics.sum());
+  EXPECT_EQ(detect.max(), latencies.statistics.max());
+  double previous = detect.min();
+  for (size_t i = 2; i < 6; ++i) {
+    double value = std::stod(rows[8][i]);
+    EXPECT_LE(previous, value + 1e-8);
+    previous = value;
+  }
+  EXPECT_NEAR(detect.max(), previous, 1e-8);
+}
+
+TEST(EvaluationTest, DetectorWithoutEMOptions) {
+  // only tsv_participants needs stride and mdl of the detector
+  auto generated = scene();
+  fformation::OneGroupDetector detector;
+  for (auto printer : {"matlab", "tsv", "pr_curve"}) {
+    Evaluation evaluation(
+        generated.features(), generated.groundTruth(), generated.settings(),
+        detector,
+        Options::parseFromString(std::string("evaluation_printer=") + printer));
+    EXPECT_EQ(12u, evaluation.frames()) << printer;
+    EXPECT_FALSE(print(evaluation).empty()) << printer;
+  }
+  EXPECT_THROW(Evaluation(generated.features(), generated.groundTruth(),
+                          generated.settings(), detector,
+                          Options::parseFromString(
+                              "evaluation_printer=tsv_participants")),
+               fformation::Exception);
+}
+}
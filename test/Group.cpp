@@ -20,11 +20,13 @@
 #include "Group.h"
 #include "Exception.h"
 #include "math.h"
+#include <algorithm>
 
 #include "gtest/gtest.h"
 
 namespace {
 using fformation::Group;
+using fformation::IdGroup;
 using fformation::Person;
 using fformation::PersonId;
 using fformation::Pose2D;
@@ -212,3 +214,27 @@ TEST(Group, CalculateSumDistanceCosts) {
   }
   EXPECT_EQ(sumcosts, group.calculateDistanceCosts(stride));
 }
+
+TEST(Group, IdGroup) {
+  auto persons = createPersons();
+  persons.push_back({persons.front().id(), {{5., 5.}}});
+  Group group(persons);
+  // the first person with an id is kept, the ids are sorted
+  EXPECT_EQ(persons.size() - 1, group.persons().size());
+  auto &first = group.persons().find(persons.front().id())->second;
+  EXPECT_EQ(persons.front().pose().position().x(),
+            first.pose().position().x());
+  auto ids = group.generatIdGroup();
+  EXPECT_EQ(group.persons().size(), ids.persons().size());
+  EXPECT_TRUE(std::is_sorted(ids.persons().begin(), ids.persons().end()));
+
+  IdGroup pair({persons[2].id(), persons[0].id(), persons[2].id()});
+  EXPECT_EQ(2u, pair.persons().size());
+  EXPECT_TRUE(pair.has_person(persons[0].id()));
+  EXPECT_FALSE(pair.has_person(persons[1].id()));
+  auto found = group.find_persons(pair);
+  ASSERT_EQ(2u, found.size());
+  EXPECT_EQ(persons[0].id(), found.begin()->first);
+  EXPECT_THROW(Group(persons).find_persons(IdGroup({PersonId("x")})),
+               Exception);
+}
@@ -18,6 +18,8 @@
 ********************************************************************/
 
 #include "GroupDetectorFactory.h"
+#include "Parallel.h"
+#include "SceneGenerator.h"
 
 #include "gtest/gtest.h"
 
@@ -30,6 +32,9 @@ using fformation::Options;
 using fformation::Option;
 using fformation::Classification;
 using fformation::Observation;
+using fformation::DetectionStats;
+using fformation::SceneGenerator;
+using fformation::Parallel;
 
 class OptionsKeeper : public GroupDetector {
 public:
@@ -38,6 +43,8 @@ public:
   virtual Classification detect(const Observation &observation) const final {
     return Classification(observation.timestamp(), {});
   }
+
+  virtual Ptr clone() const final { return Ptr(new OptionsKeeper(*this)); }
 };
 
 TEST(GroupDetectorFactory, DefaultInstance) {
@@ -78,4 +85,71 @@ TEST(GroupDetectorFactory, AddConstructors) {
   EXPECT_EQ(1u, detector->options().size());
   EXPECT_EQ("value", detector->options().getOption("name").value());
 }
+
+TEST(GroupDetectorFactory, DetectionStats) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 12;
+  auto observation =
+      SceneGenerator(parameters).features().observations().front();
+  auto &inst = GroupDetectorFactory::getDefaultInstance();
+  for (auto name : {"grow", "shrink", "shrink2"}) {
+    auto detector = inst.create(std::string(name) + "@mdl=2@stride=0.7");
+    DetectionStats stats;
+    auto classification = detector->detect(observation, stats);
+    EXPECT_EQ(detector->detect(observation).idGroups().size(),
+              classification.idGroups().size());
+    EXPECT_EQ(12u, stats.persons);
+    EXPECT_GT(stats.outer_iterations, 0u);
+    EXPECT_GE(stats.em_iterations, stats.outer_iterations);
+    EXPECT_GT(stats.cost_evaluations, 0u);
+    EXPECT_EQ(stats.cost_evaluations * 12, stats.visibility_evaluations);
+    EXPECT_TRUE(stats.converged);
+    EXPECT_GE(stats.total_seconds, stats.em_seconds);
+    EXPECT_GT(stats.total_seconds, 0.);
+
+    // untimed detections count the work but do not read the clock
+    DetectionStats untimed;
+    untimed.timed = false;
+    detector->detect(observation, untimed);
+    EXPECT_EQ(stats.cost_evaluations, untimed.cost_evaluations);
+    EXPECT_EQ(0., untimed.total_seconds);
+    EXPECT_EQ(0., untimed.em_seconds);
+  }
+  DetectionStats stats;
+  inst.create("one")->detect(observation, stats);
+  EXPECT_EQ(12u, stats.persons);
+  EXPECT_EQ(0u, stats.outer_iterations);
+  EXPECT_TRUE(stats.converged);
+}
+
+TEST(GroupDetectorFactory, Pool) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 12;
+  parameters.frames = 32;
+  SceneGenerator scene(parameters);
+  auto &observations = scene.features().observations();
+
+  auto &inst = GroupDetectorFactory::getDefaultInstance();
+  auto pool = inst.createPool("grow@mdl=2@stride=0.7");
+  EXPECT_EQ(0u, pool->clones());
+  {
+    auto lease = pool->checkout();
+    EXPECT_EQ("2", lease->options().getOption("mdl").value());
+    EXPECT_EQ(&pool->prototype().options(), &lease->options());
+  }
+  EXPECT_EQ(1u, pool->clones());
+  EXPECT_EQ(1u, pool->idle());
+
+  std::vector<size_t> expected, found(observations.size());
+  for (auto &observation : observations) {
+    expected.push_back(pool->prototype().detect(observation).idGroups().size());
+  }
+  Parallel::forEach(observations.size(), 4, [&](size_t i) {
+    auto detector = pool->checkout();
+    found[i] = detector->detect(observations[i]).idGroups().size();
+  });
+  EXPECT_EQ(expected, found);
+  EXPECT_LE(pool->clones(), 4u);
+  EXPECT_EQ(pool->clones(), pool->idle());
+}
 }
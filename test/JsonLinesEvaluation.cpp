@@ -0,0 +1,130 @@
+/********************************************************************
+**                                                                 **
+** Copyright (C) 2014 Viktor Richter                               **
+**                                                                 **
+** File   : test/JsonLinesEvaluation.cpp                           **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "Evaluation.h"
+#include "GroupDetectorFactory.h"
+#include "JsonLinesEvaluation.h"
+#include "SceneGenerator.h"
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace {
+using fformation::Evaluation;
+using fformation::GroupDetectorFactory;
+using fformation::JsonLinesEvaluation;
+using fformation::SceneGenerator;
+using fformation::Options;
+using fformation::Json;
+
+static std::string idOf(const fformation::PersonId &id) {
+  std::stringstream str;
+  str << id;
+  return str.str();
+}
+
+/**
+ * Writes the frames of a scene as json lines with ground truth.
+ */
+static std::string toJsonLines(const SceneGenerator &scene) {
+  std::stringstream out;
+  auto &classifications = scene.groundTruth().classifications();
+  auto &observations = scene.features().observations();
+  for (size_t i = 0; i < observations.size(); ++i) {
+    Json line;
+    line["timestamp"] = observations[i].timestamp().time();
+    line["persons"] = Json::array();
+    for (auto &person : observations[i].group().persons()) {
+      auto &pose = person.second.pose();
+      Json data = {idOf(person.first), pose.position().x(),
+                   pose.position().y()};
+      if (pose.rotation()) {
+        data.push_back(*pose.rotation());
+      }
+      line["persons"].push_back(data);
+    }
+    line["groups"] = Json::array();
+    for (auto &group : classifications[i].idGroups()) {
+      Json ids = Json::array();
+      for (auto &id : group.persons()) {
+        ids.push_back(idOf(id));
+      }
+      line["groups"].push_back(ids);
+    }
+    out << line.dump() << "\n";
+  }
+  return out.str();
+}
+
+TEST(JsonLinesEvaluationTest, MatchesEvaluation) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 12;
+  parameters.frames = 30;
+  parameters.missing_rotation = 0.2;
+  SceneGenerator scene(parameters);
+  auto detector = GroupDetectorFactory::getDefaultInstance().create(
+      "grow@mdl=2@stride=0.7");
+  std::string lines = toJsonLines(scene);
+
+  Evaluation evaluation(scene.features(), scene.groundTruth(),
+                        scene.settings(), *detector);
+  std::string expected;
+  for (std::string threads : {"1", "3"}) {
+    JsonLinesEvaluation jsonl(*detector,
+                              Options::parseFromString("threads=" + threads));
+    std::stringstream in(lines + "\n"), out;
+    jsonl.run(in, out);
+    EXPECT_EQ(30u, jsonl.frames());
+    EXPECT_EQ(0u, jsonl.failures());
+    EXPECT_DOUBLE_EQ(evaluation.summary().precision.mean(),
+                     jsonl.summary().precision.mean());
+    EXPECT_DOUBLE_EQ(evaluation.summary().recall.mean(),
+                     jsonl.summary().recall.mean());
+    if (expected.empty()) {
+      expected = out.str();
+    }
+    EXPECT_EQ(expected, out.str());
+  }
+  std::stringstream first(expected);
+  std::string line;
+  std::getline(first, line);
+  Json result = Json::parse(line);
+  EXPECT_EQ(1u, result["line"].get<size_t>());
+  EXPECT_TRUE(result.count("f1"));
+}
+
+TEST(JsonLinesEvaluationTest, ReportsBadLines) {
+  auto detector = GroupDetectorFactory::getDefaultInstance().create("one");
+  JsonLinesEvaluation jsonl(*detector);
+  std::stringstream in("{\"timestamp\": 1, \"persons\": [[1, 0, 0]]}\n"
+                       "not json\n"
+                       "{\"persons\": []}\n"),
+      out;
+  jsonl.run(in, out);
+  EXPECT_EQ(3u, jsonl.frames());
+  EXPECT_EQ(2u, jsonl.failures());
+  EXPECT_EQ(0u, jsonl.summary().precision.count());
+  std::string line;
+  for (size_t i = 1; std::getline(out, line); ++i) {
+    Json result = Json::parse(line);
+    EXPECT_EQ(i, result["line"].get<size_t>());
+    EXPECT_EQ(i != 1, result.count("error") == 1);
+  }
+}
+}
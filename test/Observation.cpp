@@ -0,0 +1,71 @@
+/********************************************************************
+**                                                                 **
+** File   : test/Observation.cpp                                   **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "Observation.h"
+#include "Exception.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+using fformation::Exception;
+using fformation::Observation;
+using fformation::Person;
+
+static Observation observation() {
+  std::vector<Person> persons;
+  for (auto i : {0., 1., 2., 3.}) {
+    std::stringstream id;
+    id << "p" << i;
+    persons.push_back({{id.str()}, {{i, 0.}, i}});
+  }
+  return Observation(1., persons);
+}
+
+TEST(ObservationTest, Masked) {
+  typedef Observation::Visibility V;
+  auto full = observation();
+  auto masked =
+      full.masked({V::Visible, V::Removed, V::WithoutRotation, V::Visible});
+  EXPECT_EQ(4u, full.size());
+  EXPECT_EQ(3u, masked.size());
+  EXPECT_EQ(full.timestamp().time(), masked.timestamp().time());
+
+  auto persons = masked.generatePersonList();
+  ASSERT_EQ(3u, persons.size());
+  EXPECT_EQ("p0", persons[0].id().value());
+  EXPECT_EQ("p2", persons[1].id().value());
+  EXPECT_EQ("p3", persons[2].id().value());
+  EXPECT_TRUE(bool(persons[0].pose().rotation()));
+  EXPECT_FALSE(bool(persons[1].pose().rotation()));
+  EXPECT_EQ(2., persons[1].pose().position().x());
+
+  // the table is shared, the masked group is materialized on demand
+  EXPECT_EQ(4u, full.group().persons().size());
+  EXPECT_EQ(3u, masked.group().persons().size());
+  EXPECT_EQ(&masked.group(), &Observation(masked).group());
+
+  // masks of a masked observation refer to its visible persons
+  auto twice = masked.masked({V::Removed, V::Visible, V::WithoutRotation});
+  persons = twice.generatePersonList();
+  ASSERT_EQ(2u, persons.size());
+  EXPECT_EQ("p2", persons[0].id().value());
+  EXPECT_EQ("p3", persons[1].id().value());
+  EXPECT_FALSE(bool(persons[1].pose().rotation()));
+
+  EXPECT_THROW(full.masked({V::Visible}), Exception);
+}
+} // namespace
@@ -77,4 +77,59 @@ TEST(OptionsTest, Override) {
   EXPECT_TRUE(o.hasOption(three.name()));
   EXPECT_EQ(three.value(), o.getOption(three.name()).value());
 }
+
+TEST(OptionsTest, ToString) {
+  EXPECT_EQ("", Options().toString());
+
+  Options o = Options::parseFromString("name2=value2@flag@name1=value1");
+  EXPECT_EQ("flag@name1=value1@name2=value2", o.toString());
+  EXPECT_EQ("flag;name1=value1;name2=value2", o.toString(";"));
+
+  Options parsed = Options::parseFromString(o.toString());
+  EXPECT_EQ(o.size(), parsed.size());
+  for (auto option : o) {
+    EXPECT_EQ(option.value(), parsed.getOption(option.name()).value());
+  }
+}
+
+TEST(OptionsTest, Validate) {
+  using fformation::validators::Min;
+  EXPECT_EQ(2., Option("name", "2").validate<double>(Min<double>(0.)));
+  EXPECT_THROW(Option("name", "-2").validate<double>(Min<double>(0.)),
+               fformation::Exception);
+  EXPECT_THROW(Option("name", "two").convertValue<double>(),
+               fformation::Exception);
+  EXPECT_TRUE(Option("flag").convertValue<bool>());
+}
+
+struct SchemaTarget {
+  double number = 1.;
+  bool flag = false;
+  std::string text = "default";
+  size_t length = 0;
+};
+
+TEST(OptionsTest, Schema) {
+  using fformation::validators::Min;
+  fformation::OptionSchema<SchemaTarget> schema =
+      fformation::OptionSchema<SchemaTarget>()
+          .required("number", &SchemaTarget::number, Min<double>(0.))
+          .optional("flag", &SchemaTarget::flag)
+          .optional("text", &SchemaTarget::text)
+          .custom<size_t>("length", &SchemaTarget::length,
+                          [](const Option &o) { return o.value().size(); });
+  EXPECT_EQ(4u, schema.names().size());
+
+  SchemaTarget parsed =
+      schema.parse(Options::parseFromString("number=2.5@flag@length=abc"));
+  EXPECT_EQ(2.5, parsed.number);
+  EXPECT_TRUE(parsed.flag);
+  EXPECT_EQ("default", parsed.text);
+  EXPECT_EQ(3u, parsed.length);
+
+  EXPECT_THROW(schema.parse(Options::parseFromString("flag")),
+               fformation::Exception);
+  EXPECT_THROW(schema.parse(Options::parseFromString("number=-1")),
+               fformation::Exception);
+}
 }
@@ -0,0 +1,153 @@
+/********************************************************************
+**                                                                 **
+** Copyright (C) 2014 Viktor Richter                               **
+**                                                                 **
+** File   : test/ParameterSweep.cpp                                **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "ParameterSweep.h"
+#include "SceneGenerator.h"
+#include "TestScene.h"
+
+#include "gtest/gtest.h"
+#include <cmath>
+
+namespace {
+using fformation::ParameterSweep;
+using fformation::Options;
+using fformation::Option;
+using fformation::SceneGenerator;
+
+SceneGenerator scene() { return fformation::test::scene(16, 8, 5); }
+
+Options detectorOptions(const std::string &mdl, const std::string &stride) {
+  Options options;
+  options.insert(Option("mdl", mdl));
+  options.insert(Option("stride", stride));
+  return options;
+}
+
+TEST(ParameterSweepTest, ParseSweep) {
+  EXPECT_TRUE(ParameterSweep::parseSweep("").empty());
+  EXPECT_THROW(ParameterSweep::parseSweep("mdl"), fformation::Exception);
+  EXPECT_THROW(ParameterSweep::parseSweep("mdl=1:2"), fformation::Exception);
+  EXPECT_THROW(ParameterSweep::parseSweep("mdl=1:0:2"),
+               fformation::Exception);
+  EXPECT_THROW(ParameterSweep::parseSweep("mdl=a:1:2"),
+               fformation::Exception);
+
+  auto spec = ParameterSweep::parseSweep("mdl=1:0.5:3@stride=0.5,0.7");
+  EXPECT_EQ(2u, spec.size());
+  std::vector<std::string> mdl = {"1", "1.5", "2", "2.5", "3"};
+  EXPECT_EQ(mdl, spec["mdl"]);
+  std::vector<std::string> stride = {"0.5", "0.7"};
+  EXPECT_EQ(stride, spec["stride"]);
+
+  // inclusive upper bound despite rounding
+  EXPECT_EQ(11u, ParameterSweep::parseSweep("x=0:0.1:1")["x"].size());
+}
+
+TEST(ParameterSweepTest, Expand) {
+  Options base;
+  base.insert(Option("mdl", "10"));
+  base.insert(Option("other", "value"));
+
+  auto configs = ParameterSweep::expand(base, {});
+  EXPECT_EQ(1u, configs.size());
+
+  configs = ParameterSweep::expand(
+      base, ParameterSweep::parseSweep("mdl=1,2,3@stride=0.5,0.7"));
+  EXPECT_EQ(6u, configs.size());
+  for (auto &config : configs) {
+    EXPECT_EQ("value", config.getOption("other").value());
+    EXPECT_NE("10", config.getOption("mdl").value());
+    EXPECT_TRUE(config.hasOption("stride"));
+  }
+  EXPECT_EQ("1", configs.front().getOption("mdl").value());
+  EXPECT_EQ("0.5", configs.front().getOption("stride").value());
+  EXPECT_EQ("3", configs.back().getOption("mdl").value());
+  EXPECT_EQ("0.7", configs.back().getOption("stride").value());
+}
+
+TEST(ParameterSweepTest, Threshold) {
+  auto generated = scene();
+  auto &features = generated.features();
+  auto &ground_truth = generated.groundTruth();
+  // the same thresholds as accepted by the Evaluation
+  EXPECT_NO_THROW(ParameterSweep(features, ground_truth, "grow",
+                                 Options::parseFromString("threshold=1.5")));
+  EXPECT_THROW(ParameterSweep(features, ground_truth, "grow",
+                              Options::parseFromString("threshold=-0.5")),
+               fformation::Exception);
+}
+
+TEST(ParameterSweepTest, EvaluateAndRun) {
+  auto generated = scene();
+  ParameterSweep sweep(generated.features(), generated.groundTruth(), "grow");
+  ASSERT_EQ(8u, sweep.frames().size());
+
+  auto result = sweep.evaluate(detectorOptions("2", "0.7"));
+  EXPECT_EQ(8u, result.frames);
+  EXPECT_GT(result.precision, 0.4);
+  EXPECT_GT(result.recall, 0.8);
+  EXPECT_GT(result.f1, 0.5);
+
+  auto subset = sweep.evaluate(detectorOptions("2", "0.7"), {0, 1});
+  EXPECT_EQ(2u, subset.frames);
+
+  // no frames, no scores
+  auto empty = sweep.evaluate(detectorOptions("2", "0.7"), {});
+  EXPECT_EQ(0u, empty.frames);
+  EXPECT_EQ(0., empty.precision);
+  EXPECT_EQ(0., empty.recall);
+  EXPECT_EQ(0., empty.f1);
+
+  std::vector<Options> configurations = {detectorOptions("2", "0.7"),
+                                         detectorOptions("200", "0.7")};
+  auto results = sweep.run(configurations, 2);
+  ASSERT_EQ(2u, results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    auto expected = sweep.evaluate(configurations[i]);
+    EXPECT_EQ(configurations[i].toString(), results[i].options.toString());
+    EXPECT_EQ(expected.frames, results[i].frames);
+    EXPECT_EQ(expected.f1, results[i].f1);
+  }
+}
+
+TEST(ParameterSweepTest, Tune) {
+  auto generated = scene();
+  ParameterSweep sweep(generated.features(), generated.groundTruth(), "grow");
+  std::vector<Options> configurations = {
+      detectorOptions("200", "0.3"), detectorOptions("0.5", "0.3"),
+      detectorOptions("2", "0.7"), detectorOptions("200", "0.7")};
+  std::vector<ParameterSweep::Rung> rungs;
+  auto best = sweep.tune(configurations, 2, 0, 1, &rungs);
+
+  // 4 configurations on 2 frames, 2 on 4 frames, then the winner on all
+  ASSERT_EQ(2u, rungs.size());
+  EXPECT_EQ(4u, rungs[0].configurations);
+  EXPECT_EQ(2u, rungs[0].frames);
+  EXPECT_EQ(2u, rungs[1].configurations);
+  EXPECT_EQ(4u, rungs[1].frames);
+  EXPECT_EQ(best.options.toString(), rungs[1].best.options.toString());
+
+  EXPECT_EQ(detectorOptions("2", "0.7").toString(), best.options.toString());
+  EXPECT_EQ(8u, best.frames);
+  for (auto &result : sweep.run(configurations, 1)) {
+    EXPECT_LE(result.f1, best.f1);
+  }
+  EXPECT_THROW(sweep.tune({}), fformation::Exception);
+}
+}
@@ -0,0 +1,127 @@
+/********************************************************************
+**                                                                 **
+** Copyright (C) 2014 Viktor Richter                               **
+**                                                                 **
+** File   : test/Pipeline.cpp                                      **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "Evaluation.h"
+#include "GroupDetectorFactory.h"
+#include "Pipeline.h"
+#include "SceneGenerator.h"
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace {
+using fformation::BoundedQueue;
+using fformation::Pipeline;
+using fformation::Evaluation;
+using fformation::GroupDetectorFactory;
+using fformation::SceneGenerator;
+using fformation::Options;
+
+TEST(PipelineTest, BoundedQueue) {
+  BoundedQueue<int> queue(3);
+  EXPECT_EQ(4u, queue.capacity());
+  int value = 0;
+  EXPECT_FALSE(queue.tryPop(value));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.push(i));
+  }
+  value = 4;
+  EXPECT_FALSE(queue.tryPush(value));
+  queue.close();
+  EXPECT_FALSE(queue.push(5));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(PipelineTest, KeepsOrder) {
+  const size_t count = 5000;
+  size_t read = 0;
+  std::vector<size_t> written;
+  std::vector<size_t> per_worker(4);
+  Pipeline<size_t, size_t> pipeline(4, 8);
+  pipeline.run(
+      [&](size_t &input) {
+        input = read;
+        return read++ < count;
+      },
+      [&](size_t &input, size_t worker) {
+        ++per_worker.at(worker);
+        return input * 2;
+      },
+      [&](size_t &output) { written.push_back(output); });
+  ASSERT_EQ(count, written.size());
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(2 * i, written[i]);
+  }
+  size_t processed = 0;
+  for (auto p : per_worker) {
+    processed += p;
+  }
+  EXPECT_EQ(count, processed);
+}
+
+TEST(PipelineTest, RethrowsErrors) {
+  Pipeline<size_t, size_t> pipeline(3, 4);
+  size_t read = 0;
+  EXPECT_THROW(pipeline.run(
+                   [&](size_t &input) {
+                     input = read++;
+                     return true; // endless input
+                   },
+                   [](size_t &input, size_t) {
+                     fformation::Exception::check(input != 100, "failed");
+                     return input;
+                   },
+                   [](size_t &) {}),
+               fformation::Exception);
+  EXPECT_THROW(pipeline.run([](size_t &) -> bool { throw std::bad_alloc(); },
+                            [](size_t &input, size_t) { return input; },
+                            [](size_t &) {}),
+               std::bad_alloc);
+}
+
+TEST(PipelineTest, EvaluationDoesNotDependOnThreads) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 12;
+  parameters.frames = 60;
+  parameters.missing_rotation = 0.2;
+  SceneGenerator scene(parameters);
+  auto detector = GroupDetectorFactory::getDefaultInstance().create(
+      "shrink@mdl=2@stride=0.7");
+  std::string expected;
+  for (std::string threads : {"1", "2", "5"}) {
+    Options options = Options::parseFromString(
+        "evaluation_printer=tsv@modify_rotations=random@modify_proportion=0.3@"
+        "threads=" +
+        threads);
+    Evaluation evaluation(scene.features(), scene.groundTruth(),
+                          scene.settings(), *detector, options);
+    std::stringstream out;
+    evaluation.printOutput(out);
+    EXPECT_EQ(60u, evaluation.classifications().size());
+    if (expected.empty()) {
+      expected = out.str();
+    }
+    EXPECT_EQ(expected, out.str());
+  }
+}
+}
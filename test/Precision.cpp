@@ -0,0 +1,86 @@
+/********************************************************************
+**                                                                 **
+** File   : test/Precision.cpp                                     **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+
+#include "../src/GroupDetectorFactory.h"
+#include "../src/Person.h"
+#include "../src/SceneGenerator.h"
+#include "gtest/gtest.h"
+#include <set>
+
+using fformation::BasicPerson;
+using fformation::BasicPosition2D;
+using fformation::Classification;
+using fformation::GroupDetectorFactory;
+using fformation::IdGroup;
+using fformation::Person;
+using fformation::PersonId;
+using fformation::Pose2D;
+using fformation::Position2D;
+using fformation::SceneGenerator;
+
+static std::set<IdGroup::Persons> groups(const Classification &c) {
+  std::set<IdGroup::Persons> result;
+  for (auto &group : c.idGroups()) {
+    result.insert(group.persons());
+  }
+  return result;
+}
+
+TEST(Precision, PersonCosts) {
+  // other is in front of person at an angle of ~60 degrees to the center
+  Person person(PersonId("a"), Pose2D(Position2D(2., 0.), 3.));
+  Person other(PersonId("b"), Pose2D(Position2D(0.5, 0.8)));
+  BasicPerson<float> person_f(person), other_f(other);
+  Position2D center(0., 0.);
+  BasicPosition2D<float> center_f(center);
+
+  EXPECT_EQ(sizeof(float) * 2, sizeof(BasicPosition2D<float>));
+  EXPECT_LT(sizeof(BasicPerson<float>), sizeof(Person));
+  EXPECT_NEAR(person.calculateDistanceCosts(center, 0.7),
+              person_f.calculateDistanceCosts(center_f, 0.7f), 1e-5);
+  double visibility = person.calculateVisibilityCost(center, other);
+  EXPECT_GT(visibility, 0.);
+  EXPECT_NEAR(visibility, person_f.calculateVisibilityCost(center_f, other_f),
+              visibility * 1e-5);
+}
+
+TEST(Precision, DetectorAgreement) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 24;
+  parameters.frames = 16;
+  parameters.missing_rotation = 0.2;
+  parameters.seed = 7;
+  SceneGenerator scene(parameters);
+  auto &inst = GroupDetectorFactory::getDefaultInstance();
+  for (auto name : {"grow", "shrink", "shrink2"}) {
+    std::string config = std::string(name) + "@mdl=2@stride=0.7";
+    auto reference = inst.create(config);
+    auto single = inst.create(config + "@precision=float");
+    size_t agreeing = 0;
+    for (auto &observation : scene.features().observations()) {
+      if (groups(reference->detect(observation)) ==
+          groups(single->detect(observation))) {
+        ++agreeing;
+      }
+    }
+    // float may flip a near tie, but must agree on almost every frame
+    EXPECT_GE(agreeing * 10, parameters.frames * 9) << name;
+  }
+  EXPECT_THROW(inst.create("grow@mdl=2@stride=0.7@precision=half"),
+               fformation::Exception);
+}
@@ -0,0 +1,175 @@
+/********************************************************************
+**                                                                 **
+** File   : test/ResultLog.cpp                                     **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "Evaluation.h"
+#include "GroupDetectorFactory.h"
+#include "ResultLog.h"
+#include "SceneGenerator.h"
+#include <cstdio>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace {
+using fformation::Classification;
+using fformation::ConfusionMatrix;
+using fformation::DetectionStats;
+using fformation::Evaluation;
+using fformation::Exception;
+using fformation::GroupDetectorFactory;
+using fformation::IdGroup;
+using fformation::Options;
+using fformation::PersonId;
+using fformation::ResultLog;
+using fformation::SceneGenerator;
+
+static Classification classification(
+    double timestamp, const std::vector<std::vector<std::string>> &groups) {
+  std::vector<IdGroup> result;
+  for (auto &group : groups) {
+    std::set<PersonId> persons;
+    for (auto &id : group) {
+      persons.insert(PersonId(id));
+    }
+    result.push_back(IdGroup(persons));
+  }
+  return Classification(timestamp, result);
+}
+
+static std::string str(const Classification &classification) {
+  std::stringstream out;
+  out << classification;
+  return out.str();
+}
+
+TEST(ResultLogTest, RoundTrip) {
+  std::vector<ResultLog::Frame> frames(2);
+  frames[0].ground_truth = classification(0.1, {{"a", "b"}, {"c"}});
+  frames[0].classification = classification(0.1, {{"a"}, {"b", "c"}});
+  frames[0].confusion_matrices = {ConfusionMatrix(0, 1, 0, 1),
+                                  ConfusionMatrix(1, 1, 300, 0)};
+  frames[1].ground_truth = classification(0.2, {{"person 1", "c"}});
+  frames[1].classification = classification(0.2, {});
+  frames[1].confusion_matrices = {ConfusionMatrix(0, 0, 0, 1),
+                                  ConfusionMatrix(0, 0, 0, 1)};
+  DetectionStats stats;
+  stats.persons = 3;
+  stats.em_iterations = 1000000;
+  stats.converged = true;
+  stats.total_seconds = 0.25;
+  frames[1].stats = stats;
+
+  std::stringstream log;
+  {
+    ResultLog::Writer writer(log, 2. / 3., {0.5});
+    for (auto &frame : frames) {
+      writer.write(frame);
+    }
+    EXPECT_EQ(2u, writer.frames());
+    EXPECT_THROW(writer.write(frames[0].ground_truth,
+                              frames[0].classification, {ConfusionMatrix()}),
+                 Exception);
+  }
+
+  ResultLog::Reader reader(log);
+  EXPECT_EQ(2. / 3., reader.threshold());
+  EXPECT_EQ(std::vector<double>{0.5}, reader.thresholds());
+  ResultLog::Frame frame;
+  for (auto &expected : frames) {
+    ASSERT_TRUE(reader.next(frame));
+    EXPECT_EQ(str(expected.ground_truth), str(frame.ground_truth));
+    EXPECT_EQ(str(expected.classification), str(frame.classification));
+    ASSERT_EQ(2u, frame.confusion_matrices.size());
+    for (size_t i = 0; i < 2; ++i) {
+      EXPECT_EQ(expected.confusion_matrices[i].data(),
+                frame.confusion_matrices[i].data());
+    }
+    EXPECT_EQ(bool(expected.stats), bool(frame.stats));
+  }
+  EXPECT_EQ(1000000u, frame.stats->em_iterations);
+  EXPECT_TRUE(frame.stats->converged);
+  EXPECT_EQ(0.25, frame.stats->total_seconds);
+  EXPECT_FALSE(reader.next(frame));
+}
+
+TEST(ResultLogTest, Corrupt) {
+  std::stringstream empty;
+  EXPECT_THROW(ResultLog::Reader reader(empty), Exception);
+  std::stringstream text("not a log");
+  EXPECT_THROW(ResultLog::Reader reader(text), Exception);
+
+  std::stringstream log;
+  {
+    ResultLog::Writer writer(log, 0.5, {});
+    writer.write(classification(1., {{"a", "b"}}),
+                 classification(1., {{"a", "b"}}),
+                 {ConfusionMatrix(1, 0, 0, 0)});
+  }
+  std::string data = log.str();
+  std::stringstream truncated(data.substr(0, data.size() - 3));
+  ResultLog::Reader reader(truncated);
+  ResultLog::Frame frame;
+  EXPECT_THROW(reader.next(frame), Exception);
+
+  // corrupt counts end in an Exception instead of a huge allocation
+  std::string huge = std::string(8, '\xff') + '\x7f';
+  std::string header = data.substr(0, 20);
+  std::string persons = data.substr(20, 6);
+  ASSERT_EQ("\x01\x01" "a" "\x01\x01" "b", persons);
+  for (auto corrupt :
+       {header + '\x01' + huge + "ab",
+        header + persons + '\x02' + data.substr(27, 8) + huge + "\x01"}) {
+    std::stringstream in(corrupt);
+    ResultLog::Reader corrupt_reader(in);
+    EXPECT_THROW(corrupt_reader.next(frame), Exception);
+  }
+  std::stringstream thresholds(data.substr(0, 16) + std::string(4, '\xff'));
+  EXPECT_THROW(ResultLog::Reader reader(thresholds), Exception);
+}
+
+TEST(ResultLogTest, Replay) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 12;
+  parameters.frames = 40;
+  parameters.missing_rotation = 0.2;
+  SceneGenerator scene(parameters);
+  auto detector = GroupDetectorFactory::getDefaultInstance().create(
+      "grow@mdl=2@stride=0.7");
+  std::string path = "fformation-result-log-test.bin";
+  Evaluation evaluation(
+      scene.features(), scene.groundTruth(), scene.settings(), *detector,
+      Options::parseFromString("result_log=" + path + "@detection_stats=1"));
+
+  for (std::string printer : {"tsv", "matlab", "pr_curve"}) {
+    for (std::string threshold : {"", "@threshold=0.5"}) {
+      Options options = Options::parseFromString("evaluation_printer=" +
+                                                 printer + threshold);
+      Evaluation direct(scene.features(), scene.groundTruth(),
+                        scene.settings(), *detector, options);
+      ResultLog::Reader log(path);
+      Evaluation replayed(log, options);
+      std::stringstream expected;
+      direct.printOutput(expected);
+      std::stringstream actual;
+      replayed.printOutput(actual);
+      EXPECT_EQ(expected.str(), actual.str()) << printer << threshold;
+    }
+  }
+  EXPECT_EQ(40u, ResultLog::read(path).size());
+  std::remove(path.c_str());
+}
+} // namespace
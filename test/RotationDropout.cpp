@@ -0,0 +1,131 @@
+/********************************************************************
+**                                                                 **
+** File   : test/RotationDropout.cpp                               **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+
+#include "RotationDropout.h"
+
+#include "gtest/gtest.h"
+#include <sstream>
+
+namespace {
+using fformation::Classification;
+using fformation::IdGroup;
+using fformation::Observation;
+using fformation::Options;
+using fformation::Person;
+using fformation::PersonId;
+using fformation::Pose2D;
+using fformation::Position2D;
+using fformation::RotationDropout;
+
+/**
+ * Persons 1 to 7 have a rotation, 8 has none. Persons 7 and 8 are not part of
+ * a ground truth group.
+ */
+static Observation observation() {
+  std::vector<Person> persons;
+  for (size_t i = 1; i <= 8; ++i) {
+    Position2D position(double(i), 0.);
+    persons.push_back(Person(PersonId(std::to_string(i)),
+                             (i < 8) ? Pose2D(position, 0.1 * double(i))
+                                     : Pose2D(position)));
+  }
+  return Observation(0., persons);
+}
+
+static Classification groundTruth() {
+  return Classification(0., {IdGroup({PersonId("1"), PersonId("2"),
+                                      PersonId("3")}),
+                             IdGroup({PersonId("4"), PersonId("5"),
+                                      PersonId("6")})});
+}
+
+/**
+ * Lists the persons of the observation, 'r' marks a rotation, '-' none.
+ */
+static std::string rotations(const Observation &observation) {
+  std::string result;
+  for (auto &person : observation.group().persons()) {
+    std::stringstream str;
+    str << person.first << (person.second.pose().rotation() ? "r " : "- ");
+    result += str.str();
+  }
+  return result;
+}
+
+static std::string apply(RotationDropout::Mode mode, double proportion,
+                         size_t seed) {
+  auto obs = observation();
+  return rotations(RotationDropout(obs, groundTruth(), mode)
+                       .apply(proportion, seed));
+}
+
+TEST(RotationDropoutTest, ParseMode) {
+  EXPECT_EQ(RotationDropout::Mode::Keep, RotationDropout::parseMode("keep"));
+  EXPECT_EQ(RotationDropout::Mode::Remove,
+            RotationDropout::parseMode("remove"));
+  EXPECT_EQ(RotationDropout::Mode::Group, RotationDropout::parseMode("group"));
+  EXPECT_EQ(RotationDropout::Mode::Random,
+            RotationDropout::parseMode("random"));
+  EXPECT_THROW(RotationDropout::parseMode("other"), fformation::Exception);
+  EXPECT_THROW(RotationDropout::Parameters::parse(
+                   Options::parseFromString("modify_rotations=random")),
+               fformation::Exception);
+}
+
+TEST(RotationDropoutTest, KeepAndRemove) {
+  EXPECT_EQ("1r 2r 3r 4r 5r 6r 7r 8- ",
+            apply(RotationDropout::Mode::Keep, 0.5, 1));
+  EXPECT_EQ("1- 2- 3- 4- 5- 6- 7- 8- ",
+            apply(RotationDropout::Mode::Remove, 0.5, 1));
+}
+
+TEST(RotationDropoutTest, Random) {
+  // all persons form a single unit
+  EXPECT_EQ("1- 2- 3- 4- 5- 6- 7- 8- ",
+            apply(RotationDropout::Mode::Random, 0., 1));
+  EXPECT_EQ("1- 2- 3r 4r 5r 6r 7- 8- ",
+            apply(RotationDropout::Mode::Random, 0.5, 1));
+  EXPECT_EQ("1r 2r 3- 4r 5r 6- 7- 8- ",
+            apply(RotationDropout::Mode::Random, 0.5, 2));
+  EXPECT_EQ("1r 2r 3r 4r 5r 6r 7r 8- ",
+            apply(RotationDropout::Mode::Random, 1., 1));
+  EXPECT_THROW(apply(RotationDropout::Mode::Random, 2., 1),
+               fformation::Exception);
+  EXPECT_THROW(apply(RotationDropout::Mode::Random, -0.5, 1),
+               fformation::Exception);
+}
+
+TEST(RotationDropoutTest, Group) {
+  // persons outside of the ground truth groups are dropped, every group is a
+  // unit of its own
+  EXPECT_EQ("1- 2- 3- 4- 5- 6- ", apply(RotationDropout::Mode::Group, 0., 1));
+  EXPECT_EQ("1- 2- 3r 4- 5- 6r ",
+            apply(RotationDropout::Mode::Group, 0.5, 1));
+  EXPECT_EQ("1r 2r 3r 4r 5r 6r ", apply(RotationDropout::Mode::Group, 1., 1));
+}
+
+TEST(RotationDropoutTest, Modify) {
+  auto obs = observation();
+  auto options = Options::parseFromString(
+      "modify_rotations=random@modify_proportion=0.5@seed=2");
+  EXPECT_EQ(apply(RotationDropout::Mode::Random, 0.5, 2),
+            rotations(RotationDropout::modify(obs, groundTruth(), options)));
+  // the original observation is not modified
+  EXPECT_EQ("1r 2r 3r 4r 5r 6r 7r 8- ", rotations(obs));
+}
+}
@@ -0,0 +1,145 @@
+/********************************************************************
+**                                                                 **
+** File   : test/RotationDropoutStudy.cpp                          **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+
+#include "GroupDetectorFactory.h"
+#include "RotationDropoutStudy.h"
+#include "SceneGenerator.h"
+#include "TestScene.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+
+namespace {
+using fformation::Classification;
+using fformation::GroupDetector;
+using fformation::GroupDetectorFactory;
+using fformation::IdGroup;
+using fformation::Observation;
+using fformation::Options;
+using fformation::PersonId;
+using fformation::RotationDropout;
+using fformation::RotationDropoutStudy;
+using fformation::SceneGenerator;
+
+static std::atomic<size_t> clones(0);
+
+/**
+ * Delegates to grow and counts its clones. Fails every frame if failing is
+ * set.
+ */
+class CountingDetector : public GroupDetector {
+public:
+  CountingDetector(bool failing = false)
+      : GroupDetector(Options()), _failing(failing),
+        _detector(GroupDetectorFactory::getDefaultInstance().create(
+            "grow@mdl=2@stride=0.7")) {}
+  CountingDetector(const CountingDetector &other)
+      : GroupDetector(other), _failing(other._failing),
+        _detector(other._detector->clone()) {}
+
+  virtual Classification detect(const Observation &observation) const final {
+    fformation::Exception::check(!_failing, "failing detector");
+    return _detector->detect(observation);
+  }
+
+  virtual Ptr clone() const final {
+    ++clones;
+    return Ptr(new CountingDetector(*this));
+  }
+
+private:
+  bool _failing;
+  GroupDetector::Ptr _detector;
+};
+
+/**
+ * Finds one group of two persons that are not in the scene.
+ */
+class WrongDetector : public GroupDetector {
+public:
+  WrongDetector() : GroupDetector(Options()) {}
+
+  virtual Classification detect(const Observation &observation) const final {
+    return Classification(
+        observation.timestamp(),
+        {IdGroup({PersonId("missing 1"), PersonId("missing 2")})});
+  }
+
+  virtual Ptr clone() const final { return Ptr(new WrongDetector(*this)); }
+};
+
+static SceneGenerator scene() { return fformation::test::scene(12, 4, 1); }
+
+TEST(RotationDropoutStudyTest, Run) {
+  auto generated = scene();
+  RotationDropoutStudy study(generated.features(), generated.groundTruth(),
+                             RotationDropout::Mode::Random);
+  CountingDetector detector;
+  clones = 0;
+  auto results = study.run(detector, {0., 0.5, 1.}, 3, 0, 4);
+  // the detector is cloned into a pool prototype and once per busy worker
+  EXPECT_GE(clones.load(), 2u);
+  EXPECT_LE(clones.load(), 5u);
+  auto sequential = study.run(detector, {0., 0.5, 1.}, 3, 0, 1);
+  ASSERT_EQ(3u, results.size());
+  ASSERT_EQ(3u, sequential.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(sequential[i].proportion, results[i].proportion);
+    EXPECT_EQ(3u, results[i].precision.count());
+    EXPECT_EQ(0u, results[i].empty_runs);
+    EXPECT_EQ(sequential[i].precision.mean(), results[i].precision.mean());
+    EXPECT_EQ(sequential[i].recall.mean(), results[i].recall.mean());
+    EXPECT_EQ(sequential[i].f1.mean(), results[i].f1.mean());
+  }
+  // without rotations the seed does not matter
+  EXPECT_EQ(results[0].precision.min(), results[0].precision.max());
+}
+
+TEST(RotationDropoutStudyTest, EmptyRuns) {
+  auto generated = scene();
+  RotationDropoutStudy study(generated.features(), generated.groundTruth(),
+                             RotationDropout::Mode::Group);
+  auto results = study.run(CountingDetector(true), {0.5}, 2, 0, 1);
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(2u, results[0].empty_runs);
+  EXPECT_EQ(0u, results[0].precision.count());
+  EXPECT_EQ(0u, results[0].f1.count());
+
+  // no frame has ground truth
+  RotationDropoutStudy no_frames(generated.features(),
+                                 fformation::GroundTruth(),
+                                 RotationDropout::Mode::Random);
+  results = no_frames.run(CountingDetector(), {0.5}, 2, 0, 1);
+  EXPECT_EQ(2u, results[0].empty_runs);
+
+  // precision and recall are both 0, which leaves the F1 score undefined
+  results = study.run(WrongDetector(), {0.5}, 2, 0, 1);
+  EXPECT_EQ(0u, results[0].empty_runs);
+  EXPECT_EQ(0., results[0].precision.mean());
+  EXPECT_EQ(0., results[0].recall.mean());
+  EXPECT_EQ(2u, results[0].f1.count());
+  EXPECT_EQ(0., results[0].f1.mean());
+
+  EXPECT_THROW(study.run(CountingDetector(), {0.5, 2.}, 2, 0, 1),
+               fformation::Exception);
+  EXPECT_THROW(RotationDropoutStudy(generated.features(),
+                                    generated.groundTruth(),
+                                    RotationDropout::Mode::Keep),
+               fformation::Exception);
+}
+}
@@ -0,0 +1,135 @@
+/********************************************************************
+**                                                                 **
+** Copyright (C) 2014 Viktor Richter                               **
+**                                                                 **
+** File   : test/RunningStatistics.cpp                             **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "RunningStatistics.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdlib.h>
+
+#include "gtest/gtest.h"
+
+namespace {
+using fformation::RunningStatistics;
+using fformation::QuantileSketch;
+using fformation::RelativeQuantileSketch;
+
+TEST(RunningStatisticsTest, Empty) {
+  RunningStatistics stats;
+  EXPECT_EQ(0u, stats.count());
+  EXPECT_TRUE(std::isnan(stats.mean()));
+  EXPECT_EQ(0., stats.variance());
+}
+
+TEST(RunningStatisticsTest, Aggregates) {
+  std::vector<double> values = {2., 4., 4., 4., 5., 5., 7., 9.};
+  RunningStatistics stats;
+  double sum = 0.;
+  for (auto v : values) {
+    stats.add(v);
+    sum += v;
+  }
+  EXPECT_EQ(values.size(), stats.count());
+  EXPECT_EQ(sum / double(values.size()), stats.mean());
+  EXPECT_DOUBLE_EQ(32. / 7., stats.variance());
+  EXPECT_EQ(2., stats.min());
+  EXPECT_EQ(9., stats.max());
+
+  // merging must produce the same results as adding all values
+  RunningStatistics first;
+  RunningStatistics second;
+  for (size_t i = 0; i < values.size(); ++i) {
+    (i < 3 ? first : second).add(values[i]);
+  }
+  first += second;
+  EXPECT_EQ(stats.count(), first.count());
+  EXPECT_DOUBLE_EQ(stats.mean(), first.mean());
+  EXPECT_DOUBLE_EQ(stats.variance(), first.variance());
+  EXPECT_EQ(stats.min(), first.min());
+  EXPECT_EQ(stats.max(), first.max());
+}
+
+TEST(QuantileSketchTest, Quantiles) {
+  EXPECT_THROW(QuantileSketch(1., 0.), fformation::Exception);
+  EXPECT_THROW(QuantileSketch(0., 1., 0), fformation::Exception);
+
+  QuantileSketch sketch(0., 1., 100);
+  EXPECT_TRUE(std::isnan(sketch.quantile(0.5)));
+  std::vector<double> values;
+  for (size_t i = 0; i < 1000; ++i) {
+    values.push_back(double(std::rand()) / double(RAND_MAX));
+    sketch.add(values.back());
+  }
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(values.size(), sketch.count());
+  for (auto q : {0.1, 0.5, 0.9, 0.99}) {
+    EXPECT_NEAR(values[size_t(q * values.size())], sketch.quantile(q), 0.01);
+  }
+
+  // out of range values are clamped into the border bins
+  QuantileSketch clamped(0., 1., 10);
+  clamped.add(-5.);
+  clamped.add(5.);
+  EXPECT_NEAR(0., clamped.quantile(0.), 0.1);
+  EXPECT_NEAR(1., clamped.quantile(1.), 0.1);
+
+  QuantileSketch merged(0., 1., 100);
+  merged += sketch;
+  EXPECT_EQ(sketch.count(), merged.count());
+  EXPECT_EQ(sketch.quantile(0.5), merged.quantile(0.5));
+  EXPECT_THROW(merged += clamped, fformation::Exception);
+}
+
+TEST(RelativeQuantileSketchTest, Quantiles) {
+  EXPECT_THROW(RelativeQuantileSketch(0.), fformation::Exception);
+  EXPECT_THROW(RelativeQuantileSketch(0.01, 0.), fformation::Exception);
+
+  RelativeQuantileSketch sketch(0.01);
+  EXPECT_TRUE(std::isnan(sketch.quantile(0.5)));
+  std::vector<double> values;
+  for (size_t i = 0; i < 1000; ++i) {
+    // spread over eight orders of magnitude, some of them zero
+    double exponent = 8. * double(std::rand()) / double(RAND_MAX) - 4.;
+    values.push_back(i % 10 == 0 ? 0. : std::pow(10., exponent));
+    sketch.add(values.back());
+  }
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(values.size(), sketch.count());
+  EXPECT_EQ(0., sketch.quantile(0.));
+  EXPECT_EQ(values.back(), sketch.quantile(1.));
+  for (auto q : {0.05, 0.1, 0.5, 0.9, 0.99}) {
+    double expected = values[size_t(q * double(values.size() - 1))];
+    EXPECT_NEAR(expected, sketch.quantile(q), 0.01 * expected);
+  }
+
+  // a constant is reproduced exactly
+  RelativeQuantileSketch constant;
+  for (size_t i = 0; i < 10; ++i) {
+    constant.add(5.);
+  }
+  EXPECT_EQ(5., constant.quantile(0.5));
+
+  RelativeQuantileSketch merged;
+  merged += sketch;
+  EXPECT_EQ(sketch.count(), merged.count());
+  EXPECT_EQ(sketch.quantile(0.5), merged.quantile(0.5));
+  EXPECT_THROW(merged += RelativeQuantileSketch(0.1), fformation::Exception);
+}
+}
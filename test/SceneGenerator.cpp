@@ -0,0 +1,137 @@
+/********************************************************************
+**                                                                 **
+** File   : test/SceneGenerator.cpp                                **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "../src/SceneGenerator.h"
+#include "../src/Exception.h"
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <sstream>
+
+using fformation::SceneGenerator;
+using fformation::Options;
+using fformation::Features;
+using fformation::GroundTruth;
+using fformation::Exception;
+
+static std::string features(const SceneGenerator &generator) {
+  std::stringstream str;
+  SceneGenerator::writeFeatures(str, generator.features());
+  return str.str();
+}
+
+TEST(SceneGeneratorTest, Deterministic) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 50;
+  parameters.frames = 5;
+  parameters.speed = 0.5;
+  parameters.seed = 3;
+  EXPECT_EQ(features(SceneGenerator(parameters)),
+            features(SceneGenerator(parameters)));
+  auto other = parameters;
+  other.seed = 4;
+  EXPECT_NE(features(SceneGenerator(parameters)),
+            features(SceneGenerator(other)));
+}
+
+TEST(SceneGeneratorTest, Sizes) {
+  auto parameters = SceneGenerator::Parameters::fromOptions(
+      Options::parseFromString("persons=100@frames=3@group_size_weights=0,0,0,1"));
+  SceneGenerator generator(parameters);
+  ASSERT_EQ(generator.features().observations().size(), 3);
+  ASSERT_EQ(generator.groundTruth().classifications().size(), 3);
+  for (auto &observation : generator.features().observations()) {
+    EXPECT_EQ(observation.group().persons().size(), 100);
+  }
+  auto &groups = generator.groundTruth().classifications().front().idGroups();
+  EXPECT_EQ(groups.size(), 25);
+  for (auto &group : groups) {
+    EXPECT_EQ(group.persons().size(), 4);
+  }
+}
+
+TEST(SceneGeneratorTest, MissingRotation) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 30;
+  parameters.missing_rotation = 1.;
+  SceneGenerator generator(parameters);
+  for (auto &person :
+       generator.features().observations().front().group().persons()) {
+    EXPECT_FALSE(person.second.pose().rotation());
+  }
+}
+
+TEST(SceneGeneratorTest, ReadWrite) {
+  char directory[] = "/tmp/fformation-test-XXXXXX";
+  ASSERT_NE(mkdtemp(directory), nullptr);
+  std::string path(directory);
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 40;
+  parameters.frames = 4;
+  parameters.missing_rotation = 0.5;
+  SceneGenerator generator(parameters);
+  generator.writeMatlabJson(path);
+  auto features = Features::readMatlabJson(path + "/features.json");
+  auto ground_truth = GroundTruth::readMatlabJson(path + "/groundtruth.json");
+  auto written = generator.features().observations();
+  ASSERT_EQ(features.observations().size(), written.size());
+  for (size_t i = 0; i < written.size(); ++i) {
+    EXPECT_EQ(features.observations()[i].timestamp(), written[i].timestamp());
+    auto &read_persons = features.observations()[i].group().persons();
+    for (auto &person : written[i].group().persons()) {
+      auto it = read_persons.find(person.first);
+      ASSERT_NE(it, read_persons.end());
+      EXPECT_EQ(it->second.pose().position().x(),
+                person.second.pose().position().x());
+      EXPECT_EQ(bool(it->second.pose().rotation()),
+                bool(person.second.pose().rotation()));
+    }
+  }
+  ASSERT_EQ(ground_truth.classifications().size(), written.size());
+  EXPECT_EQ(ground_truth.classifications().front().idGroups().size(),
+            generator.groundTruth().classifications().front().idGroups().size());
+  for (auto name : {"/features.json", "/groundtruth.json", "/settings.json"}) {
+    std::remove((path + name).c_str());
+  }
+  std::remove(directory);
+}
+
+TEST(SceneGeneratorTest, ReadWriteBinary) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = 40;
+  parameters.frames = 4;
+  parameters.missing_rotation = 0.5;
+  parameters.speed = 0.5;
+  SceneGenerator generator(parameters);
+  std::stringstream binary;
+  SceneGenerator::writeBinary(binary, generator.features(),
+                              generator.groundTruth(), generator.settings());
+  auto scene = SceneGenerator::readBinary(binary);
+  std::stringstream written, read;
+  SceneGenerator::writeFeatures(written, generator.features());
+  SceneGenerator::writeGroundTruth(written, generator.groundTruth());
+  SceneGenerator::writeSettings(written, generator.settings());
+  SceneGenerator::writeFeatures(read, scene.features);
+  SceneGenerator::writeGroundTruth(read, scene.ground_truth);
+  SceneGenerator::writeSettings(read, scene.settings);
+  EXPECT_EQ(read.str(), written.str());
+
+  std::string data = binary.str();
+  std::stringstream truncated(data.substr(0, data.size() - 3));
+  EXPECT_THROW(SceneGenerator::readBinary(truncated), Exception);
+  std::stringstream garbage("not a scene");
+  EXPECT_THROW(SceneGenerator::readBinary(garbage), Exception);
+}
@@ -0,0 +1,39 @@
+/********************************************************************
+**                                                                 **
+** File   : test/TestScene.h                                       **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#pragma once
+#include "SceneGenerator.h"
+
+namespace fformation {
+namespace test {
+
+/**
+ * @brief scene generates the small synthetic scene shared by the tests that
+ * run detectors on many frames.
+ */
+inline SceneGenerator scene(size_t persons, size_t frames, size_t seed,
+                            double missing_rotation = 0.) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = persons;
+  parameters.frames = frames;
+  parameters.missing_rotation = missing_rotation;
+  parameters.seed = seed;
+  return SceneGenerator(parameters);
+}
+
+} // namespace test
+} // namespace fformation
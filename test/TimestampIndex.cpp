@@ -0,0 +1,99 @@
+/********************************************************************
+**                                                                 **
+** File   : test/TimestampIndex.cpp                                **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "GroundTruth.h"
+#include "TimestampIndex.h"
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+namespace {
+using fformation::Classification;
+using fformation::Exception;
+using fformation::GroundTruth;
+using fformation::Observation;
+using fformation::Timestamp;
+using fformation::TimestampIndex;
+
+static std::vector<Timestamp> times(const std::vector<double> &values) {
+  return std::vector<Timestamp>(values.begin(), values.end());
+}
+
+TEST(TimestampIndexTest, Find) {
+  TimestampIndex index(times({0.3, 0.1, 0.2, 1e6}), 1e-3);
+  EXPECT_EQ(4u, index.size());
+  EXPECT_EQ(1u, index.find(0.1));
+  EXPECT_EQ(2u, index.find(0.2 + 5e-4));
+  EXPECT_EQ(0u, index.find(0.3 - 5e-4));
+  EXPECT_EQ(3u, index.find(1e6));
+  EXPECT_EQ(TimestampIndex::npos, index.find(0.25));
+  EXPECT_EQ(TimestampIndex::npos, index.find(0.));
+  EXPECT_EQ(TimestampIndex::npos, index.find(2e6));
+  EXPECT_EQ(TimestampIndex::npos, TimestampIndex().find(0.));
+
+  // 0.1 * 3 != 0.3, but they are equal Timestamps
+  TimestampIndex exact(times({0.3}));
+  EXPECT_TRUE(Timestamp(0.1 * 3) == Timestamp(0.3));
+  EXPECT_EQ(0u, exact.find(0.1 * 3));
+
+  EXPECT_THROW(TimestampIndex(times({0.1, 0.2, 0.1})), Exception);
+  EXPECT_THROW(TimestampIndex(times({0.1, 0.1005}), 1e-3), Exception);
+}
+
+TEST(TimestampIndexTest, Match) {
+  TimestampIndex index(times({0.4, 0.1, 0.2, 0.3}), 1e-3);
+  std::vector<double> queries = {0.05, 0.1, 0.1, 0.2001, 0.25, 0.3, 0.4, 0.5};
+  std::vector<size_t> expected = {TimestampIndex::npos, 1, 1, 2,
+                                  TimestampIndex::npos, 3, 0,
+                                  TimestampIndex::npos};
+  // sorted queries are merge joined
+  EXPECT_EQ(expected, index.match(times(queries)));
+  // unsorted ones use binary search
+  std::reverse(queries.begin(), queries.end());
+  std::reverse(expected.begin(), expected.end());
+  EXPECT_EQ(expected, index.match(times(queries)));
+}
+
+TEST(TimestampIndexTest, Range) {
+  TimestampIndex index(times({0.4, 0.1, 0.2, 0.3}));
+  EXPECT_EQ(std::vector<size_t>({1, 2, 3, 0}), index.range(0., 1.));
+  EXPECT_EQ(std::vector<size_t>({2, 3}), index.range(0.2, 0.3));
+  EXPECT_EQ(std::vector<size_t>({2, 3}), index.range(0.15, 0.35));
+  EXPECT_EQ(std::vector<size_t>({3}), index.range(0.1 * 3, 0.1 * 3));
+  EXPECT_TRUE(index.range(0.5, 1.).empty());
+  EXPECT_TRUE(index.range(0.3, 0.2).empty());
+}
+
+TEST(TimestampIndexTest, GroundTruth) {
+  GroundTruth gt({Classification(2.), Classification(1.), Classification(3.)});
+  EXPECT_EQ(&gt.classifications()[1], gt.findClassification(1.));
+  EXPECT_EQ(nullptr, gt.findClassification(1.5));
+  auto found = gt.findClassifications(
+      {Observation(1.), Observation(1.5), Observation(3.), Observation(2.)});
+  ASSERT_EQ(4u, found.size());
+  EXPECT_EQ(&gt.classifications()[1], found[0]);
+  EXPECT_EQ(nullptr, found[1]);
+  EXPECT_EQ(&gt.classifications()[2], found[2]);
+  EXPECT_EQ(&gt.classifications()[0], found[3]);
+  auto between = gt.classificationsBetween(1.5, 3.);
+  ASSERT_EQ(2u, between.size());
+  EXPECT_EQ(2., between[0]->timestamp().time());
+  EXPECT_EQ(3., between[1]->timestamp().time());
+  EXPECT_THROW(GroundTruth({Classification(1.), Classification(1.)}),
+               Exception);
+}
+} // namespace
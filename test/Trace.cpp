@@ -0,0 +1,105 @@
+/********************************************************************
+**                                                                 **
+** File   : test/Trace.cpp                                         **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "../src/JsonReader.h"
+#include "../src/Parallel.h"
+#include "../src/Trace.h"
+#include "gtest/gtest.h"
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using fformation::Json;
+using fformation::Parallel;
+using fformation::Trace;
+
+TEST(TraceTest, Disabled) {
+  Trace::enable();
+  Trace::disable();
+  Trace::instant("ignored", "test");
+  { Trace::Scope scope("ignored", "test"); }
+  EXPECT_TRUE(Trace::events().empty());
+}
+
+TEST(TraceTest, Scope) {
+  Trace::enable();
+  {
+    Trace::Scope scope("outer", "test", {{"value", 1.}});
+    Trace::instant("inner", "test", {{"a", 2.}, {"b", 3.}});
+  }
+  Trace::disable();
+  auto events = Trace::events();
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_EQ(std::string(events[0].name), "outer");
+  EXPECT_EQ(events[0].phase, Trace::Phase::Begin);
+  ASSERT_EQ(events[0].argument_count, 1);
+  EXPECT_EQ(events[0].arguments[0].value, 1.);
+  EXPECT_EQ(events[1].phase, Trace::Phase::Instant);
+  EXPECT_EQ(events[1].argument_count, 2);
+  EXPECT_EQ(events[2].phase, Trace::Phase::End);
+  EXPECT_LE(events[0].time, events[2].time);
+}
+
+TEST(TraceTest, RingBuffer) {
+  Trace::enable(4);
+  for (size_t i = 0; i < 10; ++i) {
+    Trace::instant("event", "test", {{"i", double(i)}});
+  }
+  Trace::disable();
+  auto events = Trace::events();
+  ASSERT_EQ(events.size(), 4);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(events[i].arguments[0].value, double(i + 6));
+  }
+}
+
+TEST(TraceTest, Threads) {
+  Trace::enable();
+  Parallel::forEach(100, 4, [](size_t i) {
+    Trace::Scope scope("work", "test", {{"i", double(i)}});
+  });
+  Trace::disable();
+  EXPECT_EQ(Trace::events().size(), 200);
+}
+
+TEST(TraceTest, ChromeJson) {
+  Trace::enable();
+  {
+    Trace::Scope scope("outer", "test");
+    Trace::instant("inner", "test", {{"value", 0.5}});
+  }
+  Trace::disable();
+  std::stringstream out;
+  Trace::writeChromeJson(out);
+  Json js = Json::parse(out.str());
+  ASSERT_EQ(js["traceEvents"].size(), 3);
+  EXPECT_EQ(js["traceEvents"][0]["ph"], "B");
+  EXPECT_EQ(js["traceEvents"][1]["name"], "inner");
+  EXPECT_EQ(js["traceEvents"][1]["args"]["value"], 0.5);
+  EXPECT_EQ(js["traceEvents"][2]["ph"], "E");
+}
+
+TEST(TraceTest, ChromeJsonKeepsStreamFormat) {
+  Trace::enable();
+  Trace::instant("event", "test", {{"value", 0.5}});
+  Trace::disable();
+  std::stringstream out;
+  out << std::scientific << std::setprecision(2);
+  Trace::writeChromeJson(out);
+  EXPECT_EQ(out.flags() & std::ios::floatfield, std::ios::scientific);
+  EXPECT_EQ(out.precision(), 2);
+}
@@ -0,0 +1,86 @@
+/********************************************************************
+**                                                                 **
+** File   : test/ValueTypes.cpp                                    **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "BufferedWriter.h"
+#include "ConfusionMatrix.h"
+#include "Person.h"
+#include "Timestamp.h"
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+
+namespace {
+using fformation::BufferedWriter;
+using fformation::ConfusionMatrix;
+using fformation::Person;
+using fformation::PersonId;
+using fformation::Pose2D;
+using fformation::Position2D;
+using fformation::Timestamp;
+
+static_assert(std::is_trivially_copyable<Position2D>::value,
+              "Position2D must be trivially copyable");
+static_assert(std::is_trivially_copyable<Pose2D>::value,
+              "Pose2D must be trivially copyable");
+static_assert(std::is_trivially_copyable<Timestamp>::value,
+              "Timestamp must be trivially copyable");
+static_assert(std::is_trivially_copyable<ConfusionMatrix>::value,
+              "ConfusionMatrix must be trivially copyable");
+static_assert(!std::is_polymorphic<PersonId>::value &&
+                  !std::is_polymorphic<Person>::value,
+              "Person and PersonId must not have a vtable");
+static_assert(sizeof(Position2D) == 2 * sizeof(Position2D::Coordinate),
+              "Position2D must not carry more than its coordinates");
+
+template <typename T> static std::string str(const T &data) {
+  std::stringstream out;
+  out << data;
+  std::stringstream buffered;
+  {
+    BufferedWriter writer(buffered);
+    writer << data;
+  }
+  EXPECT_EQ(out.str(), buffered.str());
+  return out.str();
+}
+
+TEST(ValueTypesTest, Serialization) {
+  Person person(PersonId("p 1"), Pose2D(Position2D(1.5, -2), 0.25));
+  EXPECT_EQ("{ \"x\": 1.5, \"y\": -2 }", str(person.pose().position()));
+  EXPECT_EQ("{ \"id\": p 1, \"pose\": { \"position\": { \"x\": 1.5, \"y\": -2 "
+            "}, \"rotation_radian\":  0.25 } }",
+            str(person));
+  EXPECT_EQ("{ \"position\": { \"x\": 0, \"y\": 0 }, \"rotation_radian\": -- }",
+            str(Pose2D()));
+  EXPECT_EQ("{ \"true-positive\": 1, \"false-positive\": 2, "
+            "\"true-negative\": 3, \"false-negative\": 4 }",
+            str(ConfusionMatrix(1, 2, 3, 4)));
+  EXPECT_EQ("1.00000000000000006e-01", str(Timestamp(0.1)));
+}
+
+TEST(ValueTypesTest, Memcpy) {
+  std::vector<Pose2D> poses = {Pose2D(Position2D(1., 2.), 0.5),
+                               Pose2D(Position2D(3., 4.))};
+  std::vector<Pose2D> copy(poses.size());
+  std::memcpy(copy.data(), poses.data(), poses.size() * sizeof(Pose2D));
+  EXPECT_EQ(3., copy[1].position().x());
+  EXPECT_EQ(0.5, copy[0].rotation().get());
+  EXPECT_FALSE(copy[1].rotation());
+}
+} // namespace
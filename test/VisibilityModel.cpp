@@ -0,0 +1,104 @@
+/********************************************************************
+**                                                                 **
+** File   : test/VisibilityModel.cpp                               **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#include "GroupDetectorFactory.h"
+#include "Person.h"
+#include "VisibilityModel.h"
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+namespace {
+using fformation::Exception;
+using fformation::GroupDetectorFactory;
+using fformation::Options;
+using fformation::Person;
+using fformation::PersonId;
+using fformation::Pose2D;
+using fformation::Position2D;
+using fformation::VisibilityModel;
+
+TEST(VisibilityModelTest, Cost) {
+  const VisibilityModel &model = VisibilityModel::standard();
+  EXPECT_EQ(0.75, model.threshold());
+  for (double exponent : {-3., -0.5, 0., 0.3, 1., 2.5}) {
+    EXPECT_NEAR(std::pow(100., exponent), model.cost(exponent),
+                1e-12 * std::pow(100., exponent));
+  }
+  EXPECT_EQ(VisibilityModel::max_cost(), model.cost(3.5));
+  EXPECT_EQ(VisibilityModel::max_cost(), model.cost(1e6));
+  EXPECT_EQ(0., model.cost(-1e6));
+}
+
+TEST(VisibilityModelTest, Approximation) {
+  double max_error = 0.;
+  for (double y = -700.; y < std::log(VisibilityModel::max_cost());
+       y += 0.0137) {
+    double exact = std::exp(y);
+    max_error = std::max(
+        max_error,
+        std::fabs(VisibilityModel::approximateExp(y) - exact) / exact);
+  }
+  EXPECT_LT(max_error, 3e-7);
+  EXPECT_EQ(0., VisibilityModel::approximateExp(-800.));
+}
+
+TEST(VisibilityModelTest, Options) {
+  auto parameters = VisibilityModel::Parameters::parse(Options::parseFromString(
+      "visibility_threshold=0.5@visibility_k=2@visibility_mode=approximate"));
+  EXPECT_EQ(0.5, parameters.threshold);
+  EXPECT_EQ(2., parameters.k);
+  EXPECT_EQ(VisibilityModel::Mode::Approximate, parameters.mode);
+  VisibilityModel model(parameters);
+  EXPECT_NEAR(8., model.cost(3.), 1e-5);
+
+  EXPECT_THROW(VisibilityModel::Parameters::parse(
+                   Options::parseFromString("visibility_mode=fast")),
+               Exception);
+  EXPECT_THROW(VisibilityModel::Parameters::parse(
+                   Options::parseFromString("visibility_k=0")),
+               Exception);
+  EXPECT_THROW(VisibilityModel::Parameters::parse(
+                   Options::parseFromString("visibility_threshold=2")),
+               Exception);
+  EXPECT_THROW(GroupDetectorFactory::getDefaultInstance().create(
+                   "grow@mdl=1@stride=1@visibility_mode=fast"),
+               Exception);
+}
+
+TEST(VisibilityModelTest, Person) {
+  // other is in front of person at an angle of ~60 degrees to the center
+  Person person(PersonId("a"), Pose2D(Position2D(2., 0.)));
+  Person other(PersonId("b"), Pose2D(Position2D(0.5, std::sqrt(0.75))));
+  Position2D center(0., 0.);
+  EXPECT_EQ(0., person.calculateVisibilityCost(center, person));
+  // cos(60deg) = 0.5 is below the default threshold of 0.75
+  double ratio = 2. / other.pose().position().norm();
+  double cost = person.calculateVisibilityCost(center, other);
+  EXPECT_NEAR(std::pow(100., 0.5 * ratio), cost, 1e-3);
+  VisibilityModel::Parameters parameters;
+  parameters.threshold = 0.4;
+  EXPECT_EQ(0., person.calculateVisibilityCost(center, other,
+                                               VisibilityModel(parameters)));
+  parameters.threshold = 0.75;
+  parameters.k = 10.;
+  EXPECT_NEAR(std::pow(10., 0.5 * ratio),
+              person.calculateVisibilityCost(center, other,
+                                             VisibilityModel(parameters)),
+              1e-3);
+}
+} // namespace
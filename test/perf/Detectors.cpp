@@ -0,0 +1,175 @@
+/********************************************************************
+**                                                                 **
+** File   : test/perf/Detectors.cpp                                **
+** Authors: Viktor Richter                                         **
+**                                                                 **
+**                                                                 **
+** GNU LESSER GENERAL PUBLIC LICENSE                               **
+** This file may be used under the terms of the GNU Lesser General **
+** Public License version 3.0 as published by the                  **
+**                                                                 **
+** Free Software Foundation and appearing in the file LICENSE.LGPL **
+** included in the packaging of this file.  Please review the      **
+** following information to ensure the license requirements will   **
+** be met: http://www.gnu.org/licenses/lgpl-3.0.txt                **
+**                                                                 **
+********************************************************************/
+
+#define FFORMATION_TRACK_ALLOCATIONS
+#include "AllocationTracker.h"
+#include "GroupDetectorFactory.h"
+#include "JsonReader.h"
+#include "SceneGenerator.h"
+#include "../gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+/*
+ * Compares the speed and the allocations of the detectors on generated
+ * scenes against test/perf/baseline.json.
+ *
+ * Times are divided by the time of a fixed calibration workload measured
+ * right before every case. The minimum of some repetitions is used, so the
+ * baseline can be shared between machines and build types to some extent.
+ * Set FFORMATION_PERF_TOLERANCE to override the allowed slowdown (0.5 = 50%)
+ * and FFORMATION_PERF_UPDATE=1 to rewrite the baseline with the measured
+ * values.
+ */
+
+using fformation::AllocationTracker;
+using fformation::GroupDetectorFactory;
+using fformation::Json;
+using fformation::JsonReader;
+using fformation::Observation;
+using fformation::Person;
+using fformation::SceneGenerator;
+
+typedef std::chrono::steady_clock Clock;
+
+static const size_t repetitions = 7;
+
+static double seconds(const Clock::time_point &start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * A fixed floating point workload shaped like the visibility cost (exp, sqrt
+ * and a division per pair of 64 positions). It does not call the library, so
+ * optimizations of the cost kernels show up in the relative times instead of
+ * moving the reference. The minimum of some repetitions is used to reduce
+ * noise.
+ */
+static double calibrate() {
+  std::vector<double> positions;
+  for (size_t i = 0; i < 64; ++i) {
+    positions.push_back(std::cos(double(i)) * double(i % 7 + 1));
+  }
+  double best = std::numeric_limits<double>::max();
+  volatile double sink = 0.;
+  for (size_t r = 0; r < repetitions; ++r) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < 20; ++i) {
+      double sum = sink;
+      for (auto center : positions) {
+        for (auto position : positions) {
+          double distance = std::sqrt(1. + (center - position) *
+                                               (center - position));
+          sum += std::exp(4.6 * std::cos(center * position)) / distance;
+        }
+      }
+      sink = sum;
+    }
+    best = std::min(best, seconds(start));
+  }
+  return best;
+}
+
+struct Measurement {
+  double relative_time;
+  double allocations;
+};
+
+static Measurement measure(const std::string &detector_name, size_t persons,
+                           double calibration) {
+  SceneGenerator::Parameters parameters;
+  parameters.persons = persons;
+  parameters.frames = 4;
+  parameters.missing_rotation = 0.2;
+  parameters.seed = 42;
+  SceneGenerator scene(parameters);
+  auto &observations = scene.features().observations();
+  auto detector = GroupDetectorFactory::getDefaultInstance().create(
+      detector_name + "@mdl=2@stride=0.7");
+  detector->detect(observations.front()); // warm up
+  double best = std::numeric_limits<double>::max();
+  size_t allocated = 0;
+  for (size_t r = 0; r < repetitions; ++r) {
+    auto start = Clock::now();
+    allocated = AllocationTracker::measure([&]() {
+                  for (auto &observation : observations) {
+                    detector->detect(observation);
+                  }
+                }).allocations;
+    best = std::min(best, seconds(start));
+  }
+  double frames = double(observations.size());
+  return {best / frames / calibration, double(allocated) / frames};
+}
+
+static std::string caseName(const std::string &detector, size_t persons) {
+  return detector + "/persons=" + std::to_string(persons);
+}
+
+TEST(Performance, Detectors) {
+  Json baseline = JsonReader::readFile(FFORMATION_PERF_BASELINE);
+  double tolerance = baseline.at("time_tolerance");
+  double allocation_tolerance = baseline.at("allocation_tolerance");
+  if (std::getenv("FFORMATION_PERF_TOLERANCE")) {
+    tolerance = std::atof(std::getenv("FFORMATION_PERF_TOLERANCE"));
+  }
+  bool update = std::getenv("FFORMATION_PERF_UPDATE") != nullptr;
+
+  Json measured = Json::object();
+  for (auto detector : {"grow", "shrink"}) {
+    for (size_t persons : {8, 16, 32}) {
+      auto name = caseName(detector, persons);
+      // calibrating next to every case makes load changes cancel out
+      auto result = measure(detector, persons, calibrate());
+      if (update) {
+        // the baseline is the median of some runs, not a lucky one
+        std::vector<double> times = {result.relative_time};
+        for (size_t run = 1; run < 5; ++run) {
+          times.push_back(measure(detector, persons, calibrate()).relative_time);
+        }
+        std::sort(times.begin(), times.end());
+        result.relative_time = times[times.size() / 2];
+      }
+      measured[name] = {{"relative_time", result.relative_time},
+                        {"allocations", result.allocations}};
+      std::cout << name << ": relative time " << result.relative_time
+                << ", allocations per frame " << result.allocations
+                << std::endl;
+      if (update) {
+        continue;
+      }
+      auto expected = baseline.at("cases").find(name);
+      ASSERT_NE(expected, baseline.at("cases").end())
+          << name << " is missing in the baseline";
+      double expected_time = expected.value().at("relative_time");
+      double expected_allocations = expected.value().at("allocations");
+      EXPECT_LE(result.relative_time, expected_time * (1. + tolerance))
+          << name << " is slower than the baseline";
+      EXPECT_LE(result.allocations,
+                expected_allocations * (1. + allocation_tolerance))
+          << name << " allocates more than the baseline";
+    }
+  }
+  if (update) {
+    baseline["cases"] = measured;
+    std::ofstream(FFORMATION_PERF_BASELINE) << baseline.dump(2) << "\n";
+  }
+}